@@ -1,7 +1,10 @@
 #include <OPPCH.h>
 
 #include "GUI.hpp"
+#include "ShaderWatcher.hpp"
 #include "Window.hpp"
+#include "resource/texture_cache.hpp"
+#include "resource/texture_streamer.hpp"
 #include "tests/TestCubeMap.hpp"
 #include "tests/TestCudaMatMul.hpp"
 #include "tests/TestGaussian.hpp"
@@ -43,6 +46,7 @@ int main(int argc, char *args[]) {
     std::cerr << "Error initializing GLEW! " << glewGetErrorString(glewError) << std::endl;
     exit(1);
   }
+  Shader::enableParallelCompile();
 
   // test::Test *currentTest = new test::Test;
   test::Test *currentTest = new test::TestPhysXPendulum(SCREEN_WIDTH, SCREEN_HEIGHT);
@@ -84,12 +88,20 @@ int main(int argc, char *args[]) {
       ImGui_ImplSDL2_ProcessEvent(&e);  // let imgui interact with SDL
     }
 
+    // 把背景解碼好的貼圖送上 GPU，並收掉已完成的上傳
+    gfx::resource::TextureStreamer::instance().update();
+    gfx::resource::TextureCache::instance().update();
+    // 存檔的 shader 在背景重新 compile，好了才換上
+    ShaderWatcher::instance().update();
+
     currentTest->OnRender();
     gui.draw(currentTest->camera);
 
     SDL_GL_SwapWindow(window);
   }
 
+  gfx::resource::TextureStreamer::instance().shutdown();
+  gfx::resource::TextureCache::instance().clear();
   gui.shutdown();
 
   close(window, context);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "geom/mesh.hpp"
+#include "geom/mesh_optimizer.hpp"
 #include "nlohmann/json.hpp"
 
 using json = nlohmann::json;
@@ -17,6 +18,9 @@ class Model {
 
   glm::mat4 modelMatrix;
   std::vector<gfx::geom::Mesh> meshes;  // one model can have multiple meshes
+  gfx::geom::Bounds bounds;             // 所有 mesh 的聯集（model local space）
+  // 與 meshes 一一對應，載入時 optimizeMesh 的結果（weld / ACMR / ATVR 前後）
+  std::vector<gfx::geom::MeshOptimizeStats> optimizeStats;
 
   // void draw(Shader *shader, const unsigned int instanceCount = 1);
   //
@@ -29,9 +33,6 @@ class Model {
   json JSON;
   std::vector<unsigned char> data;  // binary data
 
-  std::vector<std::string> loadedTexturesName;
-  std::vector<std::shared_ptr<gfx::resource::Texture>> loadedTextures;
-
   void loadMesh(unsigned int indMesh, glm::mat4 matrix);
 
   void traverseNode(unsigned int nodeIndex, glm::mat4 identity = glm::mat4(1.0f));
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ProgramCacheStats {
+  int hits = 0;
+  int misses = 0;
+  int rejected = 0;        // 檔案在但驗證失敗或 driver 不接受（通常是 driver 更新了）
+  double compileMs = 0.0;  // 沒命中時 compile + link 的累計時間
+  double loadMs = 0.0;     // 命中時 glProgramBinary 的累計時間
+};
+
+// glGetProgramBinary / glProgramBinary 的磁碟快取，省掉啟動與切換 Test 時的 GLSL compile
+// key 為所有 stage 展開 #include 後的原始碼 + driver vendor / renderer / version 的 hash，
+// 改 shader 或換 driver 都會得到新的 key；讀檔時再驗證 header 與 checksum，driver 不接受就回到正常 compile
+// 只能在 GL thread 使用
+class ProgramBinaryCache {
+ public:
+  using Sources = std::vector<std::pair<GLenum, std::string>>;  // stage, 原始碼
+
+  static ProgramBinaryCache &instance();
+
+  // driver 支援（GL 4.1 或 ARB_get_program_binary，且至少一種 binary format）且沒被關掉
+  bool enabled();
+  void setEnabled(bool enabled) { enabled_ = enabled; }
+  void setDirectory(const std::string &dir) { directory_ = dir; }
+
+  uint64_t key(const Sources &sources);
+  // 命中時回傳已 link 好的 program，否則 0
+  GLuint load(uint64_t key);
+  // program 要在 link 前設 GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+  void store(uint64_t key, GLuint program);
+  void recordCompile(double ms);
+  // 刪掉快取目錄下所有 binary
+  void clear();
+
+  ProgramCacheStats stats() const { return stats_; }
+
+ private:
+  void detect();
+  std::string pathFor(uint64_t key) const;
+
+  std::string directory_ = ".cache/shaders";
+  std::string driver_;  // 第一次用到時才向 GL 查
+  int supported_ = -1;  // -1 尚未檢查
+  bool enabled_ = true;
+  ProgramCacheStats stats_;
+};
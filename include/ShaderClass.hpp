@@ -1,11 +1,31 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "ShaderPreprocessor.hpp"
 
 class Shader {
  public:
-  Shader(const char *vertShaderPath, const char *fragShaderPath);
-  Shader(const char *vertShaderPath, const char *geomShaderPath, const char *fragShaderPath);
+  struct AsyncTag {};
+  static constexpr AsyncTag async{};
+
+  // defines 插在每個 stage 的 #version 之後（見 ShaderPreprocessor）
+  Shader(const char *vertShaderPath, const char *fragShaderPath, const ShaderDefines &defines = {});
+  Shader(const char *vertShaderPath, const char *geomShaderPath, const char *fragShaderPath,
+         const ShaderDefines &defines = {});
+  // 非同步版本：compile / link 送出後立刻返回，PROGRAM_ID 在 isReady() 回傳 true 前都是 0
+  // 有 KHR/ARB_parallel_shader_compile 時 driver 在背景 thread compile，
+  // scene 把所有 shader 一次建好後每幀檢查，沒好之前畫 loading frame
+  Shader(AsyncTag, const char *vertShaderPath, const char *fragShaderPath, const ShaderDefines &defines = {});
+  Shader(AsyncTag, const char *vertShaderPath, const char *geomShaderPath, const char *fragShaderPath,
+         const ShaderDefines &defines = {});
+  // compute shader program（需要 GL 4.3）
+  explicit Shader(const char *compShaderPath, const ShaderDefines &defines = {});
   ~Shader();
 
   Shader(const Shader &) = delete;
@@ -18,20 +38,64 @@ class Shader {
   bool reload();
   void use() const;
 
- protected:
-  static std::string readFile(const char *filePath);
+  // 換一組 define 並同步重建，失敗時保留原本的 program
+  bool setDefines(const ShaderDefines &defines);
+  const ShaderDefines &defines() const { return defines_; }
+  // 所有 stage 用到的檔案（含 include），給 hot reload 監看
+  const std::vector<std::string> &dependencies() const { return dependencies_; }
+
+  // hot reload：重新展開並在背景 compile（有 parallel compile 時不會卡住這一幀），之後每幀 pollReload()
+  // link 成功才換掉 PROGRAM_ID（舊 program 的 uniform 值與 block binding 會複製過去），失敗時保留舊的 program
+  enum class ReloadStatus { Idle, Pending, Swapped, Failed };
+  void beginReload();
+  ReloadStatus pollReload();
+  bool reloadPending() const { return reloading_ != nullptr; }
 
+  // 非同步 compile 完成時收尾（檢查錯誤、寫入 program binary cache）並回傳 true；同步建立的一律為 true
+  bool isReady();
+  static bool allReady(std::initializer_list<Shader *> shaders);
+
+  // 讓 driver 用所有可用的 thread compile（glMaxShaderCompilerThreadsKHR），glewInit 之後呼叫一次
+  static bool parallelCompileSupported();
+  static void enableParallelCompile();
+
+ protected:
   static GLuint compileShader(const char *shaderSource, GLenum shaderType);
 
-  static void checkCompileErrors(GLuint shader, const char *shaderPath);
+  // files 為該 stage 展開時用到的檔案，error log 中的 source string number 對應到這裡的 index
+  static void checkCompileErrors(GLuint shader, const std::vector<std::string> &files);
 
   static void checkLinkErrors(GLuint program, const char *tag);
 
  private:
-  static GLuint buildProgram(const char *vert, const char *geom, const char *frag);
+  // 送出 compile / link 但還不查詢結果（查 status 會讓 driver 等 compile 完成）
+  struct PendingBuild {
+    GLuint program = 0;
+    std::vector<GLuint> shaders;  // program binary cache 命中時為空
+    std::vector<std::vector<std::string>> stageFiles;
+    uint64_t cacheKey = 0;
+    bool useCache = false;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  // 依目前的 path / defines 展開所有 stage 並送出，同時更新 dependencies_
+  PendingBuild beginBuild();
+  static bool buildFinished(const PendingBuild &build);
+  // 檢查 compile / link 結果，失敗時刪掉 program 並回傳 0
+  static GLuint finishBuild(PendingBuild &build);
+  static void discardBuild(PendingBuild &build);
+  void build(bool async);
+  // 換上新的 program 並刪掉舊的；scene 設過的 uniform 不用重設
+  void swapProgram(GLuint program);
+  static void copyProgramState(GLuint from, GLuint to);
   void reset();
 
   std::string vertPath_;
   std::string geomPath_;
   std::string fragPath_;
+  std::string compPath_;
+  ShaderDefines defines_;
+  std::vector<std::string> dependencies_;
+  std::unique_ptr<PendingBuild> pending_;
+  std::unique_ptr<PendingBuild> reloading_;
 };
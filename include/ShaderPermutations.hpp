@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ShaderClass.hpp"
+#include "ShaderPreprocessor.hpp"
+
+// uber-shader 的特化版本管理
+// 同一組 shader 檔案依 feature bitmask 編出不同版本：bit i 打開時加上 #define features[i]，
+// 另外可帶數值 define（例如迴圈次數），bitmask + 數值一起當作 cache key
+// shader 端用 #ifdef 取代 bool uniform，內層迴圈不再有執行期分支
+//   - 第一個版本同步 compile；之後新的組合走非同步 compile，好之前 select() 繼續回傳上一個可用的版本
+//   - 每個版本第一次可用時呼叫 setup（設定 uniform block binding 等只需要做一次的狀態）
+//   - 超過 maxVariants 時丟掉最久沒用到的版本
+// 只能在 GL thread 使用
+class ShaderPermutations {
+ public:
+  using Setup = std::function<void(Shader &)>;
+
+  // features 最多 32 個
+  ShaderPermutations(std::string vertPath, std::string fragPath, std::vector<std::string> features,
+                     ShaderDefines baseDefines = {}, Setup setup = {});
+
+  // 要求某個組合並回傳目前可以拿來畫的版本，呼叫端接著 use() / 設 uniform
+  Shader &select(uint32_t mask, const ShaderDefines &values = {});
+
+  uint32_t activeMask() const { return activeMask_; }
+  size_t size() const { return variants_.size(); }
+  int compiling();  // 還在背景 compile 的版本數（會順便收尾已完成的）
+  void setMaxVariants(size_t maxVariants) { maxVariants_ = maxVariants; }
+  void clear();
+
+ private:
+  struct Variant {
+    std::unique_ptr<Shader> shader;
+    uint32_t mask = 0;
+    uint64_t lastUsed = 0;
+    bool configured = false;  // 已呼叫過 setup
+  };
+
+  std::string keyFor(uint32_t mask, const ShaderDefines &values) const;
+  ShaderDefines definesFor(uint32_t mask, const ShaderDefines &values) const;
+  void evict();
+
+  std::string vertPath_;
+  std::string fragPath_;
+  std::vector<std::string> features_;
+  ShaderDefines baseDefines_;
+  Setup setup_;
+
+  std::unordered_map<std::string, Variant> variants_;
+  std::string activeKey_;
+  Shader *active_ = nullptr;
+  uint32_t activeMask_ = 0;
+  uint64_t tick_ = 0;
+  size_t maxVariants_ = 32;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// 編譯期常數，依序插在 #version 之後，例如 {"MAX_SPHERES", "50"}、{"USE_BUMP", ""}
+// shader 端用 #ifndef 給預設值，GLSL compiler 可以展開迴圈、刪掉用不到的分支
+using ShaderDefines = std::vector<std::pair<std::string, std::string>>;
+
+struct PreprocessedShader {
+  std::string source;
+  // 根檔案與所有 include 到的檔案（第一個是根檔案），#line 的 source string number 就是這裡的 index
+  std::vector<std::string> files;
+  bool ok = true;  // 有檔案讀不到或 include 形成迴圈時為 false
+};
+
+// GLSL #include 展開
+//   - 每個檔案解析一次後依 path 快取，mtime 或大小改變才重新讀
+//   - 支援 #pragma once；include 迴圈會報錯並略過
+//   - 路徑先找相對於目前檔案的目錄，找不到再相對於工作目錄（現有 shader 都寫 "shaders/xxx.glsl"）
+//   - 每一段展開的內容前面補 #line，compile error 的行號對得回原檔
+// 只能在 GL thread 使用
+class ShaderPreprocessor {
+ public:
+  static ShaderPreprocessor &instance();
+
+  PreprocessedShader process(const std::string &path, const ShaderDefines &defines = {});
+
+  // 丟掉某個檔案的快取（hot reload 收到檔案變更時），下次 process 一定重讀
+  void invalidate(const std::string &path);
+  void clear() { files_.clear(); }
+
+ private:
+  struct Chunk {
+    std::string text;     // include 為空時是一段原始碼
+    int firstLine = 1;    // text 第一行在原檔的行號
+    std::string include;  // #include 的目標（已解析成實際路徑）
+  };
+
+  struct ParsedFile {
+    std::filesystem::file_time_type mtime;
+    uintmax_t size = 0;  // mtime 解析度粗的檔案系統上，同一個 tick 內的修改靠大小判斷
+    std::string version;  // #version 那一行，只有根檔案會用到
+    bool pragmaOnce = false;
+    std::vector<Chunk> chunks;
+  };
+
+  std::shared_ptr<const ParsedFile> parse(const std::string &path);
+  void expand(const std::string &path, PreprocessedShader &out, std::vector<std::string> &stack,
+              std::unordered_set<std::string> &included);
+
+  std::unordered_map<std::string, std::shared_ptr<const ParsedFile>> files_;
+};
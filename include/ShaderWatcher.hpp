@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Shader;
+
+struct ShaderWatcherStats {
+  int reloads = 0;       // 換上新 program 的次數
+  int failures = 0;      // compile / link 失敗、保留舊 program 的次數
+  int pending = 0;       // 目前還在背景 compile 的 shader 數
+  std::string lastFile;  // 最後一個觸發 reload 的檔案
+};
+
+// shader 檔案的 hot reload
+//   - Linux 用 inotify 監看所有 shader（含 #include 進來的檔案）所在的目錄，其他平台定期比對 mtime
+//   - 檔案變更時依各 Shader 的 dependencies() 找出受影響的 shader，只重建這些
+//   - 重建走 Shader::beginReload()，在背景 compile，完成且 link 成功才換掉 PROGRAM_ID
+// Shader 建立 / 移動 / 刪除時會自動 add / remove；只能在 GL thread 使用
+class ShaderWatcher {
+ public:
+  static ShaderWatcher &instance();
+  ~ShaderWatcher();
+
+  ShaderWatcher(const ShaderWatcher &) = delete;
+  ShaderWatcher &operator=(const ShaderWatcher &) = delete;
+
+  void add(Shader *shader);
+  void remove(Shader *shader);
+
+  // 每幀呼叫：收集檔案變更、對受影響的 shader 送出 reload，並收掉已經 compile 完的
+  void update();
+
+  bool enabled() const { return enabled_; }
+  void setEnabled(bool enabled) { enabled_ = enabled; }
+  ShaderWatcherStats stats() const;
+
+ private:
+  ShaderWatcher();
+
+  // 依目前所有 shader 的 dependencies 補上還沒監看的目錄 / 檔案
+  void refreshWatches();
+  std::vector<std::string> pollChanges();
+
+  std::unordered_set<Shader *> shaders_;
+  std::unordered_set<Shader *> reloading_;
+  bool dirty_ = true;  // shader 集合或 dependencies 變了，需要 refreshWatches
+  bool enabled_ = true;
+  ShaderWatcherStats stats_;
+
+  int inotifyFd_ = -1;                            // -1 表示沒有 inotify，改用 mtime polling
+  std::unordered_map<int, std::string> watches_;  // inotify watch descriptor → 目錄
+  std::unordered_set<std::string> watchedDirs_;
+
+  std::unordered_map<std::string, std::filesystem::file_time_type> mtimes_;
+  std::chrono::steady_clock::time_point lastScan_;
+};
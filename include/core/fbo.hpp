@@ -1,12 +1,36 @@
 #pragma once
 
 #include <GL/glew.h>
+
+#include <cstddef>
+#include <vector>
 namespace gfx::core {
+// FBO 的 attachment 設定；相同的 spec 可以在 RenderTargetPool 裡共用
+struct FBOSpec {
+  int width = 0;
+  int height = 0;
+  // 每個元素一個 color attachment（GL_COLOR_ATTACHMENT0 + i）的 internal format，
+  // 例如 GL_RGBA8、GL_RGBA16F、GL_RGBA32F、GL_R11F_G11F_B10F；可以是空的（只畫 depth）
+  std::vector<GLenum> colorFormats = {GL_RGBA8};
+  // GL_NONE、GL_DEPTH_COMPONENT24 / 32F，或帶 stencil 的 GL_DEPTH24_STENCIL8 / GL_DEPTH32F_STENCIL8
+  GLenum depthFormat = GL_NONE;
+  int samples = 1;  // > 1 為 MSAA，畫完呼叫 resolve() 才能取樣
+
+  bool operator==(const FBOSpec &o) const {
+    return width == o.width && height == o.height && colorFormats == o.colorFormats && depthFormat == o.depthFormat &&
+           samples == o.samples;
+  }
+  bool operator!=(const FBOSpec &o) const { return !(*this == o); }
+};
+
+// 可以 render 也可以取樣的 render target：任意數量 / 格式的 color attachment（MRT）、depth / stencil、MSAA
+// MSAA 時 ID 的 attachment 是 multisample renderbuffer，取樣的 texture 在另一個 FBO，由 resolve() blit 過去
 class FBO {
  public:
-  GLuint ID;
-  GLuint textureID;
-  FBO(float width, float height);
+  GLuint ID = 0;
+  GLuint textureID = 0;       // color attachment 0（單一 color 的舊用法）
+  GLuint depthTextureID = 0;  // spec 有 depthFormat 才有，可取樣（例如給 Hi-Z pyramid 用）
+  explicit FBO(const FBOSpec &spec);
   ~FBO() { reset(); }
   FBO(const FBO &) = delete;
   FBO &operator=(const FBO &) = delete;
@@ -14,12 +38,27 @@ class FBO {
   FBO &operator=(FBO &&o) noexcept;
   void bind() const;
   void unbind() const;
-  void setupTexture();
-  void bindTexture(GLenum textureUnit);
+  void bindTexture(GLenum textureUnit) const;  // color attachment 0
+  GLuint colorTexture(size_t index) const { return colorTextures_[index]; }
+  size_t colorCount() const { return colorTextures_.size(); }
+  // 尺寸不同時重新配置所有 attachment，內容不保留
+  void resize(int width, int height);
+  // MSAA：把每個 color attachment 與 depth 解析到可取樣的 texture；samples == 1 時什麼都不做
+  void resolve() const;
+  // GL_FRAMEBUFFER_COMPLETE 以外都印出來
+  bool checkStatus() const;
+  const FBOSpec &spec() const { return spec_; }
+  size_t memoryBytes() const;  // 估計值，給 UI / pool 統計用
   float width;
   float height;
 
  private:
+  void allocate();
   void reset();
+
+  FBOSpec spec_;
+  std::vector<GLuint> colorTextures_;
+  std::vector<GLuint> renderbuffers_;  // MSAA 的 color（依序）與 depth（最後一個）
+  GLuint resolveID_ = 0;               // MSAA 時可取樣 texture 所在的 FBO
 };
 }  // namespace gfx::core
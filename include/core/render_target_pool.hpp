@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/fbo.hpp"
+namespace gfx::core {
+// 暫存 render target 的 pool：pass 用完就 release，之後 spec 相同的 pass 直接拿同一個 FBO，
+// 不用各自擁有一份（例如 denoiser 的 ping-pong、post-processing 的中間結果）
+// 拿到的 FBO 內容不保證，需要自己 clear；太久沒用到的在 endFrame() 釋放（例如視窗縮放後舊尺寸的）
+class RenderTargetPool {
+ public:
+  RenderTargetPool() = default;
+  RenderTargetPool(const RenderTargetPool &) = delete;
+  RenderTargetPool &operator=(const RenderTargetPool &) = delete;
+
+  // spec 相同且閒置的 target，沒有就建立新的；在 release 之前都不會再借給別人
+  FBO &acquire(const FBOSpec &spec);
+  void release(const FBO &target);
+  // 每幀呼叫一次；閒置超過 maxIdleFrames 幀的 target 刪掉
+  void endFrame(uint32_t maxIdleFrames = 4);
+
+  size_t size() const { return entries_.size(); }
+  size_t inUse() const;
+  size_t memoryBytes() const;
+
+ private:
+  struct Entry {
+    std::unique_ptr<FBO> target;
+    bool inUse = false;
+    uint32_t lastUsedFrame = 0;
+  };
+  std::vector<Entry> entries_;
+  uint32_t frame_ = 0;
+};
+}  // namespace gfx::core
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <GL/glew.h>
+namespace gfx::core {
+// Shader storage buffer（GL 4.3）；同一個 buffer 也可以綁到其他 target（例如 GL_DRAW_INDIRECT_BUFFER）
+class SSBO {
+ public:
+  GLuint ID;
+  SSBO();
+  ~SSBO() { reset(); }
+  SSBO(const SSBO &) = delete;
+  SSBO &operator=(const SSBO &) = delete;
+  SSBO(SSBO &&o) noexcept;
+  SSBO &operator=(SSBO &&o) noexcept;
+
+  void bind() const;
+  void unbind() const;
+  void bindBase(GLuint index) const;
+  template <typename T>
+  void bufferData(const T *data, size_t count, GLenum usage) {
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(T) * count, data, usage);
+  }
+  template <typename T>
+  void bufferSubData(const T *data, size_t count, size_t offset = 0) {
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(T) * offset, sizeof(T) * count, data);
+  }
+
+ private:
+  void reset();
+};
+}  // namespace gfx::core
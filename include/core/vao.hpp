@@ -3,6 +3,7 @@
 #include <GL/glew.h>
 namespace gfx::core {
 class VBO;
+class VertexLayout;
 
 class VAO {
  public:
@@ -15,7 +16,9 @@ class VAO {
   VAO(VAO &&other) noexcept;
   VAO &operator=(VAO &&other) noexcept;
 
-  void linkAttr(VBO &vbo, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, const void *offset);
+  void linkAttr(VBO &vbo, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, const void *offset,
+                GLboolean normalized = GL_FALSE);
+  void linkLayout(VBO &vbo, const VertexLayout &vertexLayout);
   void linkAttrDiv(VBO &vbo, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, const void *offset);
   void linkMat4(VBO &vbo, GLuint layout);
   void bind() const;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <vector>
+
+namespace gfx::core {
+
+// 單一頂點屬性的描述：對應一次 glVertexAttribPointer
+struct VertexAttrib {
+  GLuint location;
+  GLint numComponents;
+  GLenum type;
+  GLboolean normalized;
+  GLsizei offset;
+};
+
+// 描述一個 interleaved VBO 的格式，交給 VAO::linkLayout 使用
+class VertexLayout {
+ public:
+  VertexLayout &add(GLuint location, GLint numComponents, GLenum type, GLboolean normalized = GL_FALSE);
+  bool has(GLuint location) const;
+
+  std::vector<VertexAttrib> attribs;
+  GLsizei stride = 0;
+
+  static GLsizei attribSize(GLint numComponents, GLenum type);
+};
+
+}  // namespace gfx::core
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "geom/vertex.hpp"
+
+namespace gfx::geom {
+
+// mesh local space 的包圍體：AABB 加上以 AABB 中心為球心的 bounding sphere
+struct Bounds {
+  glm::vec3 min{0.0f};
+  glm::vec3 max{0.0f};
+  glm::vec3 center{0.0f};
+  float radius{0.0f};
+
+  static Bounds fromVertices(const std::vector<Vertex> &vertices);
+  // 兩個包圍體的聯集（sphere 以合併後 AABB 中心為球心，偏保守）
+  static Bounds merge(const Bounds &a, const Bounds &b);
+
+  // 經過 affine 轉換後的包圍體（AABB 取轉換後的外接盒）
+  Bounds transformed(const glm::mat4 &m) const;
+};
+
+}  // namespace gfx::geom
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace gfx::geom {
+
+// traversal stack 的上限，shader 端的 stack 大小要一致（shaders/rt_scene_bvh.glsl）
+constexpr int BVH_MAX_DEPTH = 64;
+
+// flatten 後給 GPU 的節點，std430 下剛好 32 bytes
+struct BVHNode {
+  glm::vec3 boundsMin;
+  int32_t leftOrFirst;  // 內部節點：左子節點（右子節點 = left + 1）；leaf：在 indices 中的起點
+  glm::vec3 boundsMax;
+  int32_t count;  // > 0 為 leaf，值為 primitive 數
+};
+static_assert(sizeof(BVHNode) == 32, "BVHNode must match the std430 layout");
+
+// primitive（三角形、球…）的 AABB
+struct BVHPrimitive {
+  glm::vec3 min;
+  glm::vec3 max;
+};
+
+struct BVHData {
+  std::vector<BVHNode> nodes;     // nodes[0] 為 root；沒有 primitive 時為空
+  std::vector<uint32_t> indices;  // leaf 依序引用的 primitive index
+  int depth = 0;
+};
+
+// binned SAH，每個節點在三個軸上各分 numBins 格找最便宜的切法
+// 切了不划算（且 primitive 數不多）或 centroid 全部重疊時停在 leaf；深度不超過 BVH_MAX_DEPTH
+BVHData buildBVH(const std::vector<BVHPrimitive> &primitives, size_t maxLeafSize = 4, int numBins = 12);
+
+// 把 bvh 接在另一棵後面時用（共用同一個 node / index buffer）：
+// 子節點 index 加上 nodeOffset，leaf 起點加上 indexOffset，indices 的值加上 primitiveOffset
+void offsetBVH(BVHData &bvh, int32_t nodeOffset, int32_t indexOffset, uint32_t primitiveOffset = 0);
+
+}  // namespace gfx::geom
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace gfx::geom {
+
+// 由 projection * view(* model) 矩陣抽出的六個平面（Gribb/Hartmann），法向朝內
+class Frustum {
+ public:
+  enum Plane { PLANE_LEFT = 0, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, PLANE_COUNT };
+
+  Frustum() = default;
+  explicit Frustum(const glm::mat4 &viewProj);
+
+  bool sphereVisible(const glm::vec3 &center, float radius) const;
+  bool aabbVisible(const glm::vec3 &min, const glm::vec3 &max) const;
+
+  glm::vec4 planes[PLANE_COUNT];
+};
+
+}  // namespace gfx::geom
@@ -7,22 +7,22 @@
 #include "core/ubo.hpp"
 #include "core/vao.hpp"
 #include "core/vbo.hpp"
+#include "geom/bounds.hpp"
+#include "geom/simplify.hpp"
+#include "geom/vertex.hpp"
 #include "resource/texture.hpp"
+#include "resource/texture_streamer.hpp"
 
 namespace gfx::geom {
 
-struct Vertex {
-  glm::vec3 position;
-  glm::vec3 normal;
-  glm::vec3 color;
-  glm::vec2 texCoords;
-  glm::mat4 modelMatrix;
-};
 class Mesh {
  public:
   std::vector<Vertex> vertices;
   std::vector<GLuint> indices;
   std::vector<std::shared_ptr<resource::Texture>> textures;
+  Bounds bounds;
+  // 空的代表沒有 LOD；否則 lods[0] 就是 indices，EBO 裡依序放著每一層
+  std::vector<MeshLod> lods;
 
   core::VAO vao;
   core::VBO vbo;
@@ -33,7 +33,7 @@ class Mesh {
   Mesh(const std::vector<Vertex> &vertices);
   Mesh(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices);
   Mesh(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices,
-       std::vector<std::shared_ptr<resource::Texture>> textures);
+       std::vector<std::shared_ptr<resource::Texture>> textures, VertexFormat format = VertexFormat::Float32);
 
   ~Mesh() = default;
   Mesh(const Mesh &) = delete;
@@ -60,18 +60,33 @@ class Mesh {
     ubo[index].unbind();
   }
   void setTexture(std::vector<std::shared_ptr<resource::Texture>> textures);
+  // 替換 index buffer（例如 meshlet 重排後），頂點不變
+  void setIndices(const std::vector<GLuint> &indices);
+  // 上傳整條 LOD chain 到 EBO，indices 保持為 LOD 0（一般的 draw 不受影響）
+  void setLods(const LodChain &chain);
   bool hasTexture() const;
   void setupInstanceMatrices(std::vector<glm::mat4> &instanceMatrices);
   void updateInstanceMatrices(std::vector<glm::mat4> &instanceMatrices);
   void rotate(float angle, glm::vec3 axis);
 
+  // 重新打包並上傳 vertices（VBO 大小與 attribute 格式會跟著改）
+  void setVertexFormat(VertexFormat format);
+  VertexFormat vertexFormat() const { return format_; }
+  bool hasVertexColor() const;
+
  private:
+  VertexFormat format_ = VertexFormat::Float32;
+
+  void uploadVertices();
   void setupMeshAttributes();
 };
 
 class CubeMap {
  public:
+  // faces 只有一個 .ktx2 / .dds 時直接載入壓縮過的 cube map（face 順序與翻轉由離線工具處理，flip 會被忽略）
   CubeMap(std::vector<std::string> &faces, bool flip = true);
+  // 交給 TextureStreamer 在背景解碼與翻轉，載入完成前是灰色的 placeholder
+  CubeMap(std::vector<std::string> &faces, resource::TextureStreamer &streamer, bool flip = true);
   ~CubeMap();
 
   CubeMap(const CubeMap &) = delete;
@@ -80,12 +95,13 @@ class CubeMap {
   CubeMap &operator=(CubeMap &&other) noexcept;
 
   GLuint textureID = 0;
+  std::shared_ptr<resource::Texture> texture;  // 只有串流載入時才有，此時 textureID 為 0
   std::unique_ptr<Mesh> cubeMesh;
 
  private:
   void reset();
+  void loadCompressed(const std::string &path);
 
-  static void flipHorizontally(unsigned char *data, int width, int height, int channels);
-  static void flipVertically(unsigned char *data, int width, int height, int channels);
+  static void flipFace(unsigned char *data, int width, int height, int channels, int face);
 };
 }  // namespace gfx::geom
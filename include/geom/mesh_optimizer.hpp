@@ -0,0 +1,49 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "geom/vertex.hpp"
+
+namespace gfx::geom {
+
+// post-transform cache 的模擬結果
+// ACMR: average cache miss ratio = 轉換頂點數 / 三角形數（理想值 ~0.5，最差 3.0）
+// ATVR: average transformed vertex ratio = 轉換頂點數 / 頂點數（理想值 1.0）
+struct VertexCacheStats {
+  size_t verticesTransformed = 0;
+  float acmr = 0.0f;
+  float atvr = 0.0f;
+};
+
+struct MeshOptimizeStats {
+  size_t verticesBefore = 0;
+  size_t verticesAfter = 0;
+  VertexCacheStats before;
+  VertexCacheStats after;
+};
+
+// 以 FIFO cache 模擬 GPU 的 post-transform cache（預設 16 entries，接近一般桌面 GPU）
+VertexCacheStats analyzeVertexCache(const std::vector<GLuint> &indices, size_t vertexCount, unsigned cacheSize = 16);
+
+// 合併完全相同的頂點，回傳新的頂點數
+size_t weldVertices(std::vector<Vertex> &vertices, std::vector<GLuint> &indices);
+
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"：重排三角形順序
+void optimizeVertexCache(std::vector<GLuint> &indices, size_t vertexCount);
+
+// 在不讓 ACMR 超過 threshold 倍的前提下，把面向外側的 cluster 排前面，減少 overdraw
+// （Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"）
+// 需要在 optimizeVertexCache 之後呼叫
+void optimizeOverdraw(std::vector<GLuint> &indices, const std::vector<Vertex> &vertices, float threshold = 1.05f);
+
+// 依 index buffer 第一次使用的順序重排頂點，沒被引用的頂點會被移除
+size_t optimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<GLuint> &indices);
+
+// 依序執行 weld -> vertex cache -> overdraw -> vertex fetch
+MeshOptimizeStats optimizeMesh(std::vector<Vertex> &vertices, std::vector<GLuint> &indices,
+                               float overdrawThreshold = 1.05f);
+
+}  // namespace gfx::geom
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "geom/vertex.hpp"
+
+namespace gfx::geom {
+
+struct Meshlet {
+  uint32_t indexOffset;  // 在 MeshletData::indices 中的起點
+  uint32_t triangleCount;
+  uint32_t vertexCount;
+
+  // bounding sphere（mesh local space）
+  glm::vec3 center;
+  float radius;
+
+  // normal cone：從 apex 看過去 dot(normalize(apex - eye), axis) >= cutoff 時整個 cluster 都是背面
+  // cutoff = 1 代表法向太分散，不做 backface 測試
+  glm::vec3 coneApex;
+  glm::vec3 coneAxis;
+  float coneCutoff;
+};
+
+struct MeshletData {
+  std::vector<Meshlet> meshlets;
+  std::vector<GLuint> indices;  // 依 meshlet 順序排列的 index buffer，三角形集合與原本相同
+};
+
+// 依 index 順序貪婪切分（建議先跑 optimizeVertexCache，相鄰三角形共用頂點較多）
+MeshletData buildMeshlets(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices,
+                          size_t maxVertices = 64, size_t maxTriangles = 124);
+
+}  // namespace gfx::geom
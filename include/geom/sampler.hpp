@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace gfx::geom {
+
+// 與 shaders/rt_sampler.glsl 的 SAMPLER_* 一致
+enum class SamplerType : int { Random = 0, Sobol = 1, BlueNoise = 2 };
+
+// path tracer 的 sample 來源，介面與 shaders/rt_sampler.glsl 相同（begin / setDimension / next1D / next2D），
+// Sobol 與 BlueNoise 全部是整數運算，CPU 端（離線工具、除錯比對）拿到的 sample 與 shader 逐 bit 相同
+// - Random：hash 出來的白噪，只有這個與 shader 的 rand() 不是同一串
+// - Sobol：Sobol 前兩維（(0,2)-sequence）+ Owen scramble（Burley 2020），每個 dimension 換一個 seed 重新 scramble
+//   （padding），pixel 之間互不相關，任何 2 的冪次個 sample 都是分層的
+// - BlueNoise：tile 的 blue noise（generateBlueNoise），每個 dimension 平移 tile，
+//   sample index 以 R2 / 黃金比例序列做 Cranley-Patterson rotation
+class Sampler {
+ public:
+  explicit Sampler(SamplerType type = SamplerType::Sobol) : type_(type) {}
+
+  // RGBA8、size x size，BlueNoise 才需要；資料由呼叫端持有
+  void setBlueNoise(const uint8_t *rgba, int size);
+
+  // 每條 path 開始時呼叫；sampleIndex 在同一個 pixel 的所有 sample（跨幀）之間遞增
+  void begin(glm::uvec2 pixel, uint32_t sampleIndex);
+  // 固定每個 bounce 的起始 dimension，分支走法不同時後面的 bounce 仍然對齊
+  void setDimension(uint32_t dim) { dim_ = dim; }
+  float next1D();
+  glm::vec2 next2D();
+
+  SamplerType type() const { return type_; }
+
+ private:
+  uint32_t seed() const;
+  glm::uvec4 blueNoiseTexel() const;
+
+  SamplerType type_;
+  const uint8_t *blueNoise_ = nullptr;
+  int blueNoiseSize_ = 0;
+  glm::uvec2 pixel_{0};
+  uint32_t index_ = 0;
+  uint32_t dim_ = 0;
+  uint32_t rng_ = 0;
+};
+
+// 以下與 shader 端同名函式的結果相同
+uint32_t hashU32(uint32_t x);
+uint32_t reverseBits32(uint32_t x);
+uint32_t sobol2(uint32_t index);  // Sobol 第二維
+uint32_t nestedUniformScramble(uint32_t x, uint32_t seed);
+glm::vec2 sobolOwen2D(uint32_t index, uint32_t seed);
+float toUnitFloat(uint32_t x);  // 取高 24 bits，結果在 [0, 1)
+
+// void-and-cluster（Ulichney 1993）：size x size、左右上下可無縫平鋪的 blue noise，
+// 回傳每個 pixel 的 rank（0 .. size * size - 1），依 rank 均勻量化即為 dither mask
+std::vector<uint32_t> generateBlueNoise(int size, uint32_t seed, float sigma = 1.9f);
+
+}  // namespace gfx::geom
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "geom/vertex.hpp"
+
+namespace gfx::geom {
+
+// Garland & Heckbert quadric error metric 的 edge collapse 簡化
+// 頂點只會被合併到既有頂點上，所以回傳的 index buffer 可以直接共用原本的 VBO
+// 邊界與 UV/normal seam 上的頂點會被鎖住，避免破洞與貼圖錯位
+//
+// targetError 與 resultError 都是相對於 mesh bounding sphere 半徑的比例
+std::vector<GLuint> simplifyMesh(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices,
+                                 size_t targetIndexCount, float targetError = 1.0f, float *resultError = nullptr);
+
+struct MeshLod {
+  uint32_t indexOffset;  // 在 LodChain::indices 中的起點
+  uint32_t indexCount;
+  float error;  // 相對於 bounding sphere 半徑
+};
+
+// LOD 0 是原始 indices，之後每一層目標為前一層的 reduction 倍
+struct LodChain {
+  std::vector<GLuint> indices;
+  std::vector<MeshLod> levels;
+};
+
+LodChain buildLodChain(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices, size_t maxLevels = 5,
+                       float reduction = 0.5f);
+
+// radiusPx：bounding sphere 投影到螢幕上的半徑（pixel）
+// 回傳誤差投影後不超過 maxErrorPx 的最粗 LOD
+uint32_t selectLod(const std::vector<MeshLod> &levels, float radiusPx, float maxErrorPx = 1.0f);
+
+}  // namespace gfx::geom
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "core/vertex_layout.hpp"
+
+namespace gfx::geom {
+
+// CPU 端的頂點（44 bytes）。上傳 GPU 時依 VertexFormat 重新打包
+struct Vertex {
+  glm::vec3 position;
+  glm::vec3 normal;
+  glm::vec3 color;
+  glm::vec2 texCoords;
+};
+
+// shader 端固定使用的 attribute location
+enum VertexAttribLocation : GLuint {
+  ATTRIB_POSITION = 0,
+  ATTRIB_NORMAL = 1,
+  ATTRIB_COLOR = 2,
+  ATTRIB_TEXCOORD = 3,
+  ATTRIB_INSTANCE_MATRIX = 4,  // mat4 佔 4~7
+};
+
+enum class VertexFormat {
+  Float32,         // pos/normal/color f32x3 + uv f32x2            44 bytes
+  Compact,         // pos f32x3 + normal 10:10:10:2 + color unorm8x4 + uv f16x2  24 bytes
+  CompactNoColor,  // 同 Compact 但不含 color（shader 讀到的 color 固定為白色）  20 bytes
+};
+
+const core::VertexLayout &vertexLayout(VertexFormat format);
+
+// 依 format 把 vertices 打包成 interleaved bytes，長度 = vertices.size() * stride
+std::vector<uint8_t> packVertices(const std::vector<Vertex> &vertices, VertexFormat format);
+
+}  // namespace gfx::geom
@@ -0,0 +1,37 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "geom/meshlet.hpp"
+
+namespace gfx::render {
+
+// glMultiDrawElements 的參數；連續可見的 meshlet 會合併成同一段
+struct ClusterDrawList {
+  std::vector<GLsizei> counts;
+  std::vector<const void*> offsets;
+  size_t visibleMeshlets{0};
+  size_t visibleTriangles{0};
+};
+
+// CPU 端 meshlet culling：frustum（bounding sphere）+ backface（normal cone）
+class ClusterCuller {
+ public:
+  // numThreads = 0 => std::thread::hardware_concurrency()
+  explicit ClusterCuller(unsigned numThreads = 0);
+
+  void cull(const geom::MeshletData& data, const glm::mat4& modelMatrix, const glm::mat4& viewProj,
+            const glm::vec3& camPosition, ClusterDrawList& out);
+
+  bool frustumCulling{true};
+  bool backfaceCulling{true};
+
+ private:
+  unsigned numThreads_;
+  std::vector<uint8_t> visible_;
+};
+
+}  // namespace gfx::render
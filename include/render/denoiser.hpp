@@ -0,0 +1,65 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <memory>
+
+#include "render/render_graph.hpp"
+
+class Shader;  // 你的 ShaderClass（由 ShaderClass.hpp 提供）
+namespace gfx::render {
+
+// path tracer 累積結果的降噪（SVGF 的空間部分，Schied 2017）：
+// 1. variance：除掉第一個交點的 albedo（只濾光照，貼圖細節不會糊掉），由累積的亮度二階動差估 variance，
+//    累積不到 4 幀（含 real-time 模式）時改用 3x3 鄰域估
+// 2. à-trous：5x5 B3-spline kernel、step 1, 2, 4…，以 normal / depth / 亮度（variance 決定容忍度）做 edge-stopping，
+//    每次迭代一起傳遞 variance，樣本越多 variance 越小、濾波自然越弱
+// 3. modulate：乘回 albedo
+// 全部是 fragment pass（GL 3.3），fragment 與 wavefront 兩種 path tracer 都能用
+class Denoiser {
+ public:
+  struct Settings {
+    int iterations = 5;           // à-trous 次數，footprint 為 4 * (2^iterations - 1) + 1 pixel
+    float sigmaLuminance = 4.0f;  // 亮度差容忍幾個標準差
+    float sigmaNormal = 128.0f;   // dot(n, n') 的次方
+    float sigmaDepth = 1.0f;      // 依 depth 梯度預期的差值倍數
+  };
+
+  // 某個資源的第 attachment 個 color texture（{resource} 時為 0）
+  struct Input {
+    RenderGraph::Resource resource;
+    size_t attachment = 0;
+  };
+
+  Denoiser(int width, int height);
+  ~Denoiser();
+  Denoiser(const Denoiser&) = delete;
+  Denoiser& operator=(const Denoiser&) = delete;
+
+  // color：rgb 為累積平均、a 為亮度平方的平均（acc_framebuffer_frag.glsl）
+  // albedo / normalDepth：第一個交點的 G-buffer（rt_trace.glsl 的 gAlbedo / gNormalDepth）
+  // sampleCount：color 累積了幾幀；history 有給時改用它的 r（逐 pixel 的幀數，temporal reprojection 用）
+  // 回傳結果（GL_RGBA16F 的 transient），沒有人讀時整串 pass 都會被 cull
+  // 中間的 target 都是 transient，每次 à-trous 迭代宣告一個新的，graph 會讓它們兩兩共用 FBO（ping-pong）
+  RenderGraph::Resource addPasses(RenderGraph& graph, Input color, Input albedo, Input normalDepth, int sampleCount,
+                                  const Settings& settings, Input history);
+  // 不用逐 pixel 幀數的版本（預設參數不能用 Input 的 member 初始值，class 還沒完整）
+  RenderGraph::Resource addPasses(RenderGraph& graph, Input color, Input albedo, Input normalDepth, int sampleCount,
+                                  const Settings& settings) {
+    return addPasses(graph, color, albedo, normalDepth, sampleCount, settings, Input{RenderGraph::kInvalid});
+  }
+
+  int width;
+  int height;
+
+ private:
+  void drawFullscreen() const;
+
+  std::unique_ptr<Shader> varianceShader_;
+  std::unique_ptr<Shader> atrousShader_;
+  std::unique_ptr<Shader> modulateShader_;
+  core::FBOSpec scratchSpec_;  // rgb 光照、a variance
+  core::FBOSpec outputSpec_;
+  GLuint emptyVAO_ = 0;  // core profile 畫東西一定要綁 VAO，頂點由 gl_VertexID 產生
+};
+
+}  // namespace gfx::render
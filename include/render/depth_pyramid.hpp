@@ -0,0 +1,33 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <memory>
+
+class Shader;  // 你的 ShaderClass（由 ShaderClass.hpp 提供）
+namespace gfx::render {
+
+// Hierarchical-Z：depth buffer 的 max-reduction mip chain（GL_R32F，level 0 與 depth buffer 同尺寸）
+// 以 compute shader 建立，需要 GL 4.3
+class DepthPyramid {
+ public:
+  DepthPyramid(int width, int height);
+  ~DepthPyramid();
+  DepthPyramid(const DepthPyramid&) = delete;
+  DepthPyramid& operator=(const DepthPyramid&) = delete;
+
+  static bool supported();
+
+  // depthTexture 必須是可取樣的 depth texture（例如 FBO::depthTextureID），尺寸為 width x height
+  void build(GLuint depthTexture);
+  void bindTexture(GLenum textureUnit) const;
+
+  GLuint textureID = 0;
+  int width;
+  int height;
+  int levels;
+
+ private:
+  std::unique_ptr<Shader> shader_;
+};
+
+}  // namespace gfx::render
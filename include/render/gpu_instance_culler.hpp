@@ -0,0 +1,58 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include "core/ssbo.hpp"
+
+class Shader;  // 你的 ShaderClass（由 ShaderClass.hpp 提供）
+namespace gfx::render {
+
+// glDrawElementsIndirect 的 command 格式
+struct DrawElementsIndirectCommand {
+  GLuint count;
+  GLuint instanceCount;
+  GLuint firstIndex;
+  GLint baseVertex;
+  GLuint baseInstance;
+};
+
+// GPU 版 instance frustum culling（compute shader，需要 GL 4.3）
+// 可見的 instance matrix 寫進 visibleInstances()，數量直接寫進 drawCommands() 的 instanceCount，
+// 之後用 MeshRenderer::drawIndirect 畫，整個流程不需要讀回 CPU
+class GpuInstanceCuller {
+ public:
+  GpuInstanceCuller();
+  ~GpuInstanceCuller();
+  GpuInstanceCuller(const GpuInstanceCuller&) = delete;
+  GpuInstanceCuller& operator=(const GpuInstanceCuller&) = delete;
+
+  static bool supported();
+
+  // instance 改變時才需要重新上傳
+  void setInstances(const std::vector<glm::mat4>& instances);
+  // 每個 mesh 一個 command，indexCounts[i] 是第 i 個 mesh 要畫的 index 數
+  void setDrawCommands(const std::vector<GLuint>& indexCounts);
+
+  // localCenter / localRadius：所有 command 共用的 bounding sphere（例如 Model::bounds）
+  void cull(const glm::mat4& viewProj, const glm::vec3& localCenter, float localRadius);
+
+  const core::SSBO& visibleInstances() const { return visible_; }
+  const core::SSBO& drawCommands() const { return commands_; }
+
+  // 讀回可見數量（會等 GPU，只給 UI/debug 用）
+  GLuint readVisibleCount() const;
+
+ private:
+  std::unique_ptr<Shader> shader_;
+  core::SSBO instances_;
+  core::SSBO visible_;
+  core::SSBO commands_;
+  std::vector<DrawElementsIndirectCommand> initialCommands_;
+  GLuint instanceCount_{0};
+};
+
+}  // namespace gfx::render
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace gfx::render {
+
+// CPU 端 instance frustum culling：每個 instance 的 bounding sphere 對六個平面
+// 只依賴 glm + geom::Frustum，不需要 GL context，可以單獨 benchmark（tool/bench_instance_cull）
+class InstanceCuller {
+ public:
+  // localCenter / localRadius：mesh local space 的 bounding sphere（例如 Mesh::bounds）
+  // visible 會被清空後填入可見 instance 的 index（保持原順序），回傳可見數量
+  size_t cull(const glm::mat4* instances, size_t count, const glm::vec3& localCenter, float localRadius,
+              const glm::mat4& viewProj, std::vector<uint32_t>& visible) const;
+
+  size_t cull(const std::vector<glm::mat4>& instances, const glm::vec3& localCenter, float localRadius,
+              const glm::mat4& viewProj, std::vector<uint32_t>& visible) const {
+    return cull(instances.data(), instances.size(), localCenter, localRadius, viewProj, visible);
+  }
+
+  // 編譯時有 SSE2 才有 SIMD 版本，否則 useSimd 會被忽略
+  static bool simdAvailable();
+  bool useSimd{true};
+};
+
+}  // namespace gfx::render
@@ -3,6 +3,9 @@
 #include <vector>
 
 namespace gfx {
+namespace core {
+class SSBO;
+}
 namespace geom {
 class Mesh;
 }
@@ -11,12 +14,28 @@ class Mesh;
 class Shader;  // 你的 ShaderClass（由 ShaderClass.hpp 提供）
 namespace gfx::render {
 
+struct ClusterDrawList;
+
 class MeshRenderer {
  public:
   // 綁定多個 UBO 的 binding points（可選，不用就給空陣列）
   void draw(const geom::Mesh& mesh, Shader& shader, uint32_t instanceCount = 1,
             const std::vector<uint32_t>& uboBindingPoints = {}, unsigned primitive = 0 /* 0=>GL_TRIANGLES */) const;
 
+  // 只畫 ClusterCuller 留下來的 meshlet（mesh 的 index buffer 必須是 MeshletData::indices）
+  void drawClusters(const geom::Mesh& mesh, Shader& shader, const ClusterDrawList& drawList,
+                    const std::vector<uint32_t>& uboBindingPoints = {}) const;
+
+  // 畫 mesh.lods[lod]，使用 instance buffer 中 [baseInstance, baseInstance + instanceCount) 的矩陣
+  // 透過調整 instance attribute 的 offset 達成（GL 3.3 沒有 glDrawElementsInstancedBaseInstance）
+  void drawLod(const geom::Mesh& mesh, Shader& shader, uint32_t lod, uint32_t instanceCount, uint32_t baseInstance = 0,
+               const std::vector<uint32_t>& uboBindingPoints = {}) const;
+
+  // 畫 commands[commandIndex]（DrawElementsIndirectCommand），參數由 GPU culling 寫入
+  // instances 不為空時，instance matrix 改從該 buffer 讀（GpuInstanceCuller::visibleInstances）
+  void drawIndirect(const geom::Mesh& mesh, Shader& shader, const core::SSBO& commands, size_t commandIndex = 0,
+                    const core::SSBO* instances = nullptr, const std::vector<uint32_t>& uboBindingPoints = {}) const;
+
   // 僅畫頂點範圍（非索引）
   void drawRange(const geom::Mesh& mesh, Shader& shader, uint32_t numVertices, uint32_t startIdx = 0,
                  uint32_t instanceCount = 1, const std::vector<uint32_t>& uboBindingPoints = {},
@@ -25,6 +44,8 @@ class MeshRenderer {
  private:
   void bindTextures_(const geom::Mesh& mesh, Shader& shader) const;
   void bindUbos_(const geom::Mesh& mesh, const std::vector<uint32_t>& uboBindingPoints) const;
+  void bindConstantAttribs_(const geom::Mesh& mesh) const;
+  void linkInstanceMatrices_(size_t byteOffset) const;
 };
 
 }  // namespace gfx::render
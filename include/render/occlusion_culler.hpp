@@ -0,0 +1,63 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include "core/ssbo.hpp"
+#include "geom/bounds.hpp"
+
+class Shader;  // 你的 ShaderClass（由 ShaderClass.hpp 提供）
+namespace gfx::render {
+
+class DepthPyramid;
+
+// 兩階段 Hi-Z occlusion culling（compute shader，需要 GL 4.3）
+// 每個物件一個 DrawElementsIndirectCommand，instanceCount 由 GPU 寫 0/1，用 MeshRenderer::drawIndirect 畫
+//
+//   cullEarly() -> 畫 earlyCommands()（上一幀可見的物件）-> DepthPyramid::build()
+//   cullLate()  -> 畫 lateCommands()（這一幀才變可見的物件，避免 popping）
+class OcclusionCuller {
+ public:
+  struct Stats {
+    GLuint drawnEarly;
+    GLuint drawnLate;
+    GLuint occluded;
+  };
+
+  OcclusionCuller();
+  ~OcclusionCuller();
+  OcclusionCuller(const OcclusionCuller&) = delete;
+  OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+  static bool supported();
+
+  // bounds 為 world space；indexCounts[i] 是第 i 個物件要畫的 index 數
+  void setObjects(const std::vector<geom::Bounds>& bounds, const std::vector<GLuint>& indexCounts);
+
+  void cullEarly(const glm::mat4& viewProj);
+  void cullLate(const glm::mat4& viewProj, const DepthPyramid& pyramid);
+
+  const core::SSBO& earlyCommands() const { return earlyCommands_; }
+  const core::SSBO& lateCommands() const { return lateCommands_; }
+
+  // 讀回統計（會等 GPU，只給 UI/debug 用）
+  Stats readStats() const;
+
+  // 關掉時 late phase 只做 frustum culling
+  bool occlusionEnabled{true};
+
+ private:
+  void dispatch_(bool latePhase, const glm::mat4& viewProj, const core::SSBO& commands);
+
+  std::unique_ptr<Shader> shader_;
+  core::SSBO objects_;
+  core::SSBO visibility_;
+  core::SSBO earlyCommands_;
+  core::SSBO lateCommands_;
+  core::SSBO stats_;
+  GLuint objectCount_{0};
+};
+
+}  // namespace gfx::render
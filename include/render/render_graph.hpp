@@ -0,0 +1,122 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/fbo.hpp"
+#include "core/render_target_pool.hpp"
+
+namespace gfx::render {
+
+// 每幀重建的 frame graph：pass 宣告讀寫哪些資源，execute() 時
+// - 依讀寫關係排序（寫入者先於讀取者，同一資源的寫入維持加入順序），
+// - 刪掉結果沒有人用的 pass（沒有寫到 imported 資源 / markOutput 的資源、也沒被這樣的 pass 讀），
+// - transient 資源在第一次使用前才向 RenderTargetPool 借、最後一個 pass 用完就還，
+//   生命週期不重疊且 spec 相同的 transient 共用同一個 FBO（GL 沒有顯式的記憶體 aliasing，以 target 為單位共用），
+// - pass 寫的 render target 自動 bind 並設定 viewport，讀的 texture 由 Context::bindInputs() 綁到 unit 0, 1…，
+// - 讀到前面以 image store（compute）寫的資源時插入 glMemoryBarrier
+class RenderGraph {
+ public:
+  using Resource = int;
+  static constexpr Resource kInvalid = -1;
+
+  class Builder {
+   public:
+    // 這一幀內才存在的 render target
+    Resource create(const std::string& name, const core::FBOSpec& spec);
+    // uniform 不是 nullptr 時，bindInputs() 會把第 attachment 個 color texture 綁到下一個 texture unit
+    void read(Resource resource, const char* uniform = nullptr, size_t attachment = 0);
+    // 以 render target 寫入；一個 pass 至多一個，執行前自動 bind
+    void write(Resource resource);
+    // 以 image store / compute 寫入，之後讀取前插 barrier
+    void writeImage(Resource resource);
+
+   private:
+    friend class RenderGraph;
+    Builder(RenderGraph& graph, int pass) : graph_(graph), pass_(pass) {}
+    RenderGraph& graph_;
+    int pass_;
+  };
+
+  class Context {
+   public:
+    GLuint texture(Resource resource, size_t attachment = 0) const;
+    core::FBO* target(Resource resource) const;  // imported texture / backbuffer 為 nullptr
+    void bindInputs(GLuint program) const;
+
+   private:
+    friend class RenderGraph;
+    Context(const RenderGraph& graph, int pass) : graph_(graph), pass_(pass) {}
+    const RenderGraph& graph_;
+    int pass_;
+  };
+
+  using SetupFn = std::function<void(Builder&)>;
+  using ExecuteFn = std::function<void(const Context&)>;
+
+  struct Stats {
+    size_t passes = 0;      // 實際執行的
+    size_t culled = 0;
+    size_t transients = 0;  // 宣告的 transient 資源
+    size_t targets = 0;     // 實際用到的 FBO 數（aliasing 之後）
+  };
+
+  explicit RenderGraph(core::RenderTargetPool& pool) : pool_(pool) {}
+  RenderGraph(const RenderGraph&) = delete;
+  RenderGraph& operator=(const RenderGraph&) = delete;
+
+  // 跨幀存在的資源；寫入 imported 資源的 pass 不會被刪掉
+  Resource importTarget(const std::string& name, core::FBO& target);
+  Resource importTexture(const std::string& name, GLuint texture, int width, int height);
+  Resource importBackbuffer(int width, int height);
+
+  // setup 立即執行；execute 在 RenderGraph::execute() 時依排好的順序呼叫
+  void addPass(const std::string& name, const SetupFn& setup, ExecuteFn execute);
+  // 沒有 pass 讀、但之後（graph 外）還要用的 transient / imported 資源
+  void markOutput(Resource resource);
+
+  // 排序、cull、執行，之後清空，下一幀重新加 pass
+  void execute();
+
+  const Stats& stats() const { return stats_; }
+  const std::vector<std::string>& executedPasses() const { return executed_; }  // 上一次 execute() 的順序
+
+ private:
+  enum class Kind { Transient, Target, Texture, Backbuffer };
+  struct ResourceNode {
+    std::string name;
+    Kind kind;
+    core::FBOSpec spec;           // transient 的配置；其他只用 width / height
+    core::FBO* target = nullptr;  // transient 執行中才有
+    GLuint texture = 0;           // Kind::Texture
+    bool output = false;
+    bool pendingImageWrite = false;
+  };
+  struct Input {
+    Resource resource;
+    const char* uniform;
+    size_t attachment;
+  };
+  struct PassNode {
+    std::string name;
+    ExecuteFn execute;
+    std::vector<Input> reads;
+    std::vector<Resource> writes;
+    std::vector<Resource> imageWrites;
+    bool alive = false;
+  };
+
+  bool writesTo(const PassNode& pass, Resource resource) const;
+  std::vector<int> sortPasses() const;
+  void reset();
+
+  core::RenderTargetPool& pool_;
+  std::vector<ResourceNode> resources_;
+  std::vector<PassNode> passes_;
+  std::vector<std::string> executed_;
+  Stats stats_;
+};
+
+}  // namespace gfx::render
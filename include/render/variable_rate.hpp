@@ -0,0 +1,41 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <functional>
+#include <memory>
+
+#include "core/fbo.hpp"
+
+class Shader;  // 你的 ShaderClass（由 ShaderClass.hpp 提供）
+namespace gfx::render {
+
+// shaders/variable_rate.glsl 的 C++ 端：先以 1/scale 解析度畫一次，全解析度那次只在邊緣重新 trace / march
+// 數值與 shader 的 VARIABLE_RATE_* 一致，以 uniform int variableRatePass 傳入
+enum class VariableRatePass : int { Off = 0, Low = 1, Upsample = 2 };
+
+// 低解析度 pass 的 target：attachment 0 為 color，1 為 guide（xyz normal、w 命中距離，沒打到為 0）
+// 無條件進位，shader 的 resolution 設為 width / scale 這類非整數，低解析度的 pixel 才會對齊全解析度
+inline core::FBOSpec variableRateSpec(int width, int height, int scale, GLenum colorFormat) {
+  core::FBOSpec spec;
+  spec.width = (width + scale - 1) / scale;
+  spec.height = (height + scale - 1) / scale;
+  spec.colorFormats = {colorFormat, GL_RGBA16F};
+  return spec;
+}
+
+// 直接畫到畫面上的全螢幕 ray marcher（sdf_*_frag.glsl）用：自己管低解析度 target，畫兩次
+class VariableRateRenderer {
+ public:
+  // shader 已 use、其他 uniform 已設好；draw 畫一次全螢幕，會被呼叫兩次（低解析度、全解析度）
+  // 低解析度的 color / guide 綁在 firstUnit、firstUnit + 1，不要跟 shader 自己的 texture 衝突
+  void render(Shader& shader, int width, int height, int scale, GLuint firstUnit, const std::function<void()>& draw);
+  // 關閉時一般地畫一次之前呼叫
+  static void disable(Shader& shader);
+
+  const core::FBO* lowRes() const { return lowRes_.get(); }
+
+ private:
+  std::unique_ptr<core::FBO> lowRes_;
+};
+
+}  // namespace gfx::render
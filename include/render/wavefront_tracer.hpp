@@ -0,0 +1,78 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include "ShaderPreprocessor.hpp"
+#include "core/ssbo.hpp"
+
+class Shader;  // 你的 ShaderClass（由 ShaderClass.hpp 提供）
+namespace gfx::render {
+
+// compute shader 版的 wavefront path tracer（需要 GL 4.3），場景沿用 rt_scene_bvh.glsl 的 SSBO（binding 0-3）
+// 一個 megakernel 裡每條 path 在不同 bounce 結束，warp 內已結束的 thread 只能空等；這裡把每個 bounce 拆成
+// extend（最近交點）→ shade（材質、NEE 的 shadow ray、下一段光線）→ connect（shadow ray 測遮擋）三個 pass，
+// shade 把還活著的 path 壓縮進下一個 ray queue，之後的 pass 以 glDispatchComputeIndirect 只跑存活的數量
+class WavefrontPathTracer {
+ public:
+  struct Frame {
+    glm::vec3 camPosition;
+    glm::mat4 viewMatrix;
+    float fov = 45.0f;
+    uint32_t frameIdx = 0;
+    float ambientLight = 0.0f;
+    int sphereRoot = -1;  // 同 rt_scene_bvh.glsl，-1 表示沒有
+    int triangleRoot = -1;
+    int numRays = 1;  // 每個 pixel 的 sample 數
+    int numBounces = 3;
+    int samplerType = 0;     // geom::SamplerType（rt_sampler.glsl）
+    int blueNoiseUnit = -1;  // SAMPLER_BLUE_NOISE 時 blue noise texture 所在的 texture unit，需先綁好
+  };
+
+  // defines 為場景的 feature switch（SPECULAR_BOUNCE、SHOW_SPHERE_LIGHT…，見 rt_common.glsl）
+  WavefrontPathTracer(int width, int height, const ShaderDefines& defines = {});
+  ~WavefrontPathTracer();
+  WavefrontPathTracer(const WavefrontPathTracer&) = delete;
+  WavefrontPathTracer& operator=(const WavefrontPathTracer&) = delete;
+
+  static bool supported();
+
+  // 同步重新 compile 所有 pass，只在 toggle 改變時呼叫
+  void setDefines(const ShaderDefines& defines);
+  const ShaderDefines& defines() const { return defines_; }
+  // NEE 抽樣的發光 primitive（>= 0 為三角形 index，< 0 為球 -(index + 1)），最多 MAX_LIGHTS 個（rt_lights.glsl）
+  // 必須包含所有看得到且 shininess > 0 的 primitive，MIS 假設每個光源都可能被抽到
+  void setLights(const std::vector<int32_t>& lights);
+
+  // 場景 SSBO 需先綁好（binding 0-3），結果寫進 textureID
+  void render(const Frame& frame);
+
+  // 讀回每個 bounce 開始時的存活 path 數（會等 GPU，只給 UI/debug 用）
+  std::vector<GLuint> readActivePaths();
+
+  GLuint textureID = 0;  // GL_RGBA32F，本幀 numRays 個 sample 的平均
+  // 第一個交點的 G-buffer（GL_RGBA32F），給 Denoiser；內容同 rt_trace.glsl 的 gAlbedo / gNormalDepth
+  GLuint albedoTextureID = 0;
+  GLuint normalDepthTextureID = 0;
+  int width;
+  int height;
+
+ private:
+  enum Pass { GENERATE, EXTEND, SHADE, PREPARE, CONNECT, RESOLVE, PASS_COUNT };
+
+  std::unique_ptr<Shader> passes_[PASS_COUNT];
+  core::SSBO paths_;
+  core::SSBO queues_[2];
+  core::SSBO hits_;
+  core::SSBO shadowRays_;
+  core::SSBO counters_;
+  core::SSBO activePaths_;  // 每個 bounce 從 counters_ 複製一份 ray 數量
+  ShaderDefines defines_;
+  std::vector<int32_t> lights_;
+  int lastBounces_ = 0;
+};
+
+}  // namespace gfx::render
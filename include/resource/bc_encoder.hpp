@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gfx::resource {
+
+// GPU block compression 格式，每個 block 都是 4x4 texel
+enum class BcFormat {
+  BC1,  // RGB 565 + 2-bit index，8 bytes/block（不透明貼圖）
+  BC3,  // BC1 color + BC4 alpha，16 bytes/block
+  BC5,  // 兩個 BC4 通道（RG），16 bytes/block，適合 normal map
+  BC7,  // mode 6：RGBA 7777.1 endpoints + 4-bit index，16 bytes/block
+};
+
+size_t bcBlockBytes(BcFormat format);
+size_t bcImageBytes(BcFormat format, int width, int height);
+const char *bcFormatName(BcFormat format);
+
+// 單一 block 的 encoder，rgba 是 16 個 texel（row-major）的 RGBA8
+void encodeBlockBC1(const uint8_t rgba[64], uint8_t out[8]);
+void encodeBlockBC3(const uint8_t rgba[64], uint8_t out[16]);
+void encodeBlockBC5(const uint8_t rgba[64], uint8_t out[16]);
+void encodeBlockBC7(const uint8_t rgba[64], uint8_t out[16]);
+
+// 壓縮整張 RGBA8 影像；邊緣不足 4 的 block 以最後一行/列補齊
+// block row 平均分給 numThreads 個 thread（0 = hardware_concurrency）
+std::vector<uint8_t> compressImage(const uint8_t *rgba, int width, int height, BcFormat format,
+                                   unsigned numThreads = 0);
+
+}  // namespace gfx::resource
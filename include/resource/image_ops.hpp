@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gfx::resource {
+
+// 8-bit 影像的前處理，不依賴 GL，tool/ 也會直接編進去
+// 編譯時有 SSE2 / SSSE3 / AVX2 就走向量化版本，否則為 scalar；大張圖會依 row 分給多個 thread
+// 影像都是緊密排列（row stride = width * channels）
+
+// 原地左右 / 上下翻轉，上下翻轉不需要額外的暫存 row
+void flipImageHorizontal(uint8_t *data, int width, int height, int channels);
+void flipImageVertical(uint8_t *data, int width, int height, int channels);
+
+// RGBA 通道重排：dst[c] = src[order[c]]，例如 {2, 1, 0, 3} 為 BGRA <-> RGBA
+void swizzleRgba(uint8_t *data, size_t pixelCount, const int order[4]);
+
+// RGB -> RGBA，alpha 填 alpha；src / dst 不可重疊
+void expandRgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixelCount, uint8_t alpha = 255);
+
+// sRGB <-> linear（查表）
+void srgbToLinear(const uint8_t *src, float *dst, size_t count);
+void linearToSrgb(const float *src, uint8_t *dst, size_t count);
+
+// 2x2 box filter 縮成 max(1, w/2) x max(1, h/2)，奇數邊長重複最後一列/行
+// srgb 為 true 時 RGB 在 linear space 平均（alpha / 第 4 通道照舊），避免 mip 越縮越暗
+void downsampleBox(const uint8_t *src, int width, int height, int channels, uint8_t *dst, bool srgb = false);
+
+// 循環位移：src 的 (x, y) 搬到 dst 的 ((x + dx) % w, (y + dy) % h)；src / dst 不可重疊
+// 位移 (w / 2, h / 2) 即為四象限對調，移回去用 (w - w / 2, h - h / 2)
+void rollImage(const uint8_t *src, uint8_t *dst, int width, int height, int channels, int dx, int dy);
+
+// 可分離的 Gaussian blur，kernel 大小 2 * radius + 1，邊界為 reflect-101（同 OpenCV 預設）
+// sigma <= 0 時依 OpenCV 的公式由 kernel 大小推得
+// 只計算 [x, x + w) x [y, y + h) 這塊，鄰近 pixel 仍從整張 src 讀；dst 為整張圖大小，區域外不寫入
+// src / dst 不可重疊
+void gaussianBlur(const uint8_t *src, int width, int height, int channels, uint8_t *dst, int radius,
+                  float sigma = 0.0f);
+void gaussianBlurRegion(const uint8_t *src, int width, int height, int channels, uint8_t *dst, int radius,
+                        float sigma, int x, int y, int w, int h);
+
+}  // namespace gfx::resource
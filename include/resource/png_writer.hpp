@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace gfx::resource {
+
+// 8-bit PNG 輸出，不依賴 GL，tool/ 直接編進去
+// 不額外引入 zlib / stb_image_write：deflate 只用 stored block（不壓縮），檔案較大但任何 decoder 都能讀
+// pixels 緊密排列（row stride = width * channels），channels 1 / 2 / 3 / 4 對應 gray、gray + alpha、RGB、RGBA
+bool writePng(const std::string &path, const uint8_t *pixels, int width, int height, int channels);
+
+}  // namespace gfx::resource
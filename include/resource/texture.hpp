@@ -4,12 +4,23 @@
 
 #include <string>
 
+#include "resource/texture_container.hpp"
+
 namespace gfx::resource {
 
+// BC1/BC3 需要 EXT_texture_compression_s3tc（sRGB 另外需要 EXT_texture_sRGB），BC5 為 GL 3.0 core，
+// BC7 需要 GL 4.2 或 ARB_texture_compression_bptc
+bool compressedFormatSupported(BcFormat format, bool srgb = false);
+GLenum compressedInternalFormat(BcFormat format, bool srgb = false);
+// 把所有 face / mip 用 glCompressedTexImage2D 上傳到目前 bind 在 target 的 texture
+// base 為 nullptr 時表示資料已經在 GL_PIXEL_UNPACK_BUFFER（PBO）裡，level offset 就是 buffer offset
+void uploadCompressedTexture(GLenum target, const CompressedTexture &tex, const uint8_t *base);
+
 class Texture {
  public:
   std::string type;
   Texture();
+  // image 為 .ktx2 / .dds 時直接上傳預先壓縮好的 mip chain，不在執行期產生 mipmap
   Texture(const char *image, const char *texType, GLuint slot);
   ~Texture() { reset(); }
   Texture(const Texture &) = delete;
@@ -19,10 +30,22 @@ class Texture {
 
   void bind() const;
   void unbind() const;
+  GLuint id() const { return ID; }  // 給 render graph 之類自己決定 unit 的地方
+
+  // 透過 TextureStreamer 載入時，完成前綁的是 1x1 placeholder
+  bool isReady() const { return ready; }
+  // 估計的 VRAM 佔用（含 mip chain），TextureCache 用來算 budget；placeholder 視為 0
+  size_t byteSize() const { return memoryBytes; }
 
  private:
+  friend class TextureStreamer;
+
   void reset();
+  void loadCompressed(const char *image);
   GLuint ID;
   GLuint unit;
+  GLenum target = GL_TEXTURE_2D;  // TextureStreamer 的 cube map 會是 GL_TEXTURE_CUBE_MAP
+  bool ready = true;
+  size_t memoryBytes = 0;
 };
 }  // namespace gfx::resource
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "resource/texture.hpp"
+
+namespace gfx::resource {
+
+struct TextureCacheStats {
+  int hits = 0;
+  int misses = 0;
+  int evictions = 0;
+  int entries = 0;         // 還活著的 texture（含只剩 weak reference 的）
+  size_t totalBytes = 0;   // entries 佔用的 VRAM
+  size_t cachedBytes = 0;  // 其中沒有人在用、只被 cache 留著的部分
+  size_t budgetBytes = 0;
+};
+
+// 整個程式共用的 texture cache，key 為 path + type + slot
+//   - 同一張圖在不同 Test / Model / Mesh 之間只上傳一次
+//   - 每個 entry 都有 weak reference；最近用過的另外由 cache 持有 strong reference，
+//     所以切換 Test 後再切回來不用重新載入
+//   - 總量超過 budget 時，從 LRU 尾端釋放沒有人在用（只被 cache 持有）的 texture
+// 實際載入交給 TextureStreamer，回傳的 texture 一開始是 placeholder，大小要等上傳完才知道，
+// 所以 Main loop 每幀呼叫 update() 重新檢查 budget
+// 只能在 GL thread 使用
+class TextureCache {
+ public:
+  static TextureCache &instance();
+
+  std::shared_ptr<Texture> load(const std::string &path, const char *texType, GLuint slot);
+
+  void update() { trim(); }
+
+  // 超過 budget 會立刻依 LRU 釋放
+  void setBudget(size_t bytes);
+  // 丟掉所有只被 cache 持有的 texture
+  void clear();
+
+  TextureCacheStats stats() const;
+
+ private:
+  struct Entry {
+    std::weak_ptr<Texture> weak;
+    std::shared_ptr<Texture> strong;  // 在 LRU 中時才有
+    std::list<std::string>::iterator lruIt;
+  };
+
+  void touch(Entry &entry, const std::string &key);
+  void trim();
+
+  std::unordered_map<std::string, Entry> entries_;
+  std::list<std::string> lru_;  // front 最近使用，只包含有 strong reference 的 entry
+  size_t budgetBytes_ = size_t(256) << 20;
+  int hits_ = 0;
+  int misses_ = 0;
+  int evictions_ = 0;
+};
+
+}  // namespace gfx::resource
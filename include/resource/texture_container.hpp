@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "resource/bc_encoder.hpp"
+
+namespace gfx::resource {
+
+// 預先壓縮好的貼圖（含 mip chain），從 KTX2 / DDS 讀進來或由 tool/texture_compress 產生
+// 不依賴 GL，tool 可以單獨使用；上傳在 uploadCompressedTexture（texture.hpp）
+struct CompressedTexture {
+  struct Level {
+    size_t offset;  // 在 data 中的位置
+    size_t size;
+    int width;
+    int height;
+  };
+
+  BcFormat format = BcFormat::BC1;
+  bool srgb = false;  // DXGI / VK 的 *_SRGB 格式，上傳成 GL_COMPRESSED_SRGB*，取樣時硬體做 sRGB -> linear
+  int width = 0;
+  int height = 0;
+  int faceCount = 1;  // cube map 為 6，順序 +X, -X, +Y, -Y, +Z, -Z
+  int levelCount = 0;
+  std::vector<Level> levels;  // face * levelCount + level
+  std::vector<uint8_t> data;
+
+  const Level &level(int face, int mip) const { return levels[face * levelCount + mip]; }
+  // 所有 face / mip 的大小總和，也就是上傳後佔用的 VRAM（不含檔頭）
+  size_t payloadBytes() const;
+  // 依 face / mip 順序附加一層，回傳它在 levels 中的 index
+  size_t addLevel(const std::vector<uint8_t> &blocks, int w, int h);
+};
+
+// 副檔名為 .ktx2 或 .dds
+bool isCompressedTexturePath(const std::string &path);
+
+// 只支援 BC1/BC3/BC5/BC7、無 supercompression 的 2D 與 cube map
+bool readCompressedTexture(const std::string &path, CompressedTexture &out);
+bool writeCompressedTexture(const std::string &path, const CompressedTexture &tex);
+
+// 把同樣大小的 RGBA8 faces 壓成 format；mips 為 true 時用 downsampleBox 產生完整 mip chain
+// （srgb 時在 linear space 縮小並標記為 sRGB 格式，BC5 除外），每一層都交給 compressImage 分 thread 壓縮
+CompressedTexture compressTexture(const std::vector<const uint8_t *> &faces, int width, int height, BcFormat format,
+                                  bool mips, bool srgb, unsigned numThreads = 0);
+
+}  // namespace gfx::resource
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "resource/texture.hpp"
+
+namespace gfx::resource {
+
+// worker thread 解碼後的 CPU 影像（stbi 的 8-bit 資料）
+struct DecodedImage {
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  std::vector<unsigned char> pixels;
+};
+
+struct TextureStreamStats {
+  int queued = 0;     // 還在等 worker 解碼
+  int uploading = 0;  // 已送出 PBO 上傳、等 fence
+  int completed = 0;
+  int failed = 0;
+  float lastLatencyMs = 0.0f;  // 從 load() 到 texture 可用
+  float avgLatencyMs = 0.0f;
+  float maxLatencyMs = 0.0f;
+};
+
+// 非同步貼圖串流：
+//   1. load() 立刻回傳一個綁著 1x1 placeholder 的 Texture
+//   2. worker thread 做 stbi 解碼（以及 cube map 的翻轉等 CPU 前處理）
+//   3. update() 在 GL thread 上把解碼結果 memcpy 進 PBO，從 PBO 發 glTexImage2D，再插一個 fence
+//   4. fence signaled 後才把新的 texture ID 換進 Texture，placeholder 刪掉
+// 只保留 Texture 的 weak_ptr，場景切換時還沒載完的 Texture 被釋放就直接丟棄，不會卡住 GUI
+class TextureStreamer {
+ public:
+  // 在 worker thread 上對每一個 face 執行，用於翻轉等前處理
+  using FaceTransform = std::function<void(DecodedImage &image, int face)>;
+
+  // numThreads 為 0 時使用 hardware_concurrency - 1（至少 1）
+  explicit TextureStreamer(unsigned numThreads = 0);
+  ~TextureStreamer();
+  TextureStreamer(const TextureStreamer &) = delete;
+  TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+  // 整個程式共用一個，Main loop 每幀呼叫 update()
+  static TextureStreamer &instance();
+
+  // path 為 .ktx2 / .dds 時 worker 只讀檔，上傳走 glCompressedTexImage2D
+  std::shared_ptr<Texture> load(const std::string &path, const char *texType, GLuint slot);
+  // faces 順序：+X, -X, +Y, -Y, +Z, -Z；也可以只給一個預先壓縮好的 cube map 檔（transform 會被忽略）
+  std::shared_ptr<Texture> loadCubeMap(const std::vector<std::string> &faces, GLuint slot,
+                                       FaceTransform transform = nullptr);
+
+  // 只能在 GL thread 呼叫
+  void update();
+  // 在 GL context 銷毀前呼叫，釋放還在飛的 PBO / fence
+  void shutdown();
+
+  TextureStreamStats stats() const;
+
+  // 每幀最多送進 PBO 的 byte 數，避免一次上傳太多張造成掉幀；至少會處理一個
+  size_t uploadBudgetBytes = 16u << 20;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Job {
+    std::weak_ptr<Texture> owner;
+    GLenum target;
+    std::vector<std::string> paths;
+    FaceTransform transform;
+    Clock::time_point start;
+  };
+
+  struct Decoded {
+    std::weak_ptr<Texture> owner;
+    GLenum target = GL_TEXTURE_2D;
+    std::vector<DecodedImage> faces;
+    Clock::time_point start;
+    bool ok = false;
+    bool isCompressed = false;
+    CompressedTexture compressed;
+
+    size_t byteSize() const;
+  };
+
+  struct InFlight {
+    std::weak_ptr<Texture> owner;
+    GLuint textureID;
+    GLuint pbo;
+    GLsync fence;
+    Clock::time_point start;
+    size_t memoryBytes;
+  };
+
+  void workerLoop();
+  void submit(Job job);
+  void beginUpload(Decoded &decoded);
+  bool finishUpload(InFlight &upload, bool wait);
+  void recordLatency(Clock::time_point start);
+
+  static GLuint createPlaceholder(GLenum target, const char *texType);
+
+  std::vector<std::thread> workers_;
+  std::deque<Job> jobs_;
+  std::vector<Decoded> decoded_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+  int decoding_ = 0;
+
+  // 以下只在 GL thread 存取
+  std::vector<InFlight> inFlight_;
+  int completed_ = 0;
+  int failed_ = 0;
+  float lastLatencyMs_ = 0.0f;
+  double totalLatencyMs_ = 0.0;
+  float maxLatencyMs_ = 0.0f;
+};
+
+}  // namespace gfx::resource
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <initializer_list>
+
 #include "Camera.hpp"
+#include "ShaderClass.hpp"
 
 namespace test {
 class Test {
@@ -18,5 +21,9 @@ class Test {
   virtual void OnReload();
   virtual void OnImGuiRender();
   virtual void OnExit();
+
+ protected:
+  // 非同步 compile 的 shader 都好了才回傳 true；還沒好時清成底色當 loading frame，scene 這一幀不要畫
+  bool waitForShaders(std::initializer_list<Shader*> shaders);
 };
 }  // namespace test
@@ -3,6 +3,8 @@
 #include "Camera.hpp"
 #include "Model.hpp"
 #include "ShaderClass.hpp"
+#include "geom/meshlet.hpp"
+#include "render/cluster_culler.hpp"
 #include "render/mesh_renderer.hpp"
 #include "render/model_renderer.hpp"
 #include "tests/Test.hpp"
@@ -26,6 +28,11 @@ class TestModel : public Test {
   glm::vec3 trans{0.0f, 0.0f, 0.0f};
   glm::vec3 scale{1.0f, 1.0f, 1.0f};
   glm::vec3 rot{0.0f, 0.0f, 0.0f};
+  // meshlet cluster culling
+  bool useClusterCulling = true;
+  gfx::render::ClusterCuller culler;
+  std::vector<gfx::geom::MeshletData> meshlets;  // 與 model->meshes 一一對應
+  std::vector<gfx::render::ClusterDrawList> drawLists;
   std::unique_ptr<CameraEventListener> listener;
 };
 
@@ -3,6 +3,8 @@
 #include "Camera.hpp"
 #include "Model.hpp"
 #include "ShaderClass.hpp"
+#include "render/gpu_instance_culler.hpp"
+#include "render/instance_culler.hpp"
 #include "render/mesh_renderer.hpp"
 #include "render/model_renderer.hpp"
 #include "tests/Test.hpp"
@@ -24,6 +26,24 @@ class TestMultipleObj : public Test {
   int row = 100;
   int col = 100;
   const float OFFSET = 3.0f;
+  float screenHeight;
+
+  // 依投影後的 bounding sphere 大小挑 LOD
+  bool useLod = true;
+  float lodErrorPx = 1.0f;
+  std::vector<glm::mat4> sortedMatrices;
+  std::vector<uint32_t> lodCounts;  // 每個 LOD 的 instance 數（最後一個 mesh）
+  size_t trianglesDrawn = 0;
+
+  // frustum culling：0 = off, 1 = CPU (SIMD), 2 = GPU compute + indirect draw
+  enum CullMode { CULL_NONE = 0, CULL_CPU, CULL_GPU };
+  int cullMode = CULL_CPU;
+  gfx::render::InstanceCuller culler;
+  std::unique_ptr<gfx::render::GpuInstanceCuller> gpuCuller;  // 不支援 GL 4.3 時為空
+  std::vector<uint32_t> visibleInstances;
+  size_t visibleCount = 0;
+  float cullTimeMs = 0.0f;
+
   gfx::render::MeshRenderer mesh_renderer;
   gfx::render::ModelRenderer renderer;
   std::unique_ptr<Shader> shaderProgram;
@@ -31,6 +51,8 @@ class TestMultipleObj : public Test {
   std::unique_ptr<CameraEventListener> listener;
 
   void updateInstanceMatrices();
+  void drawLods();
+  void drawGpuCulled();
 };
 
 }  // namespace test
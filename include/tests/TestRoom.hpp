@@ -2,8 +2,11 @@
 
 #include "Camera.hpp"
 #include "ShaderClass.hpp"
+#include "core/fbo.hpp"
 #include "geom/mesh.hpp"
+#include "render/depth_pyramid.hpp"
 #include "render/mesh_renderer.hpp"
+#include "render/occlusion_culler.hpp"
 #include "tests/Test.hpp"
 
 namespace test {
@@ -30,6 +33,22 @@ class TestRoom : public Test {
   std::unique_ptr<gfx::geom::Mesh> groundMesh;
   const float backgroundColor[4] = {0.8f, 0.8f, 0.8f, 1.0f};
   std::unique_ptr<CameraEventListener> listener;
+
+  // 散在房間內外的物件，房間外的會被牆擋住
+  std::unique_ptr<gfx::geom::Mesh> propMesh;
+  std::vector<glm::mat4> propTransforms;
+
+  // Hi-Z occlusion culling（需要 GL 4.3，不支援時全部照畫）
+  int screenWidth;
+  int screenHeight;
+  bool useOcclusion = true;
+  std::unique_ptr<gfx::core::FBO> sceneFBO;
+  std::unique_ptr<gfx::render::DepthPyramid> depthPyramid;
+  std::unique_ptr<gfx::render::OcclusionCuller> occlusionCuller;
+  gfx::render::OcclusionCuller::Stats cullStats{};
+
+  void drawRoom();
+  void drawProps(const gfx::core::SSBO *commands);
 };
 
 }  // namespace test
@@ -2,9 +2,19 @@
 
 #include "Camera.hpp"
 #include "ShaderClass.hpp"
+#include "ShaderPermutations.hpp"
 #include "core/fbo.hpp"
+#include "core/render_target_pool.hpp"
+#include "core/ssbo.hpp"
+#include "geom/bvh.hpp"
 #include "geom/mesh.hpp"
+#include "geom/sampler.hpp"
+#include "render/denoiser.hpp"
 #include "render/mesh_renderer.hpp"
+#include "render/render_graph.hpp"
+#include "render/variable_rate.hpp"
+#include "render/wavefront_tracer.hpp"
+#include "resource/texture.hpp"
 #include "tests/Test.hpp"
 namespace test {
 
@@ -48,13 +58,29 @@ class TestRtSphere : public Test {
  private:
   gfx::render::MeshRenderer renderer;
   static const int MAX_SPHERES = 50;
-  static const int MAX_TRIANGLES = 24;  // 6 Plane (12) + 1 Light Cuboid (12)
+  static const int MAX_TRIANGLES = 24;  // 6 Plane (12) + 1 Light Cuboid (12)，載入的 mesh 接在後面
+  static const int SPHERE_NODE_CAPACITY = 2 * MAX_SPHERES;  // 球的 BVH 固定放在 node buffer 前段
+  static const int MAX_LIGHTS = MAX_SPHERES + MAX_TRIANGLES;  // NEE 的光源上限：每個球與 cornell box 三角形都可能發光
   static constexpr float CBS = 10.0f;   // Cornell Box Size
   static constexpr float CBS2 = 2 * CBS;
   static constexpr float MAX_REFLECTIVITY = 0.995f;
+  // wavefront 的 compute pass 用的 unit，避開 render graph 從 0 開始綁的 pass 輸入；fragment 版把它當 graph 的輸入讀
+  static constexpr GLuint BLUE_NOISE_UNIT = 7;
+  static constexpr int BLUE_NOISE_SIZE = 64;  // tool/blue_noise 的輸出
+  // shader 版本的 feature bit，順序與 rtShaders 的 features 一致
+  enum RtFeature : uint32_t {
+    RT_SPECULAR_BOUNCE = 1u << 0,
+    RT_SPECULAR_WHITE = 1u << 1,
+    RT_SPHERE_LIGHT = 1u << 2,
+    RT_CORNELL_PLANES = 1u << 3,
+    RT_CORNELL_LIGHT = 1u << 4,
+  };
   // ray casting
   int numBounces = 3;
   int numRays = 3;
+  int shaderBounces = 3;  // 以 define 編進 shader 的值，拉桿放開時才更新，避免拖動時每一格都編一個版本
+  int shaderRays = 3;
+  int samplerType = static_cast<int>(gfx::geom::SamplerType::Sobol);  // rt_sampler.glsl，runtime 切換
   bool enableSpecularBounce = true;
   bool isSpecularWhite = false;
   float sphereLightOffset[3] = {-6.0f, 1.0f, 8.0f};
@@ -78,21 +104,67 @@ class TestRtSphere : public Test {
   bool showSphereLight = true;
   float sphereLightShininess = 2.0f;
   bool isRandomShine = false;
+  // scene：有 GL 4.3 時場景放在 SSBO 並建 BVH，可以載入 mesh；沒有時退回固定大小的 UBO
+  bool useBVH = false;
+  bool showMesh = false;
+  int meshCopies = 1;
+  size_t sceneTriangles = MAX_TRIANGLES;
+  int triangleNodes = 0;
+  int bvhDepth = 0;
+  int sphereRoot = -1;
+  std::vector<Triangle> meshTemplate;  // 載入後正規化成 1 單位大小，放置時再縮放 / 平移
   // render
   bool isRealTime = true;
+  bool useWavefront = false;  // compute shader 版（WavefrontPathTracer），bounce / ray 數不需要重新 compile
+  bool showQueueStats = false;
+  bool useDenoiser = false;  // 累積結果經過 Denoiser 再顯示，real-time 模式也能用
+  // 以上一幀的相機把累積結果 reproject 過來（逐 pixel 計幀數），相機移動時不用整個重來
+  bool useTemporal = true;
+  int temporalHistory = 32;  // real-time 或相機移動時最多平均幾幀，越多越平滑、光照變化跟得越慢
+  // 收斂（mean 的相對標準差 < threshold）的 pixel 不再 trace；只在 temporal 的 progressive 模式、畫面不動時有效
+  bool useAdaptive = false;
+  float adaptiveThreshold = 0.02f;
+  // 先以 1/rateScale 解析度 trace，全解析度只在邊緣重新 trace（variable_rate.glsl）
+  bool useVariableRate = false;
+  int rateScale = 2;
+  glm::mat4 prevViewMatrix = glm::mat4(1.0f);
+  glm::vec3 prevCamPosition = glm::vec3(0.0f);
+  gfx::render::Denoiser::Settings denoiseSettings;
   // data
   Sphere spheres[MAX_SPHERES];
   Triangle triangles[MAX_TRIANGLES];
   int ping = 0;
   unsigned int frameIdx = 0;
-  std::unique_ptr<gfx::core::FBO> accumFBO[2];
-  std::unique_ptr<gfx::core::FBO> sceneFBO;
+  gfx::core::RenderTargetPool targetPool;  // render graph 的 transient（trace 結果、denoiser…）
+  gfx::render::RenderGraph graph{targetPool};
+  std::unique_ptr<gfx::core::FBO> accumFBO[2];  // color + 逐 pixel 累積幀數（temporal 用）
   std::unique_ptr<gfx::geom::Mesh> rtMesh;
   std::unique_ptr<gfx::geom::Mesh> frameMesh;
-  std::unique_ptr<Shader> shaderProgram;
+  std::unique_ptr<ShaderPermutations> rtShaders;
+  std::unique_ptr<gfx::core::SSBO> sphereBuffer;
+  std::unique_ptr<gfx::core::SSBO> triangleBuffer;
+  std::unique_ptr<gfx::core::SSBO> nodeBuffer;                  // [0, SPHERE_NODE_CAPACITY) 球，之後是三角形
+  std::unique_ptr<gfx::core::SSBO> indexBuffer;                 // [0, MAX_SPHERES) 球，之後是三角形
+  std::unique_ptr<gfx::resource::Texture> blueNoise;            // tool/blue_noise 產生
+  std::unique_ptr<gfx::render::WavefrontPathTracer> wavefront;  // 第一次切換到 wavefront 時才建立
+  std::unique_ptr<gfx::render::Denoiser> denoiser;
   std::unique_ptr<Shader> frameShader;
+  std::unique_ptr<Shader> motionShader;
+  std::unique_ptr<Shader> temporalShader;
   std::unique_ptr<CameraEventListener> listener;
 
+  uint32_t featureMask() const;
+  // fragment 版 path tracer 的一次繪製，pass 決定是低解析度、全解析度邊緣或一般的 trace
+  void traceFragment(const gfx::render::RenderGraph::Context& context, gfx::render::VariableRatePass pass, int width,
+                     int height, bool adaptive);
+  ShaderDefines featureDefines() const;  // featureMask 對應的 define，給 wavefront 的 compute pass
+  // 目前看得到且會發光的 primitive，NEE 時抽樣（mesh 不發光，只需要看球與 cornell box）
+  std::vector<int32_t> collectLights() const;
+  void loadMeshTemplate();
+  // cornell box + mesh 重新建 BVH 並整個上傳（只在 mesh 設定改變時）
+  void rebuildTriangleBVH();
+  // 球會動，每幀重建（最多 MAX_SPHERES 個，很便宜）
+  void uploadSphereBVH();
   void setReflectivity(Triangle* triangles, const int start, const int end, const float reflectivity);
   void makeCornellBox(Triangle* triangles);
   void randomizeSpheres(Sphere* spheres, const int numSpheres);
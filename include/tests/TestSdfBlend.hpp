@@ -4,6 +4,7 @@
 #include "ShaderClass.hpp"
 #include "geom/mesh.hpp"
 #include "render/mesh_renderer.hpp"
+#include "render/variable_rate.hpp"
 #include "tests/Test.hpp"
 
 namespace test {
@@ -18,6 +19,12 @@ class TestSdfBlend : public Test {
   void OnExit() override;
 
  private:
+  // shader 非同步 compile 完後設定固定的 uniform
+  void setupShaders();
+
+  float screenWidth;
+  float screenHeight;
+  bool shadersReady = false;
   gfx::render::MeshRenderer renderer;
   std::unique_ptr<Shader> shaderSDF;
   std::unique_ptr<Shader> shaderModel;
@@ -29,8 +36,14 @@ class TestSdfBlend : public Test {
   bool isSphere = true;
   bool isShowModel = true;
   float size = 1.0f;
+  int steps = 256;  // ray march 步數，以 define 傳給 shader
   float sdfColor[3] = {0.0f, 0.5f, 1.0f};    // blue
   float modelColor[3] = {1.0f, 0.5f, 0.0f};  // orange
+  // variable rate：先以 1/rateScale 解析度 march，全解析度只在輪廓與亮度變化大的地方重新 march
+  bool useVariableRate = false;
+  int rateScale = 2;
+  float colorEdge = 0.1f;
+  gfx::render::VariableRateRenderer variableRate;
   std::unique_ptr<CameraEventListener> listener;
 };
 
@@ -4,6 +4,7 @@
 #include "ShaderClass.hpp"
 #include "geom/mesh.hpp"
 #include "render/mesh_renderer.hpp"
+#include "render/variable_rate.hpp"
 #include "tests/Test.hpp"
 
 namespace test {
@@ -18,15 +19,26 @@ class TestSdfTaipei101 : public Test {
   void OnExit() override;
 
  private:
+  // shader 非同步 compile 完後設定固定的 uniform
+  void setupShaders();
+
+  float screenWidth;
+  float screenHeight;
+  bool shadersReady = false;
   gfx::render::MeshRenderer renderer;
   std::unique_ptr<Shader> shaderSDF;
   std::unique_ptr<gfx::geom::Mesh> sdfMesh;
-  std::unique_ptr<gfx::resource::Texture> texture;
-  std::unique_ptr<gfx::resource::Texture> texture_bump;
+  std::shared_ptr<gfx::resource::Texture> texture;
+  std::shared_ptr<gfx::resource::Texture> texture_bump;
   float lightPos[3] = {4.0f, 10.0f, 3.0f};
   bool isLightMove = true;
   float size = 1.0f;
   float sdfColor[3] = {0.1f, 0.1f, 1.0f};  // blue
+  // variable rate：先以 1/rateScale 解析度 march，全解析度只在輪廓與亮度變化大的地方重新 march
+  bool useVariableRate = false;
+  int rateScale = 2;
+  float colorEdge = 0.1f;
+  gfx::render::VariableRateRenderer variableRate;
   std::unique_ptr<CameraEventListener> listener;
 };
 
@@ -12,10 +12,11 @@ void main() {
   vec4 newColor = texture(newFrame, TexCoord);
 
   if (numFrames < 0) {
-    FragColor = oldColor;
+    FragColor = vec4(oldColor.rgb, 1.0);
     return;
   }
-  // accumulate the color
+  // accumulate the color, alpha accumulates the squared luminance so the denoiser can estimate the variance
   float weight = 1.0 / float(numFrames + 1);
-  FragColor = mix(oldColor, newColor, weight);
+  float luminance = dot(newColor.rgb, vec3(0.2126, 0.7152, 0.0722));
+  FragColor = mix(oldColor, vec4(newColor.rgb, luminance * luminance), weight);
 }
@@ -0,0 +1,78 @@
+#version 330 core
+
+// Denoiser pass 2, run several times with stepSize 1, 2, 4...: edge-avoiding à-trous wavelet filter (SVGF)
+// 5x5 B3-spline taps spread stepSize pixels apart, weighted by how alike the tap is to the center:
+// - normal: dot(n, n') ^ sigmaNormal
+// - depth: difference relative to what the local depth gradient predicts over that offset
+// - luminance: difference relative to the standard deviation, so converged pixels are barely touched
+// The variance in alpha is filtered with the squared weights and feeds the next iteration
+#include "shaders/denoise_common.glsl"
+
+out vec4 FragColor;
+
+uniform sampler2D colorTex;  // rgb lighting, a variance
+uniform sampler2D normalDepthTex;
+uniform int stepSize;
+uniform float sigmaLuminance;
+uniform float sigmaNormal;
+uniform float sigmaDepth;
+
+const float kernel[3] = float[](3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f);
+
+// 3x3 Gaussian of the variance, a single pixel's estimate is too noisy to steer the luminance weight
+float filteredVariance(ivec2 p, ivec2 size) {
+  const float gaussian[2] = float[](1.0f / 2.0f, 1.0f / 4.0f);
+  float sum = 0.0f;
+  for (int y = -1; y <= 1; y++) {
+    for (int x = -1; x <= 1; x++) {
+      ivec2 q = clamp(p + ivec2(x, y), ivec2(0), size - 1);
+      sum += texelFetch(colorTex, q, 0).a * gaussian[abs(x)] * gaussian[abs(y)];
+    }
+  }
+  return sum;
+}
+
+void main() {
+  ivec2 p = ivec2(gl_FragCoord.xy);
+  ivec2 size = textureSize(colorTex, 0);
+  vec4 center = texelFetch(colorTex, p, 0);
+  vec4 normalDepth = texelFetch(normalDepthTex, p, 0);
+  if (normalDepth.w <= 0.0f) {  // background, nothing to filter against
+    FragColor = center;
+    return;
+  }
+
+  // central differences of the hit distance, the expected change per pixel on this surface
+  vec2 depthGradient = 0.5f * vec2(texelFetch(normalDepthTex, clamp(p + ivec2(1, 0), ivec2(0), size - 1), 0).w -
+                                       texelFetch(normalDepthTex, clamp(p - ivec2(1, 0), ivec2(0), size - 1), 0).w,
+                                   texelFetch(normalDepthTex, clamp(p + ivec2(0, 1), ivec2(0), size - 1), 0).w -
+                                       texelFetch(normalDepthTex, clamp(p - ivec2(0, 1), ivec2(0), size - 1), 0).w);
+  float centerLuminance = luminance(center.rgb);
+  float phiLuminance = sigmaLuminance * sqrt(max(filteredVariance(p, size), 0.0f)) + 1e-4f;
+
+  float sumWeight = kernel[0] * kernel[0];
+  vec3 sumColor = center.rgb * sumWeight;
+  float sumVariance = center.a * sumWeight * sumWeight;
+  for (int y = -2; y <= 2; y++) {
+    for (int x = -2; x <= 2; x++) {
+      if (x == 0 && y == 0) continue;
+      ivec2 offset = ivec2(x, y) * stepSize;
+      ivec2 q = p + offset;
+      if (any(lessThan(q, ivec2(0))) || any(greaterThanEqual(q, size))) continue;
+      vec4 sampleNormalDepth = texelFetch(normalDepthTex, q, 0);
+      if (sampleNormalDepth.w <= 0.0f) continue;
+      vec4 sampleColor = texelFetch(colorTex, q, 0);
+
+      float wNormal = pow(max(dot(normalDepth.xyz, sampleNormalDepth.xyz), 0.0f), sigmaNormal);
+      float expectedDepth = abs(dot(depthGradient, vec2(offset)));
+      float wDepth = exp(-abs(normalDepth.w - sampleNormalDepth.w) / (sigmaDepth * expectedDepth + 1e-3f));
+      float wLuminance = exp(-abs(centerLuminance - luminance(sampleColor.rgb)) / phiLuminance);
+      float w = kernel[abs(x)] * kernel[abs(y)] * wNormal * wDepth * wLuminance;
+
+      sumColor += sampleColor.rgb * w;
+      sumVariance += sampleColor.a * w * w;
+      sumWeight += w;
+    }
+  }
+  FragColor = vec4(sumColor / sumWeight, sumVariance / (sumWeight * sumWeight));
+}
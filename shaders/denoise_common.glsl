@@ -0,0 +1,8 @@
+#pragma once
+
+// Shared by the denoise_*_frag.glsl passes (gfx::render::Denoiser)
+
+float luminance(vec3 c) { return dot(c, vec3(0.2126f, 0.7152f, 0.0722f)); }
+
+// Albedo the lighting is divided by; clamped so dark surfaces do not blow the lighting up
+vec3 demodulationAlbedo(vec3 albedo) { return max(albedo, vec3(0.01f)); }
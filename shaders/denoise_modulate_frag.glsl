@@ -0,0 +1,15 @@
+#version 330 core
+
+// Denoiser pass 3: multiply the filtered lighting by the primary albedo again
+#include "shaders/denoise_common.glsl"
+
+out vec4 FragColor;
+
+uniform sampler2D colorTex;  // rgb filtered lighting
+uniform sampler2D albedoTex;
+
+void main() {
+  ivec2 p = ivec2(gl_FragCoord.xy);
+  vec3 albedo = demodulationAlbedo(texelFetch(albedoTex, p, 0).rgb);
+  FragColor = vec4(texelFetch(colorTex, p, 0).rgb * albedo, 1.0f);
+}
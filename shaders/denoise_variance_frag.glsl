@@ -0,0 +1,55 @@
+#version 330 core
+
+// Denoiser pass 1: demodulate the accumulated color by the primary albedo and estimate its variance
+// Output: rgb lighting, a variance of the lighting's luminance (of the mean, not of a single sample)
+#include "shaders/denoise_common.glsl"
+
+out vec4 FragColor;
+
+uniform sampler2D colorTex;  // rgb mean color, a mean squared luminance
+uniform sampler2D albedoTex;
+uniform sampler2D normalDepthTex;
+uniform int sampleCount;       // frames accumulated in colorTex
+uniform sampler2D historyTex;  // r per-pixel frame count (temporal_accumulate_frag.glsl)
+uniform bool perPixelHistory;  // use historyTex instead of sampleCount
+
+// Fewer frames than this and the temporal moments are too noisy, the variance comes from the neighborhood instead
+#define MIN_TEMPORAL_SAMPLES 4
+
+void main() {
+  ivec2 p = ivec2(gl_FragCoord.xy);
+  vec4 color = texelFetch(colorTex, p, 0);
+  vec3 albedo = demodulationAlbedo(texelFetch(albedoTex, p, 0).rgb);
+  vec3 lighting = color.rgb / albedo;
+  float albedoLuminance = max(luminance(albedo), 0.01f);
+
+  int samples = perPixelHistory ? max(int(texelFetch(historyTex, p, 0).r), 1) : sampleCount;
+
+  float variance;
+  if (samples >= MIN_TEMPORAL_SAMPLES) {
+    float mean = luminance(color.rgb);
+    variance = max(color.a - mean * mean, 0.0f) / float(samples);
+  } else {
+    // 3x3 moments over neighbors on the same surface
+    vec3 normal = texelFetch(normalDepthTex, p, 0).xyz;
+    ivec2 size = textureSize(colorTex, 0);
+    float m1 = 0.0f;
+    float m2 = 0.0f;
+    float weight = 0.0f;
+    for (int y = -1; y <= 1; y++) {
+      for (int x = -1; x <= 1; x++) {
+        ivec2 q = clamp(p + ivec2(x, y), ivec2(0), size - 1);
+        float w = x == 0 && y == 0 ? 1.0f : max(dot(normal, texelFetch(normalDepthTex, q, 0).xyz), 0.0f);
+        float l = luminance(texelFetch(colorTex, q, 0).rgb);
+        m1 += l * w;
+        m2 += l * l * w;
+        weight += w;
+      }
+    }
+    m1 /= weight;
+    m2 /= weight;
+    // the neighbors are single-frame samples too, boost it a little like SVGF does for short histories
+    variance = max(m2 - m1 * m1, 0.0f) * float(MIN_TEMPORAL_SAMPLES) / float(samples);
+  }
+  FragColor = vec4(lighting, variance / (albedoLuminance * albedoLuminance));
+}
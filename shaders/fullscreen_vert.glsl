@@ -0,0 +1,10 @@
+#version 330 core
+
+// Fullscreen triangle from gl_VertexID, draw 3 vertices with an empty VAO (no vertex buffer)
+out vec2 TexCoord;
+
+void main() {
+  vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+  TexCoord = p;
+  gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
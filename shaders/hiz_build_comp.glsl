@@ -0,0 +1,44 @@
+#version 430 core
+
+// Hi-Z pyramid：每個 texel 存下一層對應區域的最大 depth（最遠）
+// reduce = false 時直接從 depth buffer 複製到 level 0
+layout(local_size_x = 8, local_size_y = 8) in;
+
+uniform sampler2D srcTex;
+uniform int srcLevel;
+uniform bool reduce;
+layout(r32f, binding = 0) writeonly uniform image2D dstImage;
+
+void main() {
+  ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+  ivec2 dstSize = imageSize(dstImage);
+  if (any(greaterThanEqual(p, dstSize))) return;
+
+  if (!reduce) {
+    imageStore(dstImage, p, vec4(texelFetch(srcTex, p, 0).r));
+    return;
+  }
+
+  ivec2 srcSize = textureSize(srcTex, srcLevel);
+  ivec2 s = p * 2;
+  ivec2 sMax = srcSize - 1;
+  float d = max(max(texelFetch(srcTex, min(s, sMax), srcLevel).r,
+                    texelFetch(srcTex, min(s + ivec2(1, 0), sMax), srcLevel).r),
+                max(texelFetch(srcTex, min(s + ivec2(0, 1), sMax), srcLevel).r,
+                    texelFetch(srcTex, min(s + ivec2(1, 1), sMax), srcLevel).r));
+
+  // 上一層是奇數尺寸時，最後一行/列多出來的 texel 併進邊上的 texel，保持保守
+  bool extraX = (srcSize.x & 1) != 0 && p.x == dstSize.x - 1;
+  bool extraY = (srcSize.y & 1) != 0 && p.y == dstSize.y - 1;
+  if (extraX) {
+    d = max(d, texelFetch(srcTex, min(s + ivec2(2, 0), sMax), srcLevel).r);
+    d = max(d, texelFetch(srcTex, min(s + ivec2(2, 1), sMax), srcLevel).r);
+  }
+  if (extraY) {
+    d = max(d, texelFetch(srcTex, min(s + ivec2(0, 2), sMax), srcLevel).r);
+    d = max(d, texelFetch(srcTex, min(s + ivec2(1, 2), sMax), srcLevel).r);
+  }
+  if (extraX && extraY) d = max(d, texelFetch(srcTex, min(s + ivec2(2, 2), sMax), srcLevel).r);
+
+  imageStore(dstImage, p, vec4(d));
+}
@@ -0,0 +1,42 @@
+#version 430 core
+
+// 每個 invocation 測一個 instance 的 bounding sphere，可見的寫進 compact buffer
+// commands[0].instanceCount 當作 counter，其餘 command 用 atomicMax 同步成相同數量
+layout(local_size_x = 64) in;
+
+struct DrawElementsIndirectCommand {
+  uint count;
+  uint instanceCount;
+  uint firstIndex;
+  int baseVertex;
+  uint baseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceIn { mat4 instances[]; };
+layout(std430, binding = 1) writeonly buffer InstanceOut { mat4 visibleInstances[]; };
+layout(std430, binding = 2) buffer DrawCommands { DrawElementsIndirectCommand commands[]; };
+
+uniform uint instanceCount;
+uniform uint commandCount;
+uniform vec4 frustumPlanes[6];
+uniform vec4 boundingSphere;  // xyz: local center, w: local radius
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  if (i >= instanceCount) return;
+
+  mat4 m = instances[i];
+  vec3 center = (m * vec4(boundingSphere.xyz, 1.0)).xyz;
+  float scale2 = max(dot(m[0].xyz, m[0].xyz), max(dot(m[1].xyz, m[1].xyz), dot(m[2].xyz, m[2].xyz)));
+  float radius = boundingSphere.w * sqrt(scale2);
+
+  for (int p = 0; p < 6; p++) {
+    if (dot(frustumPlanes[p].xyz, center) + frustumPlanes[p].w < -radius) return;
+  }
+
+  uint slot = atomicAdd(commands[0].instanceCount, 1u);
+  visibleInstances[slot] = m;
+  for (uint k = 1u; k < commandCount; k++) {
+    atomicMax(commands[k].instanceCount, slot + 1u);
+  }
+}
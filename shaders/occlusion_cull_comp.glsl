@@ -0,0 +1,110 @@
+#version 430 core
+
+// 兩階段 occlusion culling（每個 invocation 一個物件，bounds 為 world space AABB）
+// early：畫上一幀可見、且在 frustum 內的物件
+// late ：用 early 畫完的 depth 建的 Hi-Z 測全部物件，只補畫 early 漏掉的，並更新 visibility 給下一幀
+layout(local_size_x = 64) in;
+
+struct DrawElementsIndirectCommand {
+  uint count;
+  uint instanceCount;
+  uint firstIndex;
+  int baseVertex;
+  uint baseInstance;
+};
+
+struct ObjectBounds {
+  vec4 aabbMin;
+  vec4 aabbMax;
+};
+
+layout(std430, binding = 0) readonly buffer Objects { ObjectBounds objects[]; };
+layout(std430, binding = 1) buffer Visibility { uint visibility[]; };
+layout(std430, binding = 2) buffer DrawCommands { DrawElementsIndirectCommand commands[]; };
+layout(std430, binding = 3) buffer Stats {
+  uint drawnEarly;
+  uint drawnLate;
+  uint occluded;
+};
+
+uniform uint objectCount;
+uniform bool latePhase;
+uniform bool occlusionEnabled;
+uniform mat4 viewProj;
+uniform vec4 frustumPlanes[6];
+uniform sampler2D depthPyramid;
+
+bool frustumVisible(vec3 bmin, vec3 bmax) {
+  for (int p = 0; p < 6; p++) {
+    vec4 plane = frustumPlanes[p];
+    vec3 v = mix(bmin, bmax, greaterThanEqual(plane.xyz, vec3(0.0)));
+    if (dot(plane.xyz, v) + plane.w < 0.0) return false;
+  }
+  return true;
+}
+
+// 有任何角點在相機後面就無法投影，直接當作可見
+bool hizOccluded(vec3 bmin, vec3 bmax) {
+  vec2 uvMin = vec2(1.0), uvMax = vec2(0.0);
+  float minDepth = 1.0;
+  for (int i = 0; i < 8; i++) {
+    vec3 corner = vec3((i & 1) != 0 ? bmax.x : bmin.x, (i & 2) != 0 ? bmax.y : bmin.y, (i & 4) != 0 ? bmax.z : bmin.z);
+    vec4 clip = viewProj * vec4(corner, 1.0);
+    if (clip.w <= 0.0) return false;
+    vec3 ndc = clip.xyz / clip.w;
+    vec2 uv = ndc.xy * 0.5 + 0.5;
+    uvMin = min(uvMin, uv);
+    uvMax = max(uvMax, uv);
+    minDepth = min(minDepth, ndc.z * 0.5 + 0.5);
+  }
+  uvMin = clamp(uvMin, 0.0, 1.0);
+  uvMax = clamp(uvMax, 0.0, 1.0);
+
+  // 選一個讓 rect 只跨 1~2 個 texel 的 level
+  ivec2 size0 = textureSize(depthPyramid, 0);
+  ivec2 lo = min(ivec2(uvMin * vec2(size0)), size0 - 1);
+  ivec2 hi = min(ivec2(uvMax * vec2(size0)), size0 - 1);
+  int levels = textureQueryLevels(depthPyramid);
+  int level = 0;
+  while (level < levels - 1 && (hi.x - lo.x > 1 || hi.y - lo.y > 1)) {
+    level++;
+    // 與 hiz_build 的 reduction 一致：奇數尺寸時最後一個 texel 併入前一個
+    ivec2 size = textureSize(depthPyramid, level);
+    lo = min(lo / 2, size - 1);
+    hi = min(hi / 2, size - 1);
+  }
+
+  float maxDepth = 0.0;
+  for (int y = lo.y; y <= hi.y; y++) {
+    for (int x = lo.x; x <= hi.x; x++) {
+      maxDepth = max(maxDepth, texelFetch(depthPyramid, ivec2(x, y), level).r);
+    }
+  }
+  return minDepth > maxDepth;
+}
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  if (i >= objectCount) return;
+
+  vec3 bmin = objects[i].aabbMin.xyz;
+  vec3 bmax = objects[i].aabbMax.xyz;
+  bool inFrustum = frustumVisible(bmin, bmax);
+  bool drawnInEarly = inFrustum && visibility[i] != 0u;
+
+  if (!latePhase) {
+    commands[i].instanceCount = drawnInEarly ? 1u : 0u;
+    if (drawnInEarly) atomicAdd(drawnEarly, 1u);
+    return;
+  }
+
+  bool visible = inFrustum;
+  if (visible && occlusionEnabled && hizOccluded(bmin, bmax)) {
+    visible = false;
+    atomicAdd(occluded, 1u);
+  }
+  bool drawNow = visible && !drawnInEarly;
+  commands[i].instanceCount = drawNow ? 1u : 0u;
+  if (drawNow) atomicAdd(drawnLate, 1u);
+  visibility[i] = visible ? 1u : 0u;
+}
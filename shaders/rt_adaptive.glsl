@@ -0,0 +1,35 @@
+#pragma once
+
+// Adaptive sampling for the progressive path tracer: a pixel whose accumulated mean is already precise stops
+// tracing, it writes ADAPTIVE_SKIPPED and the temporal accumulation keeps its history as is
+// The estimate comes from the accumulation target of temporal_accumulate_frag.glsl: rgb mean, a mean squared
+// luminance and the per-pixel frame count
+
+#define ADAPTIVE_SKIPPED -1.0f  // alpha of fragColor
+
+uniform bool adaptiveSampling = false;
+uniform sampler2D adaptiveColor;
+uniform sampler2D adaptiveLength;
+uniform float adaptiveThreshold = 0.02f;  // relative standard error of the mean luminance
+uniform float adaptiveMinFrames = 16.0f;  // too few frames and the variance itself is unreliable
+
+float relativeError(ivec2 p) {
+  float frames = texelFetch(adaptiveLength, p, 0).r;
+  if (frames < adaptiveMinFrames) return 1e30f;
+  vec4 color = texelFetch(adaptiveColor, p, 0);
+  float mean = dot(color.rgb, vec3(0.2126f, 0.7152f, 0.0722f));
+  float variance = max(color.a - mean * mean, 0.0f) / frames;
+  return sqrt(variance) / (mean + 0.01f);  // the offset lets almost black pixels converge too
+}
+
+bool pixelConverged(ivec2 p) {
+  if (!adaptiveSampling) return false;
+  // the 4 neighbors too: a pixel with a lucky streak of similar samples keeps going while its area is still noisy
+  ivec2 size = textureSize(adaptiveColor, 0);
+  float error = relativeError(p);
+  error = max(error, relativeError(clamp(p + ivec2(1, 0), ivec2(0), size - 1)));
+  error = max(error, relativeError(clamp(p - ivec2(1, 0), ivec2(0), size - 1)));
+  error = max(error, relativeError(clamp(p + ivec2(0, 1), ivec2(0), size - 1)));
+  error = max(error, relativeError(clamp(p - ivec2(0, 1), ivec2(0), size - 1)));
+  return error < adaptiveThreshold;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// Pinhole camera of the path tracers, shared with the motion-vector pass (temporal_motion_frag.glsl)
+// Needs the `resolution` and `fov` uniforms declared by the including shader
+
+// Rows are the camera's right, up and forward axes in world space
+mat3 cameraBasis(mat4 view) {
+  mat3 basis = mat3(view);
+  basis[0][2] = -basis[0][2];
+  basis[1][2] = -basis[1][2];
+  basis[2][2] = -basis[2][2];
+  return basis;
+}
+
+float cameraFocalLength() { return 1.0 / tan(radians(fov) / 2.0); }
+
+// Ray direction through pixel coordinate p (gl_FragCoord convention, pixel centers at +0.5)
+vec3 cameraRayDirection(vec2 p, mat4 view) {
+  vec2 uv = (2.0 * p - resolution) / resolution.y;  // center origin point to the center of the screen
+  return inverse(cameraBasis(view)) * normalize(vec3(uv, cameraFocalLength()));
+}
+
+// Inverse of cameraRayDirection: pixel coordinate of offset v from the camera in xy, view depth in z (<= 0 behind)
+vec3 cameraProject(vec3 v, mat4 view) {
+  vec3 local = cameraBasis(view) * v;
+  vec2 uv = local.xy * cameraFocalLength() / local.z;
+  return vec3((uv * resolution.y + resolution) * 0.5, local.z);
+}
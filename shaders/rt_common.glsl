@@ -0,0 +1,182 @@
+#pragma once
+
+// Shared by the rt_sphere fragment shaders and the rt_wf_* compute passes:
+// settings, scene structs, RNG / samplers, camera rays and ray-primitive intersection
+
+uniform float fov;  // eg. 45.0 degrees
+uniform uint frameIdx = 1u;
+uniform vec2 resolution;
+uniform vec3 camPosition;
+uniform mat4 viewMatrix;
+
+#include "shaders/rt_camera.glsl"
+
+// Ray tracing settings
+/*
+Feature switches are compile-time defines (see ShaderPermutations on the C++ side), one program per combination,
+so the inner path-tracing loop has no runtime branches on them:
+  SPECULAR_BOUNCE, SPECULAR_WHITE, SHOW_SPHERE_LIGHT, SHOW_CORNELL_PLANES, SHOW_CORNELL_LIGHT
+NUM_BOUNCES / NUM_RAYS are constant loop bounds so the compiler can unroll them.
+RR_START_BOUNCE is the first bounce where Russian roulette may end a path.
+*/
+#ifndef NUM_BOUNCES
+#define NUM_BOUNCES 2
+#endif
+#ifndef NUM_RAYS
+#define NUM_RAYS 1
+#endif
+#ifndef RR_START_BOUNCE
+#define RR_START_BOUNCE 2
+#endif
+#define PI 3.14159265359
+uniform float ambientLight = 0.0f;
+
+struct Material {             // 48 bytes
+  vec4 color;                 // 16 bytes
+  vec4 emissionColor;         // 16 bytes
+  float shininess;            // 4 bytes
+  float smoothness;           // 4 bytes
+  float specularProbability;  // 4 bytes
+  float padding;              // 4 bytes
+};
+
+struct Sphere {
+  vec3 center;        // 12 bytes
+  float radius;       // 4 bytes
+  Material material;  // 48 bytes
+};
+
+struct Triangle {
+  vec3 posA;       // 12 bytes
+  float padding1;  // 4 bytes
+  vec3 posB;       // 12 bytes
+  float padding2;  // 4 bytes
+  vec3 posC;       // 12 bytes
+  float padding3;  // 4 bytes
+  vec3 normal;     // 12 bytes
+  float padding4;  // 4 bytes
+  // Material properties
+  Material material;  // 48 bytes
+};
+
+struct HitInfo {
+  bool didHit;
+  float dst;
+  vec3 hitPos;
+  vec3 normal;
+  Material material;
+  int primitive;  // >= 0: triangle index, < 0: sphere -(index + 1)
+};
+
+/*
+  Copy from
+  github.com/SebLague/Ray-Tracing/blob/main/Assets/Scripts/Shaders/RayTracer.shader
+*/
+float rand(inout uint state) {
+  state = (frameIdx * 719413u + state) * 747796405u + 2891336453u;
+  uint result = ((state >> ((state >> 28) + 4u)) ^ state) * 277803737u;
+  result = (result >> 22) ^ result;
+  return result / 4294967295.0;  // 2^32 - 1;
+}
+
+#include "shaders/rt_sampler.glsl"
+
+// Cosine-weighted direction in the hemisphere around normal, pdf = cos(theta) / PI
+// Importance sampling for a Lambert BRDF: the cosine and the BRDF's 1 / PI cancel, the weight is just the albedo
+vec3 cosineSampleHemisphere(vec3 normal, inout uint state) {
+  vec2 uv = sample2D(state);
+  float u = uv.x;
+  float v = uv.y;
+  float r = sqrt(u);
+  float phi = 2.0f * PI * v;
+  vec3 tangent = normalize(cross(abs(normal.x) > 0.5f ? vec3(0.0f, 1.0f, 0.0f) : vec3(1.0f, 0.0f, 0.0f), normal));
+  vec3 bitangent = cross(normal, tangent);
+  return normalize(tangent * (r * cos(phi)) + bitangent * (r * sin(phi)) + normal * sqrt(max(0.0f, 1.0f - u)));
+}
+
+// Russian roulette from RR_START_BOUNCE on: dim paths stop early, survivors are scaled up to stay unbiased
+bool russianRoulette(inout vec3 throughput, int bounce, inout uint state) {
+  if (bounce < RR_START_BOUNCE) return true;
+  float survival = clamp(max(throughput.r, max(throughput.g, throughput.b)), 0.05f, 1.0f);
+  if (sample1D(state) >= survival) return false;
+  throughput /= survival;
+  return true;
+}
+
+HitInfo raySphere(vec3 ro, vec3 rd, vec3 sphereCenter, float sphereRadius) {
+  HitInfo hitInfo;
+  hitInfo.didHit = false;
+  hitInfo.dst = 0.0f;
+  hitInfo.hitPos = vec3(0.0f);
+  hitInfo.normal = vec3(0.0f);
+  hitInfo.material.color = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+  vec3 oc = ro - sphereCenter;
+  float a = dot(rd, rd);
+  float b = 2.0f * dot(oc, rd);
+  float c = dot(oc, oc) - sphereRadius * sphereRadius;
+  float discriminant = b * b - 4.0f * a * c;
+
+  if (discriminant > 0.0f) {
+    float dist = (-b - sqrt(discriminant)) / (2.0f * a);
+    if (dist > 0.0f) {
+      hitInfo.didHit = true;
+      hitInfo.dst = dist;
+      hitInfo.hitPos = ro + rd * dist;
+      hitInfo.normal = (hitInfo.hitPos - sphereCenter) / sphereRadius;
+    }
+  }
+
+  return hitInfo;
+}
+
+// Möller–Trumbore algorithm
+HitInfo rayTriangle(vec3 ro, vec3 rd, Triangle triangle) {
+  HitInfo hitInfo;
+  hitInfo.didHit = false;
+  hitInfo.dst = 0.0f;
+  hitInfo.hitPos = vec3(0.0f);
+  hitInfo.normal = vec3(0.0f);
+  hitInfo.material.color = vec4(0.0f, 0.0f, 0.0f, 1.0f);  // black
+
+  vec3 edge1 = triangle.posB - triangle.posA;
+  vec3 edge2 = triangle.posC - triangle.posA;
+  vec3 h = cross(rd, edge2);
+  float a = dot(edge1, h);
+  // Check if the ray is parallel to the triangle
+  if (a > -0.00001f && a < 0.00001f) {
+    return hitInfo;
+  }
+
+  // Backface culling: check if the ray is hitting the back of the triangle
+  vec3 normal = triangle.normal;
+  if (dot(rd, normal) > 0.0f) {
+    return hitInfo;  // ray is coming from the back
+  }
+
+  float f = 1.0f / a;
+  vec3 s = ro - triangle.posA;
+  float u = f * dot(s, h);
+  if (u < 0.0f || u > 1.0f) {
+    return hitInfo;
+  }
+
+  vec3 q = cross(s, edge1);
+  float v = f * dot(rd, q);
+  if (v < 0.0f || u + v > 1.0f) {
+    return hitInfo;
+  }
+
+  float t = f * dot(edge2, q);
+  if (t > 0.00001f) {
+    hitInfo.didHit = true;
+    hitInfo.dst = t;
+    hitInfo.hitPos = ro + rd * t;
+    hitInfo.normal = triangle.normal;
+  }
+
+  return hitInfo;
+}
+
+// Primary ray direction through pixel coordinate p (gl_FragCoord convention, pixel centers at +0.5)
+vec3 cameraRay(vec2 p) { return cameraRayDirection(p, viewMatrix); }
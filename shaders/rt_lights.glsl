@@ -0,0 +1,101 @@
+#pragma once
+
+// Emissive primitives as explicit light sources (next event estimation), combined with BSDF sampling by MIS
+// Needs sphereList / triangleList from the including scene file
+// Primitive ids use the HitInfo encoding: >= 0 triangle index, < 0 sphere -(index + 1)
+
+// The C++ side lists every visible primitive with shininess > 0, a light missing here would be under-counted
+#ifndef MAX_LIGHTS
+#define MAX_LIGHTS 64
+#endif
+uniform int lightCount = 0;
+uniform int lightList[MAX_LIGHTS];
+
+struct LightSample {
+  vec3 position;
+  vec3 normal;
+  vec3 emission;  // radiance leaving the surface
+  float area;     // the sample is uniform over the primitive's area, pdf = 1 / area
+};
+
+Material primitiveMaterial(int primitive) {
+  return primitive >= 0 ? triangleList[primitive].material : sphereList[-primitive - 1].material;
+}
+
+// Only the shininess part counts as a light; ambientLight is added on every hit and has no position to sample
+vec3 primitiveEmission(Material material) { return material.emissionColor.rgb * material.shininess; }
+
+float primitiveArea(int primitive) {
+  if (primitive < 0) {
+    float radius = sphereList[-primitive - 1].radius;
+    return 4.0f * PI * radius * radius;
+  }
+  Triangle triangle = triangleList[primitive];
+  return 0.5f * length(cross(triangle.posB - triangle.posA, triangle.posC - triangle.posA));
+}
+
+LightSample sampleLight(int primitive, inout uint state) {
+  LightSample s;
+  vec2 uv = sample2D(state);
+  float u = uv.x;
+  float v = uv.y;
+  if (primitive < 0) {
+    Sphere sphere = sphereList[-primitive - 1];
+    float z = 1.0f - 2.0f * u;
+    float r = sqrt(max(0.0f, 1.0f - z * z));
+    float phi = 2.0f * PI * v;
+    s.normal = vec3(r * cos(phi), r * sin(phi), z);
+    s.position = sphere.center + sphere.radius * s.normal;
+    s.emission = primitiveEmission(sphere.material);
+  } else {
+    Triangle triangle = triangleList[primitive];
+    float su = sqrt(u);
+    float b0 = 1.0f - su;
+    float b1 = v * su;
+    s.position = triangle.posA * b0 + triangle.posB * b1 + triangle.posC * (1.0f - b0 - b1);
+    s.normal = triangle.normal;
+    s.emission = primitiveEmission(triangle.material);
+  }
+  s.area = primitiveArea(primitive);
+  return s;
+}
+
+// Power heuristic (beta = 2)
+float misWeight(float pdf, float otherPdf) {
+  float a = pdf * pdf;
+  float b = otherPdf * otherPdf;
+  return a + b > 0.0f ? a / (a + b) : 0.0f;
+}
+
+// Solid-angle pdf of sampleDirectLight() producing a point at distance dist whose normal makes cosLight with the ray
+float lightPdf(int primitive, float dist, float cosLight) {
+  return dist * dist / (max(cosLight, 1e-6f) * primitiveArea(primitive) * float(lightCount));
+}
+
+// MIS weight of emission found by BSDF sampling; bsdfPdf = 0 marks camera rays and specular bounces,
+// which light sampling cannot produce, so they keep the full emission
+float emissionWeight(int primitive, float bsdfPdf, float dist, vec3 rd, vec3 normal) {
+  if (bsdfPdf <= 0.0f || lightCount <= 0) return 1.0f;
+  return misWeight(bsdfPdf, lightPdf(primitive, dist, dot(normal, -rd)));
+}
+
+// One light sample for a Lambert surface: one light picked uniformly, one point uniform over its area
+// Returns the MIS-weighted contribution without path throughput (zero if the sample faces away),
+// wi / dist describe the shadow ray the caller has to test
+vec3 sampleDirectLight(vec3 pos, vec3 normal, vec3 albedo, inout uint state, out vec3 wi, out float dist) {
+  wi = normal;
+  dist = 0.0f;
+  if (lightCount <= 0) return vec3(0.0f);
+
+  int light = lightList[min(int(sample1D(state) * float(lightCount)), lightCount - 1)];
+  LightSample ls = sampleLight(light, state);
+  vec3 toLight = ls.position - pos;
+  dist = length(toLight);
+  wi = toLight / dist;
+  float cosSurface = dot(normal, wi);
+  float cosLight = dot(ls.normal, -wi);
+  if (cosSurface <= 0.0f || cosLight <= 0.0f) return vec3(0.0f);
+
+  float pdf = lightPdf(light, dist, cosLight);
+  return albedo / PI * ls.emission * cosSurface / pdf * misWeight(pdf, cosSurface / PI);
+}
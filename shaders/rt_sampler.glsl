@@ -0,0 +1,116 @@
+#pragma once
+
+// Per-pixel sample sequences for the path tracers, selected at runtime by samplerType
+// Same integer math as gfx::geom::Sampler (include/geom/sampler.hpp), the CPU side reproduces any sample bit for bit
+// - SAMPLER_RANDOM: the white-noise rand() stream
+// - SAMPLER_SOBOL: first two Sobol dimensions, Owen-scrambled with a fresh seed per dimension and pixel
+// - SAMPLER_BLUE_NOISE: a tiled blue-noise texture (tool/blue_noise), shifted per dimension,
+//   rotated per sample index by the R2 / golden-ratio sequence
+// Usage: samplerBegin() once per path, samplerSetDimension() at the start of every bounce, then sample1D / sample2D
+// Written for GLSL 3.30 (no bitfieldReverse) so the fragment tracers can use it as well
+
+#define SAMPLER_RANDOM 0
+#define SAMPLER_SOBOL 1
+#define SAMPLER_BLUE_NOISE 2
+
+// Dimensions reserved per bounce (hemisphere, specular choice, light pick, light point, Russian roulette)
+#define SAMPLER_BOUNCE_DIMENSIONS 8u
+
+uniform int samplerType = SAMPLER_RANDOM;
+uniform sampler2D blueNoiseTex;  // RGBA8, any power-of-two size
+
+uvec2 samplerPixel = uvec2(0u);
+uint samplerIndex = 0u;
+uint samplerDim = 0u;
+
+// lowbias32
+uint hashU32(uint x) {
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+uint reverseBits32(uint x) {
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+  x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+uint sobol2(uint index) {
+  uint result = 0u;
+  for (uint v = 1u << 31; index != 0u; index >>= 1, v ^= v >> 1) {
+    if ((index & 1u) != 0u) result ^= v;
+  }
+  return result;
+}
+
+uint laineKarrasPermutation(uint x, uint seed) {
+  x += seed;
+  x ^= x * 0x6c50b47cu;
+  x ^= x * 0xb82f1e52u;
+  x ^= x * 0xc7afe638u;
+  x ^= x * 0x8d22f6e6u;
+  return x;
+}
+
+uint nestedUniformScramble(uint x, uint seed) { return reverseBits32(laineKarrasPermutation(reverseBits32(x), seed)); }
+
+float toUnitFloat(uint x) { return float(x >> 8) * (1.0f / 16777216.0f); }
+
+vec2 sobolOwen2D(uint index, uint seed) {
+  index = nestedUniformScramble(index, seed);
+  uint x = nestedUniformScramble(reverseBits32(index), hashU32(seed ^ 0x2545f491u));
+  uint y = nestedUniformScramble(sobol2(index), hashU32(seed ^ 0x9e3779b9u));
+  return vec2(toUnitFloat(x), toUnitFloat(y));
+}
+
+void samplerBegin(uvec2 pixel, uint sampleIndex) {
+  samplerPixel = pixel;
+  samplerIndex = sampleIndex;
+  samplerDim = 0u;
+}
+
+void samplerSetDimension(uint dim) { samplerDim = dim; }
+
+uint samplerSeed() { return hashU32(samplerPixel.x ^ hashU32(samplerPixel.y ^ hashU32(samplerDim))); }
+
+uvec4 blueNoiseTexel() {
+  uvec2 size = uvec2(textureSize(blueNoiseTex, 0));
+  uvec2 p = (samplerPixel + uvec2(hashU32(samplerDim), hashU32(samplerDim ^ 0x9e3779b9u))) % size;
+  return uvec4(round(texelFetch(blueNoiseTex, ivec2(p), 0) * 255.0f));
+}
+
+float sample1D(inout uint state) {
+  float u;
+  if (samplerType == SAMPLER_SOBOL) {
+    u = sobolOwen2D(samplerIndex, samplerSeed()).x;
+  } else if (samplerType == SAMPLER_BLUE_NOISE) {
+    uvec4 t = blueNoiseTexel();
+    u = toUnitFloat((((samplerDim & 1u) != 0u ? t.w : t.z) << 24) + 0x800000u + samplerIndex * 2654435769u);
+  } else {
+    u = rand(state);
+  }
+  samplerDim++;
+  return u;
+}
+
+vec2 sample2D(inout uint state) {
+  vec2 u;
+  if (samplerType == SAMPLER_SOBOL) {
+    u = sobolOwen2D(samplerIndex, samplerSeed());
+  } else if (samplerType == SAMPLER_BLUE_NOISE) {
+    uvec4 t = blueNoiseTexel();
+    u.x = toUnitFloat((t.x << 24) + 0x800000u + samplerIndex * 3242174889u);
+    u.y = toUnitFloat((t.y << 24) + 0x800000u + samplerIndex * 2447445413u);
+  } else {
+    u.x = rand(state);
+    u.y = rand(state);
+  }
+  samplerDim++;
+  return u;
+}
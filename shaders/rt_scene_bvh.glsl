@@ -0,0 +1,143 @@
+#pragma once
+
+// Scene in SSBOs with a BVH built on the CPU (gfx::geom::buildBVH), requires OpenGL 4.3
+// Spheres and triangles each have their own tree; both share one node / index buffer
+// Triangle indices: [0, 12) Cornell planes, [12, 24) Cornell light, [24, ...) loaded meshes
+
+#define CORNELL_PLANES_END 12u
+#define CORNELL_LIGHT_END 24u
+// Must match gfx::geom::BVH_MAX_DEPTH
+#define BVH_STACK_SIZE 64
+#define BVH_MISS 1e30
+
+struct BVHNode {
+  vec3 boundsMin;
+  int leftOrFirst;  // inner node: left child (right child = left + 1), leaf: first entry in bvhIndices
+  vec3 boundsMax;
+  int count;  // > 0 for leaves
+};
+
+layout(std430, binding = 0) readonly buffer SphereBuffer { Sphere sphereList[]; };
+layout(std430, binding = 1) readonly buffer TriangleBuffer { Triangle triangleList[]; };
+layout(std430, binding = 2) readonly buffer NodeBuffer { BVHNode bvhNodes[]; };
+layout(std430, binding = 3) readonly buffer IndexBuffer { uint bvhIndices[]; };
+
+uniform int sphereRoot = -1;  // -1: empty tree
+uniform int triangleRoot = -1;
+
+// Slab test, returns the entry distance or BVH_MISS
+float rayAABB(vec3 ro, vec3 invRd, vec3 bmin, vec3 bmax, float tMax) {
+  vec3 t0 = (bmin - ro) * invRd;
+  vec3 t1 = (bmax - ro) * invRd;
+  vec3 tMin = min(t0, t1);
+  vec3 tFar = max(t0, t1);
+  float tNear = max(max(tMin.x, tMin.y), tMin.z);
+  float tExit = min(min(tFar.x, tFar.y), tFar.z);
+  return (tNear <= tExit && tExit > 0.0f && tNear < tMax) ? max(tNear, 0.0f) : BVH_MISS;
+}
+
+void intersectPrimitive(bool spheres, uint index, vec3 ro, vec3 rd, inout HitInfo closestHit) {
+  if (spheres) {
+#ifndef SHOW_SPHERE_LIGHT
+    if (index == 0u) return;  // index 0 is the light source
+#endif
+    Sphere sphere = sphereList[index];
+    HitInfo hitInfo = raySphere(ro, rd, sphere.center, sphere.radius);
+    if (hitInfo.didHit && hitInfo.dst < closestHit.dst) {
+      closestHit = hitInfo;
+      closestHit.material = sphere.material;
+      closestHit.primitive = -int(index) - 1;
+    }
+    return;
+  }
+#ifndef SHOW_CORNELL_PLANES
+  if (index < CORNELL_PLANES_END) return;
+#endif
+#ifndef SHOW_CORNELL_LIGHT
+  if (index >= CORNELL_PLANES_END && index < CORNELL_LIGHT_END) return;
+#endif
+  Triangle triangle = triangleList[index];
+  HitInfo hitInfo = rayTriangle(ro, rd, triangle);
+  if (hitInfo.didHit && hitInfo.dst < closestHit.dst) {
+    closestHit = hitInfo;
+    closestHit.material = triangle.material;
+    closestHit.primitive = int(index);
+  }
+}
+
+// Stack-based traversal, nearer child first; nodes farther than the current closest hit are skipped
+// anyHit: stop at the first hit (shadow rays only need visibility)
+void traverseBVH(int root, bool spheres, bool anyHit, vec3 ro, vec3 rd, inout HitInfo closestHit) {
+  if (root < 0) return;
+  vec3 invRd = 1.0f / rd;  // +-inf for axis-parallel rays, the slab test handles it
+  if (rayAABB(ro, invRd, bvhNodes[root].boundsMin, bvhNodes[root].boundsMax, closestHit.dst) == BVH_MISS) return;
+
+  int stack[BVH_STACK_SIZE];
+  float stackDist[BVH_STACK_SIZE];
+  int sp = 0;
+  int node = root;
+  while (true) {
+    BVHNode current = bvhNodes[node];
+    if (current.count > 0) {
+      for (int i = 0; i < current.count; i++) {
+        intersectPrimitive(spheres, bvhIndices[current.leftOrFirst + i], ro, rd, closestHit);
+      }
+      if (anyHit && closestHit.didHit) return;
+    } else {
+      int nearChild = current.leftOrFirst;
+      int farChild = nearChild + 1;
+      BVHNode a = bvhNodes[nearChild];
+      BVHNode b = bvhNodes[farChild];
+      float dNear = rayAABB(ro, invRd, a.boundsMin, a.boundsMax, closestHit.dst);
+      float dFar = rayAABB(ro, invRd, b.boundsMin, b.boundsMax, closestHit.dst);
+      if (dFar < dNear) {
+        int t = nearChild;
+        nearChild = farChild;
+        farChild = t;
+        float d = dNear;
+        dNear = dFar;
+        dFar = d;
+      }
+      if (dNear != BVH_MISS) {
+        if (dFar != BVH_MISS && sp < BVH_STACK_SIZE) {
+          stack[sp] = farChild;
+          stackDist[sp] = dFar;
+          sp++;
+        }
+        node = nearChild;
+        continue;
+      }
+    }
+    // pop the next node that can still be closer than the current hit
+    bool found = false;
+    while (sp > 0) {
+      sp--;
+      if (stackDist[sp] < closestHit.dst) {
+        node = stack[sp];
+        found = true;
+        break;
+      }
+    }
+    if (!found) break;
+  }
+}
+
+HitInfo calcClosestHit(vec3 ro, vec3 rd) {
+  HitInfo closestHit;
+  closestHit.didHit = false;
+  closestHit.dst = 1000000.0f;
+
+  traverseBVH(sphereRoot, true, false, ro, rd, closestHit);
+  traverseBVH(triangleRoot, false, false, ro, rd, closestHit);
+  return closestHit;
+}
+
+// True if anything is hit closer than maxDist
+bool occluded(vec3 ro, vec3 rd, float maxDist) {
+  HitInfo hit;
+  hit.didHit = false;
+  hit.dst = maxDist;
+  traverseBVH(triangleRoot, false, true, ro, rd, hit);  // the walls are the most likely occluders
+  if (!hit.didHit) traverseBVH(sphereRoot, true, true, ro, rd, hit);
+  return hit.didHit;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// Scene in fixed-size std140 UBOs, brute-force intersection of every primitive (GL 3.3 fallback)
+
+// Sphere data
+/*
+MAX_SPHERES is a compile-time constant because UBO arrays need a fixed size.
+This is the fallback for contexts without OpenGL 4.3; rt_scene_bvh.glsl uses SSBOs and a BVH instead.
+The C++ side injects MAX_SPHERES / MAX_TRIANGLES as defines so both sides stay in sync.
+*/
+#ifndef MAX_SPHERES
+#define MAX_SPHERES 50
+#endif
+uniform int numSpheres = 2;
+#ifdef SHOW_SPHERE_LIGHT
+const int FIRST_SPHERE = 0;
+#else
+const int FIRST_SPHERE = 1;  // index 0 is the light source
+#endif
+
+// Triangle data
+#ifndef MAX_TRIANGLES
+#define MAX_TRIANGLES 24  // 6 Plane (12) + 1 Light Cuboid (12)
+#endif
+#ifdef SHOW_CORNELL_PLANES
+const int FIRST_TRIANGLE = 0;
+#else
+const int FIRST_TRIANGLE = 12;
+#endif
+#ifdef SHOW_CORNELL_LIGHT
+const int END_TRIANGLE = MAX_TRIANGLES;
+#else
+const int END_TRIANGLE = MAX_TRIANGLES - 12;
+#endif
+
+/*
+  Uniform Buffer Object
+  Note: The layout(std140) is used to ensure that the data is aligned correctly
+  You have to align the data yourself, and the alignment is 16 bytes
+*/
+layout(std140) uniform sphereData { Sphere sphereList[MAX_SPHERES]; };
+layout(std140) uniform triangleData { Triangle triangleList[MAX_TRIANGLES]; };
+
+HitInfo calcClosestHit(vec3 ro, vec3 rd) {
+  HitInfo closestHit;
+  closestHit.didHit = false;
+  closestHit.dst = 1000000.0f;
+
+  // Sphere intersection
+  for (int i = FIRST_SPHERE; i < numSpheres; i++) {
+    Sphere sphere = sphereList[i];
+    HitInfo hitInfo = raySphere(ro, rd, sphere.center, sphere.radius);
+    if (hitInfo.didHit && hitInfo.dst < closestHit.dst) {
+      closestHit = hitInfo;
+      closestHit.material = sphere.material;
+      closestHit.primitive = -(i + 1);
+    }
+  }
+
+  // Triangle intersection
+  for (int i = FIRST_TRIANGLE; i < END_TRIANGLE; i++) {
+    Triangle triangle = triangleList[i];
+    HitInfo hitInfo = rayTriangle(ro, rd, triangle);
+    if (hitInfo.didHit && hitInfo.dst < closestHit.dst) {
+      closestHit = hitInfo;
+      closestHit.material = triangle.material;
+      closestHit.primitive = i;
+    }
+  }
+
+  return closestHit;
+}
+
+// True if anything is hit closer than maxDist (shadow rays)
+bool occluded(vec3 ro, vec3 rd, float maxDist) {
+  HitInfo hit = calcClosestHit(ro, rd);
+  return hit.didHit && hit.dst < maxDist;
+}
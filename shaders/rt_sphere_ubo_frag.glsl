@@ -0,0 +1,7 @@
+#version 330 core
+
+// Path tracer for contexts without OpenGL 4.3: scene in fixed-size UBOs, no BVH
+#include "shaders/rt_common.glsl"
+#include "shaders/rt_scene_ubo.glsl"
+#include "shaders/rt_lights.glsl"
+#include "shaders/rt_trace.glsl"
@@ -0,0 +1,94 @@
+#pragma once
+
+// Path tracing loop and entry point
+// The including file provides calcClosestHit() / occluded() (scene) and rt_lights.glsl
+
+layout(location = 0) out vec4 fragColor;
+// Primary-hit G-buffer for the denoiser (gfx::render::Denoiser), dropped when the target has a single attachment
+layout(location = 1) out vec4 gAlbedo;       // rgb, emitters are 1 so their light is not demodulated
+layout(location = 2) out vec4 gNormalDepth;  // xyz world normal, w hit distance (0: nothing hit)
+
+#include "shaders/rt_adaptive.glsl"
+#include "shaders/variable_rate.glsl"
+
+HitInfo primaryHit;  // first hit of the last traced path, every ray of a pixel shares it
+
+vec3 trace(vec3 ro, vec3 rd, inout uint state) {
+  vec3 incomingLight = vec3(0.0f);
+  vec3 rayColor = vec3(1.0f);
+  float bsdfPdf = 0.0f;  // pdf of the last diffuse bounce, 0 for the camera ray and specular bounces
+  for (int i = 0; i < NUM_BOUNCES; i++) {
+    HitInfo hitInfo = calcClosestHit(ro, rd);
+    if (!hitInfo.didHit) break;
+    if (i == 0) primaryHit = hitInfo;
+    samplerSetDimension(uint(i) * SAMPLER_BOUNCE_DIMENSIONS);
+    Material material = hitInfo.material;
+
+    // emitters hit by a diffuse bounce were also reachable by light sampling, MIS weights the two
+    float weight = emissionWeight(hitInfo.primitive, bsdfPdf, hitInfo.dst, rd, hitInfo.normal);
+    incomingLight += rayColor * material.emissionColor.rgb * (ambientLight + material.shininess * weight);
+
+    ro = hitInfo.hitPos;
+    vec3 diffuseDir = cosineSampleHemisphere(hitInfo.normal, state);
+    bool isSpecular = false;
+#ifdef SPECULAR_BOUNCE
+    isSpecular = sample1D(state) < material.specularProbability;
+#endif
+    if (isSpecular) {
+      rd = normalize(mix(diffuseDir, reflect(rd, hitInfo.normal), material.smoothness));
+      bsdfPdf = 0.0f;
+    } else {
+      // next event estimation: one shadow ray toward a sampled light
+      vec3 wi;
+      float dist;
+      vec3 direct = sampleDirectLight(ro, hitInfo.normal, material.color.rgb, state, wi, dist);
+      if (any(greaterThan(direct, vec3(0.0f))) && !occluded(ro, wi, dist * 0.999f)) {
+        incomingLight += rayColor * direct;
+      }
+      rd = diffuseDir;
+      bsdfPdf = dot(hitInfo.normal, diffuseDir) / PI;
+    }
+
+    // absorb the color of the surface and prepared for the next bounce
+#if defined(SPECULAR_BOUNCE) && defined(SPECULAR_WHITE)
+    rayColor *= isSpecular ? vec3(1.0f) : material.color.rgb;
+#else
+    rayColor *= material.color.rgb;  // specular and diffuse bounces both absorb the surface color
+#endif
+    if (!russianRoulette(rayColor, i, state)) break;
+  }
+  return incomingLight;
+}
+
+void main() {
+  uint state = uint(gl_FragCoord.x) + uint(gl_FragCoord.y) * uint(resolution.x);
+  vec3 rayOrigin = camPosition;
+  vec3 rayDirection = cameraRay(gl_FragCoord.xy);
+  primaryHit.didHit = false;
+
+  // the low-res pass has no accumulation of its own to judge convergence by
+  bool converged = variableRatePass != VARIABLE_RATE_LOW && pixelConverged(ivec2(gl_FragCoord.xy));
+  vec4 upsampled;
+  bool reuse = !converged && variableRatePass == VARIABLE_RATE_UPSAMPLE &&
+               variableRateUpsample(gl_FragCoord.xy, upsampled);
+  if (converged || reuse) {
+    // no paths, only the camera ray: the denoiser and the motion vectors still need the full-resolution G-buffer
+    primaryHit = calcClosestHit(rayOrigin, rayDirection);
+    fragColor = converged ? vec4(0.0f, 0.0f, 0.0f, ADAPTIVE_SKIPPED) : vec4(upsampled.rgb, 1.0f);
+  } else {
+    // split incoming light into 3 channels
+    vec3 totalIncomingLight = vec3(0.0f);
+
+    for (int i = 0; i < NUM_RAYS; i++) {
+      // sample index counts every sample of the pixel across frames, the sequence keeps stratifying while accumulating
+      samplerBegin(uvec2(gl_FragCoord.xy), frameIdx * uint(NUM_RAYS) + uint(i));
+      totalIncomingLight += trace(rayOrigin, rayDirection, state);
+    }
+
+    vec3 pixelColor = totalIncomingLight / float(NUM_RAYS);
+    fragColor = vec4(pixelColor, 1.0);
+  }
+  bool emitter = !primaryHit.didHit || primaryHit.material.shininess > 0.0f;
+  gAlbedo = vec4(emitter ? vec3(1.0f) : primaryHit.material.color.rgb, 1.0f);
+  gNormalDepth = primaryHit.didHit ? vec4(primaryHit.normal, primaryHit.dst) : vec4(0.0f);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// Wavefront path tracer state shared by the rt_wf_*_comp.glsl passes (gfx::render::WavefrontPathTracer)
+// Bindings 0-3 are the scene (rt_scene_bvh.glsl), 4 and up belong to the wavefront
+// Paths are indexed by pixel; the ray queues hold the indices of the paths that are still alive
+
+// Must match kWorkGroupSize on the C++ side
+#define WF_GROUP_SIZE 64
+
+struct PathState {
+  vec4 origin;      // xyz
+  vec4 direction;   // xyz
+  vec4 throughput;  // rgb, a: pdf of the last diffuse bounce for MIS, 0 for camera rays / specular bounces
+  vec4 radiance;    // rgb, summed over all samples of the frame
+  uint rng;
+  uint sampleIndex;  // samplerBegin() index: frameIdx * numSamples + sample
+  uint padding2;
+  uint padding3;
+};
+
+struct HitRecord {
+  vec3 normal;
+  float dst;      // < 0: miss
+  int primitive;  // see HitInfo.primitive
+  int padding1;
+  int padding2;
+  int padding3;
+};
+
+struct ShadowRay {
+  vec3 origin;
+  float dist;  // distance to the light sample, slightly shortened
+  vec3 direction;
+  uint path;
+  vec4 contribution;  // rgb, added to the path radiance if the light is visible
+};
+
+layout(std430, binding = 4) buffer PathBuffer { PathState paths[]; };
+layout(std430, binding = 5) readonly buffer RayQueueIn { uint queueIn[]; };
+layout(std430, binding = 6) writeonly buffer RayQueueOut { uint queueOut[]; };
+layout(std430, binding = 7) buffer HitBuffer { HitRecord hits[]; };
+layout(std430, binding = 8) buffer ShadowBuffer { ShadowRay shadowRays[]; };
+// rayCount[queueIndex] is the input queue of the current bounce, rayCount[queueIndex ^ 1] the output
+// shadowCount is double-buffered the same way so the next bounce can start appending before connect reads it
+layout(std430, binding = 9) buffer CounterBuffer {
+  uint rayCount[2];
+  uint shadowCount[2];
+  uvec4 rayArgs;     // glDispatchComputeIndirect arguments for extend / shade
+  uvec4 shadowArgs;  // and for connect
+};
+
+// Primary-hit G-buffer for the denoiser, same contents as gAlbedo / gNormalDepth in rt_trace.glsl
+layout(rgba32f, binding = 1) writeonly uniform image2D albedoImage;
+layout(rgba32f, binding = 2) writeonly uniform image2D normalDepthImage;
+
+uniform int queueIndex = 0;  // bounce & 1
+uniform uint pathCount;      // width * height
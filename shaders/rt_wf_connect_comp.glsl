@@ -0,0 +1,17 @@
+#version 430 core
+
+// Wavefront pass 5: visibility of the light samples; each path owns at most one shadow ray per bounce,
+// so the radiance update needs no atomics
+#include "shaders/rt_common.glsl"
+#include "shaders/rt_scene_bvh.glsl"
+#include "shaders/rt_wavefront.glsl"
+
+layout(local_size_x = WF_GROUP_SIZE) in;
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  if (i >= shadowCount[queueIndex]) return;
+
+  ShadowRay ray = shadowRays[i];
+  if (!occluded(ray.origin, ray.direction, ray.dist)) paths[ray.path].radiance.rgb += ray.contribution.rgb;
+}
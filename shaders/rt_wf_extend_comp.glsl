@@ -0,0 +1,22 @@
+#version 430 core
+
+// Wavefront pass 2: closest hit for every queued path; only traversal, no shading, so the BVH loop stays coherent
+#include "shaders/rt_common.glsl"
+#include "shaders/rt_scene_bvh.glsl"
+#include "shaders/rt_wavefront.glsl"
+
+layout(local_size_x = WF_GROUP_SIZE) in;
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  if (i >= rayCount[queueIndex]) return;
+
+  uint path = queueIn[i];
+  HitInfo hitInfo = calcClosestHit(paths[path].origin.xyz, paths[path].direction.xyz);
+
+  HitRecord record;
+  record.normal = hitInfo.normal;
+  record.dst = hitInfo.didHit ? hitInfo.dst : -1.0f;
+  record.primitive = hitInfo.primitive;
+  hits[path] = record;
+}
@@ -0,0 +1,34 @@
+#version 430 core
+
+// Wavefront pass 1: one camera ray per pixel, every path starts in the output queue of the generate step
+#include "shaders/rt_common.glsl"
+#include "shaders/rt_wavefront.glsl"
+
+layout(local_size_x = WF_GROUP_SIZE) in;
+
+uniform int sampleIndex;  // sample within this frame, the first one clears the radiance
+uniform int numSamples;  // samples per pixel per frame
+
+void main() {
+  uint pixel = gl_GlobalInvocationID.x;
+  if (pixel >= pathCount) return;
+
+  uint width = uint(resolution.x);
+  vec2 fragCoord = vec2(pixel % width, pixel / width) + 0.5;
+
+  PathState path;
+  path.origin = vec4(camPosition, 1.0f);
+  path.direction = vec4(cameraRay(fragCoord), 0.0f);
+  path.throughput = vec4(1.0f, 1.0f, 1.0f, 0.0f);
+  path.radiance = sampleIndex == 0 ? vec4(0.0f) : paths[pixel].radiance;
+  path.rng = pixel + uint(sampleIndex) * pathCount;
+  path.sampleIndex = frameIdx * uint(numSamples) + uint(sampleIndex);
+  paths[pixel] = path;
+  queueOut[pixel] = pixel;
+  // background, overwritten by the shade pass of the first bounce when the camera ray hits something
+  if (sampleIndex == 0) {
+    ivec2 p = ivec2(pixel % width, pixel / width);
+    imageStore(albedoImage, p, vec4(1.0f));
+    imageStore(normalDepthImage, p, vec4(0.0f));
+  }
+}
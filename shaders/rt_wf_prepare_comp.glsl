@@ -0,0 +1,16 @@
+#version 430 core
+
+// Wavefront pass 4 (single invocation): turns the queue sizes written by shade into indirect dispatch arguments
+// and clears the counters the next bounce appends to
+#include "shaders/rt_wavefront.glsl"
+
+layout(local_size_x = 1) in;
+
+void main() {
+  uint next = rayCount[queueIndex ^ 1];
+  uint group = uint(WF_GROUP_SIZE);
+  rayArgs = uvec4((next + group - 1u) / group, 1u, 1u, 0u);
+  shadowArgs = uvec4((shadowCount[queueIndex] + group - 1u) / group, 1u, 1u, 0u);
+  rayCount[queueIndex] = 0u;  // consumed, becomes the output queue of the next bounce
+  shadowCount[queueIndex ^ 1] = 0u;
+}
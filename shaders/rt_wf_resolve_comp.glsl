@@ -0,0 +1,18 @@
+#version 430 core
+
+// Wavefront pass 6: average the samples of the frame into the output image
+#include "shaders/rt_wavefront.glsl"
+
+layout(local_size_x = WF_GROUP_SIZE) in;
+
+uniform int numSamples;
+layout(rgba32f, binding = 0) writeonly uniform image2D outputImage;
+
+void main() {
+  uint pixel = gl_GlobalInvocationID.x;
+  if (pixel >= pathCount) return;
+
+  int width = imageSize(outputImage).x;
+  ivec2 p = ivec2(int(pixel) % width, int(pixel) / width);
+  imageStore(outputImage, p, vec4(paths[pixel].radiance.rgb / float(numSamples), 1.0f));
+}
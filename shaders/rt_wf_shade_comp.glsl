@@ -0,0 +1,110 @@
+#version 430 core
+
+// Wavefront pass 3: material evaluation for every queued path
+// - adds MIS-weighted emission, samples one light (next event estimation) and emits a shadow ray for it
+// - picks the next direction, Russian roulette; paths that keep going are compacted into the output queue
+// Queue slots are reserved once per work group (shared counter + one global atomic) instead of once per thread
+#include "shaders/rt_common.glsl"
+#include "shaders/rt_scene_bvh.glsl"
+#include "shaders/rt_lights.glsl"
+#include "shaders/rt_wavefront.glsl"
+
+layout(local_size_x = WF_GROUP_SIZE) in;
+
+uniform int bounce;
+uniform int numBounces;
+uniform int writeGBuffer;  // first bounce of the first sample
+
+shared uint groupRays;
+shared uint groupShadows;
+shared uint groupRayBase;
+shared uint groupShadowBase;
+
+void main() {
+  uint i = gl_GlobalInvocationID.x;
+  bool extend = false;
+  bool shadow = false;
+  uint path = 0u;
+  ShadowRay shadowRay;
+
+  // no early return: every invocation has to reach the barriers below
+  if (i < rayCount[queueIndex]) {
+    path = queueIn[i];
+    PathState p = paths[path];
+    HitRecord hit = hits[path];
+    if (hit.dst >= 0.0f) {
+      Material material = primitiveMaterial(hit.primitive);
+      vec3 hitPos = p.origin.xyz + p.direction.xyz * hit.dst;
+      vec3 normal = hit.normal;
+      uint state = p.rng;
+      uint width = uint(resolution.x);
+      if (writeGBuffer != 0) {
+        ivec2 pixel = ivec2(path % width, path / width);
+        imageStore(albedoImage, pixel, vec4(material.shininess > 0.0f ? vec3(1.0f) : material.color.rgb, 1.0f));
+        imageStore(normalDepthImage, pixel, vec4(normal, hit.dst));
+      }
+      samplerBegin(uvec2(path % width, path / width), p.sampleIndex);
+      samplerSetDimension(uint(bounce) * SAMPLER_BOUNCE_DIMENSIONS);
+
+      // emitters hit by a diffuse bounce were also reachable by light sampling, MIS weights the two
+      float weight = emissionWeight(hit.primitive, p.throughput.a, hit.dst, p.direction.xyz, normal);
+      p.radiance.rgb += p.throughput.rgb * material.emissionColor.rgb * (ambientLight + material.shininess * weight);
+
+      vec3 diffuseDir = cosineSampleHemisphere(normal, state);
+      vec3 nextDir = diffuseDir;
+      vec3 attenuation = material.color.rgb;
+      float bsdfPdf = 0.0f;
+      bool isSpecular = false;
+#ifdef SPECULAR_BOUNCE
+      isSpecular = sample1D(state) < material.specularProbability;
+#endif
+      if (isSpecular) {
+        nextDir = normalize(mix(diffuseDir, reflect(p.direction.xyz, normal), material.smoothness));
+#ifdef SPECULAR_WHITE
+        attenuation = vec3(1.0f);
+#endif
+      } else {
+        // next event estimation, the visibility test is deferred to the connect pass
+        vec3 wi;
+        float dist;
+        vec3 direct = sampleDirectLight(hitPos, normal, material.color.rgb, state, wi, dist);
+        if (any(greaterThan(direct, vec3(0.0f)))) {
+          shadowRay.origin = hitPos;
+          shadowRay.dist = dist * 0.999f;
+          shadowRay.direction = wi;
+          shadowRay.path = path;
+          shadowRay.contribution = vec4(p.throughput.rgb * direct, 0.0f);
+          shadow = true;
+        }
+        bsdfPdf = dot(normal, diffuseDir) / PI;
+      }
+
+      vec3 throughput = p.throughput.rgb * attenuation;
+      // terminated paths are simply not queued, the next bounce does not spend a thread on them
+      extend = bounce + 1 < numBounces && russianRoulette(throughput, bounce, state);
+      p.origin.xyz = hitPos;
+      p.direction.xyz = nextDir;
+      p.throughput = vec4(throughput, bsdfPdf);
+      p.rng = state;
+    }
+    paths[path] = p;
+  }
+
+  if (gl_LocalInvocationIndex == 0u) {
+    groupRays = 0u;
+    groupShadows = 0u;
+  }
+  barrier();
+  uint raySlot = extend ? atomicAdd(groupRays, 1u) : 0u;
+  uint shadowSlot = shadow ? atomicAdd(groupShadows, 1u) : 0u;
+  memoryBarrierShared();
+  barrier();
+  if (gl_LocalInvocationIndex == 0u) {
+    groupRayBase = groupRays > 0u ? atomicAdd(rayCount[queueIndex ^ 1], groupRays) : 0u;
+    groupShadowBase = groupShadows > 0u ? atomicAdd(shadowCount[queueIndex], groupShadows) : 0u;
+  }
+  memoryBarrierShared();
+  barrier();
+  if (extend) queueOut[groupRayBase + raySlot] = path;
+  if (shadow) shadowRays[groupShadowBase + shadowSlot] = shadowRay;
+}
@@ -1,6 +1,7 @@
 #version 330 core
 
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 FragGuide;  // variable-rate low pass only: xyz normal, w hit distance (0: miss)
 
 uniform float fov;  // eg. 45.0 degrees
 uniform vec2 resolution;
@@ -17,9 +18,14 @@ uniform mat4 viewMatrix;
 uniform bool isSphere = false;
 
 const float MAX_DIST = 500.0;
-const float STEPS = 256;
+// 可由 C++ 以 define 覆寫；compile-time 常數讓 compiler 可以展開 ray march 迴圈
+#ifndef STEPS
+#define STEPS 256
+#endif
 const float EPSILON = 0.001;
 
+#include "shaders/variable_rate.glsl"
+
 float sdfSphere(vec3 p, vec3 center, float radius) { return length(p - center) - radius; }
 
 float sdfCube(vec3 p, vec3 center, float size) {
@@ -54,6 +60,12 @@ vec3 getLight(vec3 lightSrc, vec3 p, vec3 rd, vec3 lightCol) {
 }
 
 void main() {
+  vec4 upsampled;
+  if (variableRatePass == VARIABLE_RATE_UPSAMPLE && variableRateUpsample(gl_FragCoord.xy, upsampled)) {
+    FragColor = upsampled;
+    return;
+  }
+
   vec2 uv = (2.0 * gl_FragCoord.xy - resolution) / resolution.y;  // center origin point to the center of the screen
   vec3 rayOrigin = camPosition;
   // vec3 rayDirection = normalize(vec3(uv, 1.0 / tan(radians(fov) / 2.0)));
@@ -85,8 +97,10 @@ void main() {
   {
     vec3 light = getLight(lightPosition, rayOrigin + rayDirection * t, rayDirection, lightColor);
     FragColor = vec4(sdfColor * light, 1.0);
+    FragGuide = variableRatePass == VARIABLE_RATE_LOW ? vec4(getNormal(rayOrigin + rayDirection * t), t) : vec4(0.0);
   } else  // Miss
   {
     FragColor = vec4(0.0, 0.0, 0.0, 0.0);
+    FragGuide = vec4(0.0);
   }
 }
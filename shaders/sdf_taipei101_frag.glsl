@@ -1,7 +1,8 @@
 #version 330 core
 #include "shaders/hg_sdf.glsl"
 
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 FragGuide;  // variable-rate low pass only: xyz normal, w hit distance (0: miss)
 
 uniform float fov;  // eg. 45.0 degrees
 uniform vec2 resolution;
@@ -22,8 +23,13 @@ uniform vec3 camPosition;
 uniform mat4 viewMatrix;
 uniform bool isSphere = false;
 
+#include "shaders/variable_rate.glsl"
+
 const float MAX_DIST = 100.0;
-const float STEPS = 128;
+// 可由 C++ 以 define 覆寫；compile-time 常數讓 compiler 可以展開 ray march 迴圈
+#ifndef STEPS
+#define STEPS 128
+#endif
 const float EPSILON = 0.001;
 
 // Taipei 101 constant
@@ -226,11 +232,13 @@ vec3 getLight(vec3 lightSrc, vec3 p, vec3 n, vec3 lightCol, vec3 rayDir) {
   return specular + diffuse + ambient;
 }
 
-vec3 getColor(vec3 rayOrigin, vec3 rayDirection) {
+vec3 getColor(vec3 rayOrigin, vec3 rayDirection, out vec4 guide) {
   vec2 obj = rayMarch(rayOrigin, rayDirection);
+  guide = vec4(0.0);
   if (obj.x < MAX_DIST) {                           // hit
     vec3 point = rayOrigin + rayDirection * obj.x;  // the point where the ray hits the object
     vec3 normal = getNormal(point);
+    guide = vec4(normal, obj.x);
     vec3 baseColor = getMaterial(point, obj.y, normal);  // get the color of the object
     vec3 light = getLight(lightPosition, point, normal, lightColor, rayDirection);
     // vec3 light = vec3(1.0);  // for perf
@@ -244,6 +252,12 @@ vec3 getColor(vec3 rayOrigin, vec3 rayDirection) {
 }
 
 void main() {
+  vec4 upsampled;
+  if (variableRatePass == VARIABLE_RATE_UPSAMPLE && variableRateUpsample(gl_FragCoord.xy, upsampled)) {
+    FragColor = upsampled;
+    return;
+  }
+
   vec2 uv = (2.0 * gl_FragCoord.xy - resolution) / resolution.y;  // center origin point to the center of the screen
   vec3 rayOrigin = camPosition;
 
@@ -254,7 +268,7 @@ void main() {
   newViewMatrix = inverse(newViewMatrix);
   vec3 rayDirection = newViewMatrix * normalize(vec3(uv, 1.0 / tan(radians(fov) / 2.0)));
 
-  vec3 color = getColor(rayOrigin, rayDirection);
+  vec3 color = getColor(rayOrigin, rayDirection, FragGuide);
   // gamma correction
   color = pow(color, vec3(1.0 / 2.2));
   FragColor = vec4(color, 1.0);
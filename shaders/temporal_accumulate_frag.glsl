@@ -0,0 +1,76 @@
+#version 330 core
+
+// Temporal accumulation for the path tracer: reproject last frame's accumulation along the motion vectors, clip it
+// to the current frame's neighborhood (variance clipping in YCoCg, Salvi 2016) and blend the new frame in with a
+// per-pixel running average, so the history survives camera motion instead of being reset
+#include "shaders/denoise_common.glsl"
+
+layout(location = 0) out vec4 FragColor;       // rgb mean color, a mean squared luminance (like acc_framebuffer_frag)
+layout(location = 1) out float HistoryLength;  // frames averaged into FragColor
+
+in vec2 TexCoord;
+
+uniform sampler2D newFrame;  // a < 0: adaptive sampling skipped the pixel (rt_adaptive.glsl)
+uniform sampler2D historyColor;
+uniform sampler2D historyLength;
+uniform sampler2D motionTex;  // rg uv motion, b 1 when the history is valid
+uniform float maxHistory;     // running average turns into an exponential one past this many frames
+uniform bool clipHistory;     // off while the camera and scene are still, the history is then exact
+uniform float clipGamma = 1.25f;
+
+vec3 rgbToYCoCg(vec3 c) {
+  return vec3(0.25f * c.r + 0.5f * c.g + 0.25f * c.b, 0.5f * c.r - 0.5f * c.b, -0.25f * c.r + 0.5f * c.g - 0.25f * c.b);
+}
+
+vec3 yCoCgToRgb(vec3 c) { return vec3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z); }
+
+void main() {
+  ivec2 p = ivec2(gl_FragCoord.xy);
+  ivec2 size = textureSize(newFrame, 0);
+  vec4 newSample = texelFetch(newFrame, p, 0);
+  vec3 current = newSample.rgb;
+  vec4 motion = texelFetch(motionTex, p, 0);
+
+  vec4 history = vec4(0.0f);
+  float frames = 0.0f;
+  if (motion.b > 0.5f) {
+    vec2 prevUV = TexCoord - motion.xy;
+    ivec2 prevPixel = clamp(ivec2(prevUV * vec2(size)), ivec2(0), size - 1);
+    // bilinear when moving, reprojection rarely lands on a texel center; still pixels must not blur frame after frame
+    bool still = all(lessThan(abs(motion.xy * vec2(size)), vec2(0.01f)));
+    history = still ? texelFetch(historyColor, prevPixel, 0) : texture(historyColor, prevUV);
+    frames = texelFetch(historyLength, prevPixel, 0).r;
+  }
+
+  if (newSample.a < 0.0f) {
+    FragColor = history;
+    HistoryLength = frames;
+    return;
+  }
+
+  if (frames > 0.0f && clipHistory) {
+    vec3 m1 = vec3(0.0f);
+    vec3 m2 = vec3(0.0f);
+    for (int y = -1; y <= 1; y++) {
+      for (int x = -1; x <= 1; x++) {
+        vec3 c = rgbToYCoCg(texelFetch(newFrame, clamp(p + ivec2(x, y), ivec2(0), size - 1), 0).rgb);
+        m1 += c;
+        m2 += c * c;
+      }
+    }
+    m1 /= 9.0f;
+    m2 /= 9.0f;
+    vec3 sigma = sqrt(max(m2 - m1 * m1, vec3(0.0f)));
+    vec3 mean = rgbToYCoCg(history.rgb);
+    vec3 clipped = clamp(mean, m1 - clipGamma * sigma, m1 + clipGamma * sigma);
+    history.rgb = max(yCoCgToRgb(clipped), vec3(0.0f));
+    // keep the second moment consistent with the clipped mean so the variance does not go negative
+    float l = luminance(history.rgb);
+    history.a = max(history.a, l * l);
+  }
+
+  frames = min(frames + 1.0f, maxHistory);
+  float l = luminance(current);
+  FragColor = mix(history, vec4(current, l * l), 1.0f / frames);
+  HistoryLength = frames;
+}
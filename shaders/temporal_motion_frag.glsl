@@ -0,0 +1,30 @@
+#version 330 core
+
+// Motion vectors of the path tracer's primary hits: rebuild the hit from its distance along this frame's camera ray
+// and project it with last frame's camera
+// Output: rg motion in uv (current - previous), b 1 when the previous position was on screen
+out vec4 FragColor;
+
+uniform float fov;
+uniform vec2 resolution;
+uniform vec3 camPosition;
+uniform mat4 viewMatrix;
+uniform vec3 prevCamPosition;
+uniform mat4 prevViewMatrix;
+uniform sampler2D normalDepthTex;  // w primary hit distance, 0 when nothing was hit
+
+#include "shaders/rt_camera.glsl"
+
+void main() {
+  float dst = texelFetch(normalDepthTex, ivec2(gl_FragCoord.xy), 0).w;
+  vec3 direction = cameraRayDirection(gl_FragCoord.xy, viewMatrix);
+  // nothing hit: the background is at infinity and only follows the camera's rotation
+  vec3 offset = dst > 0.0 ? camPosition + direction * dst - prevCamPosition : direction;
+  vec3 previous = cameraProject(offset, prevViewMatrix);
+
+  vec2 uv = gl_FragCoord.xy / resolution;
+  vec2 prevUV = previous.xy / resolution;
+  bool onScreen =
+      previous.z > 0.0 && all(greaterThanEqual(prevUV, vec2(0.0))) && all(lessThanEqual(prevUV, vec2(1.0)));
+  FragColor = vec4(uv - prevUV, onScreen ? 1.0 : 0.0, 1.0);
+}
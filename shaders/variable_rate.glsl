@@ -0,0 +1,68 @@
+#pragma once
+
+// Variable-rate rendering for the full-screen ray tracers (rt_trace.glsl, sdf_blend_frag, sdf_taipei101_frag):
+// the low pass runs the shader at a fraction of the resolution into color + guide targets, the upsample pass runs it
+// again at full resolution, interpolates the low-res color where its 2x2 footprint is smooth and only traces or
+// marches across edges (hit / miss, depth, normal and optionally color jumps), where upsampling would blur
+
+#define VARIABLE_RATE_OFF 0
+#define VARIABLE_RATE_LOW 1
+#define VARIABLE_RATE_UPSAMPLE 2
+
+uniform int variableRatePass = VARIABLE_RATE_OFF;
+// full / low resolution; the low pass sets `resolution` to the full one divided by it, so its pixels line up
+uniform float variableRateScale = 2.0;
+uniform sampler2D lowResColor;
+uniform sampler2D lowResGuide;            // xyz normal (0 when unknown), w hit distance (0: miss)
+uniform float depthEdgeThreshold = 0.05;  // relative hit distance difference
+uniform float colorEdgeThreshold = 0.0;   // relative luminance difference, 0 ignores color (e.g. noisy 1 spp input)
+
+// Normals of the footprint bending more than this are an edge
+#define VARIABLE_RATE_NORMAL_COS 0.9
+
+// True with the interpolated low-res color in `color` when the pixel can skip full-rate work
+bool variableRateUpsample(vec2 fragCoord, out vec4 color) {
+  ivec2 lowSize = textureSize(lowResColor, 0);
+  vec2 texel = fragCoord / variableRateScale - 0.5;
+  ivec2 base = ivec2(floor(texel));
+  vec2 f = fract(texel);
+
+  vec4 colors[4];
+  vec4 guides[4];
+  for (int i = 0; i < 4; i++) {
+    ivec2 q = clamp(base + ivec2(i & 1, i >> 1), ivec2(0), lowSize - 1);
+    colors[i] = texelFetch(lowResColor, q, 0);
+    guides[i] = texelFetch(lowResGuide, q, 0);
+  }
+
+  bool anyHit = false;
+  bool anyMiss = false;
+  float minDepth = 1e30;
+  float maxDepth = 0.0;
+  float minLuminance = 1e30;
+  float maxLuminance = 0.0;
+  for (int i = 0; i < 4; i++) {
+    if (guides[i].w > 0.0) {
+      anyHit = true;
+      minDepth = min(minDepth, guides[i].w);
+      maxDepth = max(maxDepth, guides[i].w);
+    } else {
+      anyMiss = true;
+    }
+    // normals are compared against the first sample, unknown (zero) normals never count as an edge
+    float cosAngle = dot(guides[0].xyz, guides[i].xyz);
+    bool hasNormals = dot(guides[0].xyz, guides[0].xyz) > 0.0 && dot(guides[i].xyz, guides[i].xyz) > 0.0;
+    if (hasNormals && cosAngle < VARIABLE_RATE_NORMAL_COS) return false;
+    float l = dot(colors[i].rgb, vec3(0.2126, 0.7152, 0.0722));
+    minLuminance = min(minLuminance, l);
+    maxLuminance = max(maxLuminance, l);
+  }
+  if (anyHit && anyMiss) return false;
+  if (anyHit && maxDepth - minDepth > depthEdgeThreshold * minDepth) return false;
+  if (colorEdgeThreshold > 0.0 && maxLuminance - minLuminance > colorEdgeThreshold * (maxLuminance + 0.05)) {
+    return false;
+  }
+
+  color = mix(mix(colors[0], colors[1], f.x), mix(colors[2], colors[3], f.x), f.y);
+  return true;
+}
@@ -2,6 +2,8 @@
 
 #include <OPPCH.h>
 
+#include "geom/mesh_optimizer.hpp"
+
 std::unique_ptr<gfx::geom::Mesh> createCuboidMesh(float width, float height, float depth, glm::vec3 pos,
                                                   glm::vec3 color) {
   glm::vec3 p0 = glm::vec3(-width / 2 + pos[0], -height / 2 + pos[1], -depth / 2 + pos[2]);
@@ -437,5 +439,9 @@ std::unique_ptr<gfx::geom::Mesh> createSphereMesh(float radius, glm::vec3 pos, g
     }
   }
 
+  // 逐列產生的索引對 vertex cache 很不友善，sectors 大時尤其明顯
+  gfx::geom::optimizeVertexCache(indices, vertices.size());
+  gfx::geom::optimizeVertexFetch(vertices, indices);
+
   return std::make_unique<gfx::geom::Mesh>(vertices, indices);
 }
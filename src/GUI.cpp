@@ -2,6 +2,11 @@
 
 #include <OPPCH.h>
 
+#include "ProgramCache.hpp"
+#include "ShaderWatcher.hpp"
+#include "resource/texture_cache.hpp"
+#include "resource/texture_streamer.hpp"
+
 GUI::GUI(SDL_Window *window, SDL_GLContext context, test::Test *&currentTest) : currentTest(currentTest) {
   IMGUI_CHECKVERSION();
   ImGui::CreateContext();
@@ -62,6 +67,25 @@ void GUI::draw(std::shared_ptr<Camera> camera) {
       if (ImGui::Checkbox("VSync On", &isVSync)) {
         SDL_GL_SetSwapInterval(isVSync);
       }
+      const auto stream = gfx::resource::TextureStreamer::instance().stats();
+      ImGui::Text("Textures: %d queued, %d uploading, %d done, %d failed", stream.queued, stream.uploading,
+                  stream.completed, stream.failed);
+      ImGui::Text("Load latency: last %.1f ms, avg %.1f ms, max %.1f ms", stream.lastLatencyMs, stream.avgLatencyMs,
+                  stream.maxLatencyMs);
+      const auto cache = gfx::resource::TextureCache::instance().stats();
+      ImGui::Text("Texture cache: %d hits, %d misses, %d evicted", cache.hits, cache.misses, cache.evictions);
+      ImGui::Text("%d textures, %.1f MB (%.1f MB unused) / %.0f MB budget", cache.entries, cache.totalBytes / 1048576.0,
+                  cache.cachedBytes / 1048576.0, cache.budgetBytes / 1048576.0);
+      const auto programs = ProgramBinaryCache::instance().stats();
+      ImGui::Text("Program binaries: %d hits (%.1f ms), %d misses (%.1f ms compile), %d rejected", programs.hits,
+                  programs.loadMs, programs.misses, programs.compileMs, programs.rejected);
+      if (ImGui::Button("Clear program cache")) ProgramBinaryCache::instance().clear();
+      auto &watcher = ShaderWatcher::instance();
+      bool hotReload = watcher.enabled();
+      if (ImGui::Checkbox("Shader hot reload", &hotReload)) watcher.setEnabled(hotReload);
+      const auto reloads = watcher.stats();
+      ImGui::Text("Shader reloads: %d ok, %d failed, %d compiling (last: %s)", reloads.reloads, reloads.failures,
+                  reloads.pending, reloads.lastFile.empty() ? "-" : reloads.lastFile.c_str());
       if (ImGui::Button("Exit")) {
         currentTest->OnExit();
         delete currentTest;
@@ -3,6 +3,8 @@
 #include <OPPCH.h>
 
 #include "Utils.hpp"
+#include "geom/mesh_optimizer.hpp"
+#include "resource/texture_cache.hpp"
 
 Model::Model(const char *path) {
   modelMatrix = glm::mat4(1.0f);
@@ -15,6 +17,10 @@ Model::Model(const char *path) {
   glm::mat4 identity = glm::mat4(1.0f);
   traverseNode(0, identity);
 
+  for (size_t i = 0; i < meshes.size(); i++) {
+    bounds = i == 0 ? meshes[i].bounds : gfx::geom::Bounds::merge(bounds, meshes[i].bounds);
+  }
+
   // release data
   data.clear();
 }
@@ -48,7 +54,11 @@ void Model::loadMesh(unsigned int indMesh, glm::mat4 matrix) {
   std::vector<GLuint> indices = getIndices(JSON["accessors"][indAccInd]);
   std::vector<std::shared_ptr<gfx::resource::Texture>> textures = getTextures();
 
-  meshes.push_back(gfx::geom::Mesh(vertices, indices, textures));
+  // weld + vertex cache / overdraw / fetch 重排
+  optimizeStats.push_back(gfx::geom::optimizeMesh(vertices, indices));
+
+  // glTF 的頂點色固定為白色，用不含 color 的 compact 格式（20 bytes/vertex）
+  meshes.push_back(gfx::geom::Mesh(vertices, indices, textures, gfx::geom::VertexFormat::CompactNoColor));
 }
 
 void Model::traverseNode(unsigned int nodeIndex, glm::mat4 modelMatrix) {
@@ -209,27 +219,10 @@ std::vector<std::shared_ptr<gfx::resource::Texture>> Model::getTextures() {
 
   std::string fileDir = std::string(path).substr(0, std::string(path).find_last_of("/"));
 
+  // 同一張圖在不同 mesh / Model / Test 之間共用，由全域 cache 處理
   for (size_t i = 0; i < JSON["images"].size(); i++) {
     std::string texPath = JSON["images"][i]["uri"];
-
-    // 先查 cache
-    for (size_t j = 0; j < loadedTexturesName.size(); ++j) {
-      if (loadedTexturesName[j] == texPath) {
-        textures.push_back(loadedTextures[j]);  // 拷貝的是 shared_ptr（OK）
-        goto next_image;
-      }
-    }
-
-    // 載入 + 放 cache
-    {
-      auto full = fileDir + "/" + texPath;
-      auto tex = std::make_shared<gfx::resource::Texture>(full.c_str(), "albedo", /*slot*/ 0);  // slot 先統一用 0
-      loadedTexturesName.push_back(texPath);
-      loadedTextures.push_back(tex);
-      textures.push_back(std::move(tex));
-    }
-
-  next_image:;
+    textures.push_back(gfx::resource::TextureCache::instance().load(fileDir + "/" + texPath, "albedo", /*slot*/ 0));
   }
 
   return textures;
@@ -0,0 +1,165 @@
+#include "ProgramCache.hpp"
+
+#include <OPPCH.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+constexpr char MAGIC[4] = {'G', 'L', 'P', 'B'};
+constexpr uint32_t FILE_VERSION = 1;
+
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t key;
+  uint32_t binaryFormat;
+  uint32_t size;
+  uint64_t checksum;  // binary 本身的 hash，檔案被截斷或寫到一半時擋下來
+};
+
+// FNV-1a 64-bit
+uint64_t hashBytes(const void *data, size_t size, uint64_t h = 14695981039346656037ull) {
+  const auto *p = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; i++) {
+    h ^= p[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+std::string glString(GLenum name) {
+  const auto *s = reinterpret_cast<const char *>(glGetString(name));
+  return s ? s : "";
+}
+
+}  // namespace
+
+ProgramBinaryCache &ProgramBinaryCache::instance() {
+  static ProgramBinaryCache cache;
+  return cache;
+}
+
+void ProgramBinaryCache::detect() {
+  if (supported_ >= 0) return;
+  GLint formats = 0;
+  if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  supported_ = formats > 0 ? 1 : 0;
+  driver_ = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION) + "\n" +
+            glString(GL_SHADING_LANGUAGE_VERSION);
+}
+
+bool ProgramBinaryCache::enabled() {
+  detect();
+  return enabled_ && supported_ == 1;
+}
+
+uint64_t ProgramBinaryCache::key(const Sources &sources) {
+  detect();
+  uint64_t h = hashBytes(driver_.data(), driver_.size());
+  for (const auto &[stage, code] : sources) {
+    h = hashBytes(&stage, sizeof(stage), h);
+    const uint64_t size = code.size();  // 長度也算進去，避免 stage 邊界不同卻串成相同內容
+    h = hashBytes(&size, sizeof(size), h);
+    h = hashBytes(code.data(), code.size(), h);
+  }
+  return h;
+}
+
+std::string ProgramBinaryCache::pathFor(uint64_t key) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+  return directory_ + "/" + name;
+}
+
+GLuint ProgramBinaryCache::load(uint64_t key) {
+  const auto t0 = std::chrono::steady_clock::now();
+  const std::string path = pathFor(key);
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    stats_.misses++;
+    return 0;
+  }
+
+  FileHeader header{};
+  std::vector<char> binary;
+  bool valid = static_cast<bool>(file.read(reinterpret_cast<char *>(&header), sizeof(header))) &&
+               std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == FILE_VERSION &&
+               header.key == key && header.size > 0;
+  if (valid) {
+    binary.resize(header.size);
+    valid = file.read(binary.data(), binary.size()) && hashBytes(binary.data(), binary.size()) == header.checksum;
+  }
+
+  GLuint prog = 0;
+  if (valid) {
+    prog = glCreateProgram();
+    glProgramBinary(prog, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint linked = GL_FALSE;
+    glGetProgramiv(prog, GL_LINK_STATUS, &linked);
+    if (!linked) {
+      glDeleteProgram(prog);
+      prog = 0;
+    }
+  }
+
+  if (!prog) {
+    // 壞掉或 driver 不認得的 binary 直接刪掉，這次 compile 完會重新寫入
+    file.close();
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    stats_.rejected++;
+    stats_.misses++;
+    return 0;
+  }
+  stats_.hits++;
+  stats_.loadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  return prog;
+}
+
+void ProgramBinaryCache::store(uint64_t key, GLuint program) {
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) return;
+
+  std::vector<char> binary(length);
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &length, &format, binary.data());
+  if (length <= 0) return;
+  binary.resize(length);
+
+  FileHeader header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FILE_VERSION;
+  header.key = key;
+  header.binaryFormat = format;
+  header.size = static_cast<uint32_t>(binary.size());
+  header.checksum = hashBytes(binary.data(), binary.size());
+
+  std::error_code ec;
+  std::filesystem::create_directories(directory_, ec);
+  // 先寫暫存檔再 rename，同時開兩個程式也不會讀到寫一半的檔案
+  const std::string path = pathFor(key);
+  const std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(reinterpret_cast<const char *>(&header), sizeof(header)) ||
+        !file.write(binary.data(), binary.size())) {
+      std::cerr << "Failed to write program binary cache: " << tmpPath << std::endl;
+      return;
+    }
+  }
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) std::filesystem::remove(tmpPath, ec);
+}
+
+void ProgramBinaryCache::recordCompile(double ms) { stats_.compileMs += ms; }
+
+void ProgramBinaryCache::clear() {
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(directory_, ec)) {
+    if (entry.path().extension() == ".bin") std::filesystem::remove(entry.path(), ec);
+  }
+}
@@ -2,26 +2,226 @@
 
 #include <OPPCH.h>
 
-Shader::Shader(const char *vertShaderPath, const char *fragShaderPath)
-    : vertPath_(vertShaderPath ? vertShaderPath : ""), fragPath_(fragShaderPath ? fragShaderPath : "") {
-  PROGRAM_ID = buildProgram(vertPath_.c_str(), nullptr, fragPath_.c_str());
+#include "ProgramCache.hpp"
+#include "ShaderPreprocessor.hpp"
+#include "ShaderWatcher.hpp"
+
+namespace {
+
+// glGetUniform* 依型別讀出舊 program 的值，寫進目前 bind 的 program
+void copyUniform(GLuint from, GLint src, GLint dst, GLenum type) {
+  GLfloat f[16];
+  GLint i[4];
+  GLuint u[4];
+  switch (type) {
+    case GL_FLOAT:
+      glGetUniformfv(from, src, f);
+      glUniform1fv(dst, 1, f);
+      break;
+    case GL_FLOAT_VEC2:
+      glGetUniformfv(from, src, f);
+      glUniform2fv(dst, 1, f);
+      break;
+    case GL_FLOAT_VEC3:
+      glGetUniformfv(from, src, f);
+      glUniform3fv(dst, 1, f);
+      break;
+    case GL_FLOAT_VEC4:
+      glGetUniformfv(from, src, f);
+      glUniform4fv(dst, 1, f);
+      break;
+    case GL_FLOAT_MAT2:
+      glGetUniformfv(from, src, f);
+      glUniformMatrix2fv(dst, 1, GL_FALSE, f);
+      break;
+    case GL_FLOAT_MAT3:
+      glGetUniformfv(from, src, f);
+      glUniformMatrix3fv(dst, 1, GL_FALSE, f);
+      break;
+    case GL_FLOAT_MAT4:
+      glGetUniformfv(from, src, f);
+      glUniformMatrix4fv(dst, 1, GL_FALSE, f);
+      break;
+    case GL_FLOAT_MAT2x3:
+      glGetUniformfv(from, src, f);
+      glUniformMatrix2x3fv(dst, 1, GL_FALSE, f);
+      break;
+    case GL_FLOAT_MAT2x4:
+      glGetUniformfv(from, src, f);
+      glUniformMatrix2x4fv(dst, 1, GL_FALSE, f);
+      break;
+    case GL_FLOAT_MAT3x2:
+      glGetUniformfv(from, src, f);
+      glUniformMatrix3x2fv(dst, 1, GL_FALSE, f);
+      break;
+    case GL_FLOAT_MAT3x4:
+      glGetUniformfv(from, src, f);
+      glUniformMatrix3x4fv(dst, 1, GL_FALSE, f);
+      break;
+    case GL_FLOAT_MAT4x2:
+      glGetUniformfv(from, src, f);
+      glUniformMatrix4x2fv(dst, 1, GL_FALSE, f);
+      break;
+    case GL_FLOAT_MAT4x3:
+      glGetUniformfv(from, src, f);
+      glUniformMatrix4x3fv(dst, 1, GL_FALSE, f);
+      break;
+    case GL_INT_VEC2:
+    case GL_BOOL_VEC2:
+      glGetUniformiv(from, src, i);
+      glUniform2iv(dst, 1, i);
+      break;
+    case GL_INT_VEC3:
+    case GL_BOOL_VEC3:
+      glGetUniformiv(from, src, i);
+      glUniform3iv(dst, 1, i);
+      break;
+    case GL_INT_VEC4:
+    case GL_BOOL_VEC4:
+      glGetUniformiv(from, src, i);
+      glUniform4iv(dst, 1, i);
+      break;
+    case GL_UNSIGNED_INT:
+      glGetUniformuiv(from, src, u);
+      glUniform1uiv(dst, 1, u);
+      break;
+    case GL_UNSIGNED_INT_VEC2:
+      glGetUniformuiv(from, src, u);
+      glUniform2uiv(dst, 1, u);
+      break;
+    case GL_UNSIGNED_INT_VEC3:
+      glGetUniformuiv(from, src, u);
+      glUniform3uiv(dst, 1, u);
+      break;
+    case GL_UNSIGNED_INT_VEC4:
+      glGetUniformuiv(from, src, u);
+      glUniform4uiv(dst, 1, u);
+      break;
+    // int、bool、sampler、image 都是單一個 int（sampler / image 存的是 texture / image unit）
+    case GL_INT:
+    case GL_BOOL:
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_1D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_1D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_SAMPLER_BUFFER:
+    case GL_SAMPLER_2D_RECT:
+    case GL_SAMPLER_2D_RECT_SHADOW:
+    case GL_INT_SAMPLER_1D:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_1D_ARRAY:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_INT_SAMPLER_BUFFER:
+    case GL_INT_SAMPLER_2D_RECT:
+    case GL_UNSIGNED_INT_SAMPLER_1D:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE:
+    case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+    case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+    case GL_IMAGE_1D:
+    case GL_IMAGE_2D:
+    case GL_IMAGE_3D:
+    case GL_IMAGE_2D_RECT:
+    case GL_IMAGE_CUBE:
+    case GL_IMAGE_BUFFER:
+    case GL_IMAGE_1D_ARRAY:
+    case GL_IMAGE_2D_ARRAY:
+    case GL_IMAGE_2D_MULTISAMPLE:
+    case GL_IMAGE_2D_MULTISAMPLE_ARRAY:
+    case GL_INT_IMAGE_1D:
+    case GL_INT_IMAGE_2D:
+    case GL_INT_IMAGE_3D:
+    case GL_INT_IMAGE_2D_RECT:
+    case GL_INT_IMAGE_CUBE:
+    case GL_INT_IMAGE_BUFFER:
+    case GL_INT_IMAGE_1D_ARRAY:
+    case GL_INT_IMAGE_2D_ARRAY:
+    case GL_INT_IMAGE_2D_MULTISAMPLE:
+    case GL_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+    case GL_UNSIGNED_INT_IMAGE_1D:
+    case GL_UNSIGNED_INT_IMAGE_2D:
+    case GL_UNSIGNED_INT_IMAGE_3D:
+    case GL_UNSIGNED_INT_IMAGE_2D_RECT:
+    case GL_UNSIGNED_INT_IMAGE_CUBE:
+    case GL_UNSIGNED_INT_IMAGE_BUFFER:
+    case GL_UNSIGNED_INT_IMAGE_1D_ARRAY:
+    case GL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+    case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE:
+    case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+      glGetUniformiv(from, src, i);
+      glUniform1iv(dst, 1, i);
+      break;
+    default:  // double、atomic counter 等：讀寫的型別對不上會 GL_INVALID_OPERATION，保留新 program 的預設值
+      break;
+  }
+}
+
+}  // namespace
+
+Shader::Shader(const char *vertShaderPath, const char *fragShaderPath, const ShaderDefines &defines)
+    : Shader(vertShaderPath, nullptr, fragShaderPath, defines) {}
+
+Shader::Shader(const char *vertShaderPath, const char *geomShaderPath, const char *fragShaderPath,
+               const ShaderDefines &defines)
+    : vertPath_(vertShaderPath ? vertShaderPath : ""),
+      geomPath_(geomShaderPath ? geomShaderPath : ""),
+      fragPath_(fragShaderPath ? fragShaderPath : ""),
+      defines_(defines) {
+  build(false);
 }
 
-Shader::Shader(const char *vertShaderPath, const char *geomShaderPath, const char *fragShaderPath)
+Shader::Shader(AsyncTag, const char *vertShaderPath, const char *fragShaderPath, const ShaderDefines &defines)
+    : Shader(async, vertShaderPath, nullptr, fragShaderPath, defines) {}
+
+Shader::Shader(AsyncTag, const char *vertShaderPath, const char *geomShaderPath, const char *fragShaderPath,
+               const ShaderDefines &defines)
     : vertPath_(vertShaderPath ? vertShaderPath : ""),
       geomPath_(geomShaderPath ? geomShaderPath : ""),
-      fragPath_(fragShaderPath ? fragShaderPath : "") {
-  PROGRAM_ID = buildProgram(vertPath_.c_str(), geomPath_.empty() ? nullptr : geomPath_.c_str(), fragPath_.c_str());
+      fragPath_(fragShaderPath ? fragShaderPath : ""),
+      defines_(defines) {
+  build(true);
+}
+
+Shader::Shader(const char *compShaderPath, const ShaderDefines &defines)
+    : compPath_(compShaderPath ? compShaderPath : ""), defines_(defines) {
+  build(false);
 }
 
-Shader::~Shader() { reset(); }
+Shader::~Shader() {
+  ShaderWatcher::instance().remove(this);
+  reset();
+}
 
 Shader::Shader(Shader &&other) noexcept
     : vertPath_(std::move(other.vertPath_)),
       geomPath_(std::move(other.geomPath_)),
       fragPath_(std::move(other.fragPath_)),
+      compPath_(std::move(other.compPath_)),
+      defines_(std::move(other.defines_)),
+      dependencies_(std::move(other.dependencies_)),
+      pending_(std::move(other.pending_)),
+      reloading_(std::move(other.reloading_)),
       PROGRAM_ID(other.PROGRAM_ID) {
   other.PROGRAM_ID = 0;
+  ShaderWatcher::instance().add(this);
 }
 
 Shader &Shader::operator=(Shader &&other) noexcept {
@@ -30,6 +230,11 @@ Shader &Shader::operator=(Shader &&other) noexcept {
     vertPath_ = std::move(other.vertPath_);
     geomPath_ = std::move(other.geomPath_);
     fragPath_ = std::move(other.fragPath_);
+    compPath_ = std::move(other.compPath_);
+    defines_ = std::move(other.defines_);
+    dependencies_ = std::move(other.dependencies_);
+    pending_ = std::move(other.pending_);
+    reloading_ = std::move(other.reloading_);
     PROGRAM_ID = other.PROGRAM_ID;
     other.PROGRAM_ID = 0;
   }
@@ -37,41 +242,67 @@ Shader &Shader::operator=(Shader &&other) noexcept {
 }
 
 bool Shader::reload() {
-  GLuint newProg =
-      buildProgram(vertPath_.empty() ? nullptr : vertPath_.c_str(), geomPath_.empty() ? nullptr : geomPath_.c_str(),
-                   fragPath_.empty() ? nullptr : fragPath_.c_str());
+  PendingBuild pending = beginBuild();
+  GLuint newProg = finishBuild(pending);
 
   if (!newProg) return false;
-  reset();
-  PROGRAM_ID = newProg;
+  swapProgram(newProg);
   return true;
 }
 
+void Shader::beginReload() {
+  // 初次的非同步 build 還沒完成：直接用新的原始碼重送
+  if (pending_) {
+    discardBuild(*pending_);
+    pending_ = std::make_unique<PendingBuild>(beginBuild());
+    return;
+  }
+  if (reloading_) discardBuild(*reloading_);  // 連續存檔時只保留最新的一次
+  reloading_ = std::make_unique<PendingBuild>(beginBuild());
+}
+
+Shader::ReloadStatus Shader::pollReload() {
+  if (!reloading_) return ReloadStatus::Idle;
+  if (!buildFinished(*reloading_)) return ReloadStatus::Pending;
+  GLuint newProg = finishBuild(*reloading_);
+  reloading_.reset();
+  if (!newProg) return ReloadStatus::Failed;
+  swapProgram(newProg);
+  return ReloadStatus::Swapped;
+}
+
 void Shader::use() const { glUseProgram(PROGRAM_ID); }
 
-std::string Shader::readFile(const char *filePath) {
-  std::ifstream file(filePath, std::ios::in);
-  if (!file.is_open()) {
-    std::cerr << "Could not read file " << filePath << ". File does not exist.\n";
-    return "";
-  }
-  std::stringstream ss;
-  std::string line;
-  while (std::getline(file, line)) {
-    if (line.rfind("#include", 0) == 0) {
-      // 形如: #include "path"
-      auto left = line.find('"');
-      auto right = line.find_last_of('"');
-      if (left != std::string::npos && right != std::string::npos && right > left) {
-        std::string includeFile = line.substr(left + 1, right - left - 1);
-        ss << readFile(includeFile.c_str());
-        ss << "\n";
-      }
-    } else {
-      ss << line << "\n";
-    }
+bool Shader::setDefines(const ShaderDefines &defines) {
+  defines_ = defines;
+  return reload();
+}
+
+bool Shader::isReady() {
+  if (!pending_) return true;
+  if (!buildFinished(*pending_)) return false;
+  PROGRAM_ID = finishBuild(*pending_);
+  pending_.reset();
+  return true;
+}
+
+bool Shader::allReady(std::initializer_list<Shader *> shaders) {
+  bool ready = true;
+  for (Shader *shader : shaders) ready = shader->isReady() && ready;  // 每個都要 poll，已完成的先收尾
+  return ready;
+}
+
+bool Shader::parallelCompileSupported() {
+  return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
+
+void Shader::enableParallelCompile() {
+  // 0xFFFFFFFF 表示交給 driver 決定（通常是 CPU 核心數）
+  if (GLEW_KHR_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+  } else if (GLEW_ARB_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
   }
-  return ss.str();
 }
 
 GLuint Shader::compileShader(const char *shaderSource, GLenum shaderType) {
@@ -81,13 +312,18 @@ GLuint Shader::compileShader(const char *shaderSource, GLenum shaderType) {
   return shader;
 }
 
-void Shader::checkCompileErrors(GLuint shader, const char *shaderPath) {
+void Shader::checkCompileErrors(GLuint shader, const std::vector<std::string> &files) {
   GLint success;
-  GLchar infoLog[512];
+  GLchar infoLog[2048];
   glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
   if (!success) {
-    glGetShaderInfoLog(shader, 512, NULL, infoLog);
-    std::cout << "ERROR::SHADER::" << shaderPath << "::COMPILATION_FAILED\n" << infoLog << std::endl;
+    glGetShaderInfoLog(shader, sizeof(infoLog), NULL, infoLog);
+    std::cout << "ERROR::SHADER::" << (files.empty() ? "" : files[0]) << "::COMPILATION_FAILED\n" << infoLog;
+    // 行號前面的 source string number 對應的檔案
+    if (files.size() > 1) {
+      for (size_t i = 0; i < files.size(); i++) std::cout << "  " << i << ": " << files[i] << "\n";
+    }
+    std::cout << std::endl;
   }
 }
 
@@ -101,32 +337,66 @@ void Shader::checkLinkErrors(GLuint program, const char *tag) {
   }
 }
 
-GLuint Shader::buildProgram(const char *vert, const char *geom, const char *frag) {
-  std::vector<GLuint> shaders;
-  shaders.reserve(3);
-
-  auto attach = [&](const char *path, GLenum type) {
-    if (!path) return;
-    std::string code = readFile(path);
-    GLuint sh = compileShader(code.c_str(), type);
-    checkCompileErrors(sh, path);
-    shaders.push_back(sh);
+Shader::PendingBuild Shader::beginBuild() {
+  // 先把每個 stage 展開成完整原始碼，program binary cache 的 key 由此而來
+  ProgramBinaryCache::Sources sources;
+  PendingBuild build;
+  dependencies_.clear();
+  auto add = [&](const std::string &path, GLenum type) {
+    if (path.empty()) return;
+    PreprocessedShader stage = ShaderPreprocessor::instance().process(path, defines_);
+    for (const auto &file : stage.files) {
+      if (std::find(dependencies_.begin(), dependencies_.end(), file) == dependencies_.end()) {
+        dependencies_.push_back(file);
+      }
+    }
+    sources.emplace_back(type, std::move(stage.source));
+    build.stageFiles.push_back(std::move(stage.files));
   };
+  add(vertPath_, GL_VERTEX_SHADER);
+  add(geomPath_, GL_GEOMETRY_SHADER);
+  add(fragPath_, GL_FRAGMENT_SHADER);
+  add(compPath_, GL_COMPUTE_SHADER);
+
+  auto &cache = ProgramBinaryCache::instance();
+  build.useCache = cache.enabled();
+  if (build.useCache) {
+    build.cacheKey = cache.key(sources);
+    build.program = cache.load(build.cacheKey);
+    if (build.program) return build;
+  }
+
+  build.start = std::chrono::steady_clock::now();
+  for (const auto &[type, code] : sources) build.shaders.push_back(compileShader(code.c_str(), type));
+
+  build.program = glCreateProgram();
+  if (build.useCache) glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  for (auto sh : build.shaders) glAttachShader(build.program, sh);
+  glLinkProgram(build.program);
+  return build;
+}
 
-  attach(vert, GL_VERTEX_SHADER);
-  attach(geom, GL_GEOMETRY_SHADER);
-  attach(frag, GL_FRAGMENT_SHADER);
+bool Shader::buildFinished(const PendingBuild &build) {
+  // 沒有 parallel compile 時 finishBuild 查 status 就會等 driver 做完
+  if (build.shaders.empty() || !parallelCompileSupported()) return true;
+  GLint done = GL_FALSE;
+  glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &done);
+  return done == GL_TRUE;
+}
+
+GLuint Shader::finishBuild(PendingBuild &build) {
+  GLuint prog = build.program;
+  if (build.shaders.empty()) return prog;  // 從 program binary cache 載入，已經 link 好
 
-  GLuint prog = glCreateProgram();
-  for (auto sh : shaders) glAttachShader(prog, sh);
-  glLinkProgram(prog);
+  for (size_t i = 0; i < build.shaders.size(); i++) checkCompileErrors(build.shaders[i], build.stageFiles[i]);
   checkLinkErrors(prog, "PROGRAM");
 
   // 無論成功與否都刪 shader 物件
-  for (auto sh : shaders) {
+  for (auto sh : build.shaders) {
     glDetachShader(prog, sh);
     glDeleteShader(sh);
   }
+  build.shaders.clear();
 
   // 連結失敗則刪 program 並回 0
   GLint linked = GL_FALSE;
@@ -135,10 +405,90 @@ GLuint Shader::buildProgram(const char *vert, const char *geom, const char *frag
     glDeleteProgram(prog);
     return 0;
   }
+  if (build.useCache) {
+    auto &cache = ProgramBinaryCache::instance();
+    const auto elapsed = std::chrono::steady_clock::now() - build.start;
+    cache.recordCompile(std::chrono::duration<double, std::milli>(elapsed).count());
+    cache.store(build.cacheKey, prog);
+  }
   return prog;
 }
 
+void Shader::discardBuild(PendingBuild &build) {
+  for (auto sh : build.shaders) glDeleteShader(sh);
+  if (build.program) glDeleteProgram(build.program);
+  build.shaders.clear();
+  build.program = 0;
+}
+
+void Shader::build(bool async) {
+  ShaderWatcher::instance().add(this);
+  PendingBuild pending = beginBuild();
+  if (async) {
+    pending_ = std::make_unique<PendingBuild>(std::move(pending));
+  } else {
+    PROGRAM_ID = finishBuild(pending);
+  }
+}
+
+void Shader::swapProgram(GLuint program) {
+  if (PROGRAM_ID) {
+    copyProgramState(PROGRAM_ID, program);
+    glDeleteProgram(PROGRAM_ID);
+  }
+  PROGRAM_ID = program;
+}
+
+void Shader::copyProgramState(GLuint from, GLuint to) {
+  GLint previous = 0;
+  glGetIntegerv(GL_CURRENT_PROGRAM, &previous);
+  glUseProgram(to);
+
+  GLint count = 0;
+  glGetProgramiv(to, GL_ACTIVE_UNIFORMS, &count);
+  for (GLint index = 0; index < count; index++) {
+    GLchar name[256];
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(to, index, sizeof(name), &length, &size, &type, name);
+    // 陣列回傳的名稱是 "xxx[0]"，逐個元素複製
+    std::string base(name, length);
+    if (size > 1 && base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0) base.resize(base.size() - 3);
+    for (GLint e = 0; e < size; e++) {
+      const std::string element = size > 1 ? base + "[" + std::to_string(e) + "]" : base;
+      const GLint src = glGetUniformLocation(from, element.c_str());
+      const GLint dst = glGetUniformLocation(to, element.c_str());
+      if (src < 0 || dst < 0) continue;  // 新增的 uniform、或 uniform block 內的成員（沒有 location）
+      copyUniform(from, src, dst, type);
+    }
+  }
+
+  GLint blocks = 0;
+  glGetProgramiv(to, GL_ACTIVE_UNIFORM_BLOCKS, &blocks);
+  for (GLint index = 0; index < blocks; index++) {
+    GLchar name[256];
+    glGetActiveUniformBlockName(to, index, sizeof(name), nullptr, name);
+    const GLuint old = glGetUniformBlockIndex(from, name);
+    if (old == GL_INVALID_INDEX) continue;
+    GLint binding = 0;
+    glGetActiveUniformBlockiv(from, old, GL_UNIFORM_BLOCK_BINDING, &binding);
+    glUniformBlockBinding(to, index, binding);
+  }
+
+  // 原本 bind 的就是舊 program 時改 bind 新的，呼叫端接著畫也不會用到已刪除的 program
+  glUseProgram(static_cast<GLuint>(previous) == from ? to : static_cast<GLuint>(previous));
+}
+
 void Shader::reset() {
+  if (pending_) {
+    discardBuild(*pending_);
+    pending_.reset();
+  }
+  if (reloading_) {
+    discardBuild(*reloading_);
+    reloading_.reset();
+  }
   if (PROGRAM_ID) {
     glDeleteProgram(PROGRAM_ID);
     PROGRAM_ID = 0;
@@ -0,0 +1,84 @@
+#include "ShaderPermutations.hpp"
+
+#include <OPPCH.h>
+
+ShaderPermutations::ShaderPermutations(std::string vertPath, std::string fragPath, std::vector<std::string> features,
+                                       ShaderDefines baseDefines, Setup setup)
+    : vertPath_(std::move(vertPath)),
+      fragPath_(std::move(fragPath)),
+      features_(std::move(features)),
+      baseDefines_(std::move(baseDefines)),
+      setup_(std::move(setup)) {}
+
+std::string ShaderPermutations::keyFor(uint32_t mask, const ShaderDefines &values) const {
+  std::string key = std::to_string(mask);
+  for (const auto &[name, value] : values) key += "|" + name + "=" + value;
+  return key;
+}
+
+ShaderDefines ShaderPermutations::definesFor(uint32_t mask, const ShaderDefines &values) const {
+  ShaderDefines defines = baseDefines_;
+  for (size_t i = 0; i < features_.size() && i < 32; i++) {
+    if (mask & (1u << i)) defines.emplace_back(features_[i], "");
+  }
+  defines.insert(defines.end(), values.begin(), values.end());
+  return defines;
+}
+
+Shader &ShaderPermutations::select(uint32_t mask, const ShaderDefines &values) {
+  const std::string key = keyFor(mask, values);
+  auto it = variants_.find(key);
+  if (it == variants_.end()) {
+    Variant variant;
+    variant.mask = mask;
+    const ShaderDefines defines = definesFor(mask, values);
+    // 還沒有任何可用的版本時只能同步等，之後切換都在背景 compile
+    if (active_) {
+      variant.shader = std::make_unique<Shader>(Shader::async, vertPath_.c_str(), fragPath_.c_str(), defines);
+    } else {
+      variant.shader = std::make_unique<Shader>(vertPath_.c_str(), fragPath_.c_str(), defines);
+    }
+    it = variants_.emplace(key, std::move(variant)).first;
+  }
+
+  Variant &variant = it->second;
+  variant.lastUsed = ++tick_;
+  // PROGRAM_ID 為 0 表示 compile 失敗，hot reload 修好之後才會換上
+  if (variant.shader->isReady() && variant.shader->PROGRAM_ID) {
+    if (!variant.configured) {
+      variant.configured = true;
+      if (setup_) setup_(*variant.shader);
+    }
+    activeKey_ = key;
+    active_ = variant.shader.get();
+    activeMask_ = mask;
+  }
+  evict();
+  return active_ ? *active_ : *variant.shader;
+}
+
+int ShaderPermutations::compiling() {
+  int count = 0;
+  for (auto &[key, variant] : variants_) count += variant.shader->isReady() ? 0 : 1;
+  return count;
+}
+
+void ShaderPermutations::evict() {
+  while (variants_.size() > maxVariants_) {
+    auto oldest = variants_.end();
+    for (auto it = variants_.begin(); it != variants_.end(); ++it) {
+      // 正在用的版本與這一幀要求的版本（lastUsed == tick_）不能丟
+      if (it->first == activeKey_ || it->second.lastUsed == tick_) continue;
+      if (oldest == variants_.end() || it->second.lastUsed < oldest->second.lastUsed) oldest = it;
+    }
+    if (oldest == variants_.end()) return;
+    variants_.erase(oldest);
+  }
+}
+
+void ShaderPermutations::clear() {
+  variants_.clear();
+  activeKey_.clear();
+  active_ = nullptr;
+  activeMask_ = 0;
+}
@@ -0,0 +1,139 @@
+#include "ShaderPreprocessor.hpp"
+
+#include <OPPCH.h>
+
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string normalizePath(const fs::path &path) { return path.lexically_normal().generic_string(); }
+
+bool startsWith(const std::string &s, size_t pos, const char *prefix) {
+  return s.compare(pos, std::strlen(prefix), prefix) == 0;
+}
+
+// #pragma 後面的第一個 token 必須剛好是 once，後面只能接空白或註解；其他 #pragma 原樣留給 GLSL compiler
+bool isPragmaOnce(const std::string &line, size_t start) {
+  const size_t end = start + std::strlen("#pragma");
+  if (!startsWith(line, start, "#pragma")) return false;
+  size_t pos = line.find_first_not_of(" \t", end);
+  if (pos == std::string::npos || pos == end || !startsWith(line, pos, "once")) return false;
+  pos = line.find_first_not_of(" \t\r", pos + std::strlen("once"));
+  return pos == std::string::npos || startsWith(line, pos, "//") || startsWith(line, pos, "/*");
+}
+
+// 先找相對於目前檔案的目錄，找不到再當作相對於工作目錄
+std::string resolveInclude(const std::string &from, const std::string &target) {
+  const fs::path local = fs::path(from).parent_path() / target;
+  std::error_code ec;
+  if (fs::exists(local, ec)) return normalizePath(local);
+  return normalizePath(target);
+}
+
+}  // namespace
+
+ShaderPreprocessor &ShaderPreprocessor::instance() {
+  static ShaderPreprocessor preprocessor;
+  return preprocessor;
+}
+
+void ShaderPreprocessor::invalidate(const std::string &path) { files_.erase(normalizePath(path)); }
+
+std::shared_ptr<const ShaderPreprocessor::ParsedFile> ShaderPreprocessor::parse(const std::string &path) {
+  std::error_code ec;
+  const auto mtime = fs::last_write_time(path, ec);
+  const uintmax_t size = ec ? 0 : fs::file_size(path, ec);
+  auto it = files_.find(path);
+  if (!ec && it != files_.end() && it->second->mtime == mtime && it->second->size == size) return it->second;
+
+  std::ifstream file(path, std::ios::in);
+  if (ec || !file.is_open()) {
+    std::cerr << "Could not read file " << path << ". File does not exist.\n";
+    return nullptr;
+  }
+
+  auto parsed = std::make_shared<ParsedFile>();
+  parsed->mtime = mtime;
+  parsed->size = size;
+  Chunk current;
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(file, line)) {
+    lineNo++;
+    const size_t start = line.find_first_not_of(" \t");
+    if (start != std::string::npos && startsWith(line, start, "#include")) {
+      // 形如: #include "path"
+      auto left = line.find('"');
+      auto right = line.find_last_of('"');
+      if (left != std::string::npos && right != std::string::npos && right > left) {
+        if (!current.text.empty()) parsed->chunks.push_back(std::move(current));
+        Chunk include;
+        include.firstLine = lineNo;
+        include.include = resolveInclude(path, line.substr(left + 1, right - left - 1));
+        parsed->chunks.push_back(std::move(include));
+        current = Chunk{};
+        current.firstLine = lineNo + 1;
+        continue;
+      }
+    } else if (start != std::string::npos && isPragmaOnce(line, start)) {
+      parsed->pragmaOnce = true;
+      line.clear();  // 留空行，行號不變
+    } else if (start != std::string::npos && startsWith(line, start, "#version")) {
+      parsed->version = line;
+      line.clear();
+    }
+    current.text += line;
+    current.text += '\n';
+  }
+  if (!current.text.empty()) parsed->chunks.push_back(std::move(current));
+
+  files_[path] = parsed;
+  return parsed;
+}
+
+void ShaderPreprocessor::expand(const std::string &path, PreprocessedShader &out, std::vector<std::string> &stack,
+                                std::unordered_set<std::string> &included) {
+  if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+    std::cerr << "Shader include cycle: " << path << " (from " << stack.back() << ")\n";
+    out.ok = false;
+    return;
+  }
+  const auto parsed = parse(path);
+  if (!parsed) {
+    out.ok = false;
+    return;
+  }
+  if (parsed->pragmaOnce && !included.insert(path).second) return;
+
+  auto fileIt = std::find(out.files.begin(), out.files.end(), path);
+  const size_t index = fileIt - out.files.begin();
+  if (fileIt == out.files.end()) out.files.push_back(path);
+
+  stack.push_back(path);
+  for (const Chunk &chunk : parsed->chunks) {
+    if (!chunk.include.empty()) {
+      expand(chunk.include, out, stack, included);
+      continue;
+    }
+    out.source += "#line " + std::to_string(chunk.firstLine) + " " + std::to_string(index) + "\n";
+    out.source += chunk.text;
+  }
+  stack.pop_back();
+}
+
+PreprocessedShader ShaderPreprocessor::process(const std::string &path, const ShaderDefines &defines) {
+  PreprocessedShader out;
+  const std::string root = normalizePath(path);
+  std::vector<std::string> stack;
+  std::unordered_set<std::string> included;
+  expand(root, out, stack, included);
+
+  // #version 一定要在最前面，define 接在後面；展開的內容都有 #line，不影響行號
+  const auto parsed = parse(root);
+  std::string header = parsed && !parsed->version.empty() ? parsed->version + "\n" : "";
+  for (const auto &[name, value] : defines) header += "#define " + name + (value.empty() ? "" : " " + value) + "\n";
+  out.source.insert(0, header);
+  return out;
+}
@@ -0,0 +1,153 @@
+#include "ShaderWatcher.hpp"
+
+#include <OPPCH.h>
+
+#include "ShaderClass.hpp"
+#include "ShaderPreprocessor.hpp"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 沒有 inotify 時多久比對一次 mtime
+constexpr auto SCAN_INTERVAL = std::chrono::milliseconds(500);
+
+#ifdef __linux__
+std::string directoryOf(const std::string &file) {
+  const std::string dir = fs::path(file).parent_path().generic_string();
+  return dir.empty() ? "." : dir;
+}
+#endif
+
+}  // namespace
+
+ShaderWatcher &ShaderWatcher::instance() {
+  static ShaderWatcher watcher;
+  return watcher;
+}
+
+ShaderWatcher::ShaderWatcher() {
+#ifdef __linux__
+  inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyFd_ < 0) std::cerr << "inotify_init1 failed, falling back to mtime polling" << std::endl;
+#endif
+}
+
+ShaderWatcher::~ShaderWatcher() {
+#ifdef __linux__
+  if (inotifyFd_ >= 0) close(inotifyFd_);
+#endif
+}
+
+void ShaderWatcher::add(Shader *shader) {
+  shaders_.insert(shader);
+  dirty_ = true;
+}
+
+void ShaderWatcher::remove(Shader *shader) {
+  shaders_.erase(shader);
+  reloading_.erase(shader);
+}
+
+ShaderWatcherStats ShaderWatcher::stats() const {
+  ShaderWatcherStats stats = stats_;
+  stats.pending = static_cast<int>(reloading_.size());
+  return stats;
+}
+
+void ShaderWatcher::refreshWatches() {
+  dirty_ = false;
+  for (Shader *shader : shaders_) {
+    for (const std::string &file : shader->dependencies()) {
+      if (inotifyFd_ < 0) {
+        if (!mtimes_.count(file)) {
+          std::error_code ec;
+          mtimes_[file] = fs::last_write_time(file, ec);
+        }
+        continue;
+      }
+#ifdef __linux__
+      // 監看目錄而不是檔案：編輯器常寫到暫存檔再 rename 蓋過去，檔案本身的 watch 會跟著舊 inode 消失
+      const std::string dir = directoryOf(file);
+      if (!watchedDirs_.insert(dir).second) continue;
+      const int wd = inotify_add_watch(inotifyFd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+      if (wd < 0) {
+        std::cerr << "inotify_add_watch failed: " << dir << std::endl;
+        continue;
+      }
+      watches_[wd] = dir;
+#endif
+    }
+  }
+}
+
+std::vector<std::string> ShaderWatcher::pollChanges() {
+  std::vector<std::string> changed;
+#ifdef __linux__
+  if (inotifyFd_ >= 0) {
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+      const ssize_t len = read(inotifyFd_, buffer, sizeof(buffer));
+      if (len <= 0) break;  // EAGAIN：沒有更多事件
+      for (ssize_t offset = 0; offset < len;) {
+        const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+        offset += sizeof(inotify_event) + event->len;
+        auto it = watches_.find(event->wd);
+        if (it == watches_.end() || event->len == 0) continue;
+        const std::string path = (fs::path(it->second) / event->name).lexically_normal().generic_string();
+        if (std::find(changed.begin(), changed.end(), path) == changed.end()) changed.push_back(path);
+      }
+    }
+    return changed;
+  }
+#endif
+
+  const auto now = std::chrono::steady_clock::now();
+  if (now - lastScan_ < SCAN_INTERVAL) return changed;
+  lastScan_ = now;
+  for (auto &[file, mtime] : mtimes_) {
+    std::error_code ec;
+    const auto current = fs::last_write_time(file, ec);
+    if (ec || current == mtime) continue;
+    mtime = current;
+    changed.push_back(file);
+  }
+  return changed;
+}
+
+void ShaderWatcher::update() {
+  if (dirty_) refreshWatches();
+  const std::vector<std::string> changed = pollChanges();
+
+  if (enabled_ && !changed.empty()) {
+    for (const std::string &file : changed) ShaderPreprocessor::instance().invalidate(file);
+    for (Shader *shader : shaders_) {
+      const auto &deps = shader->dependencies();
+      for (const std::string &file : changed) {
+        if (std::find(deps.begin(), deps.end(), file) == deps.end()) continue;
+        std::cout << "Reloading shader (" << file << " changed)" << std::endl;
+        stats_.lastFile = file;
+        shader->beginReload();
+        if (shader->reloadPending()) reloading_.insert(shader);
+        dirty_ = true;  // 新的 #include 也要監看
+        break;
+      }
+    }
+  }
+
+  for (auto it = reloading_.begin(); it != reloading_.end();) {
+    const Shader::ReloadStatus status = (*it)->pollReload();
+    if (status == Shader::ReloadStatus::Pending) {
+      ++it;
+      continue;
+    }
+    if (status == Shader::ReloadStatus::Swapped) stats_.reloads++;
+    if (status == Shader::ReloadStatus::Failed) stats_.failures++;
+    it = reloading_.erase(it);
+  }
+}
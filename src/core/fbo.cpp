@@ -1,24 +1,141 @@
 #include "core/fbo.hpp"
 
+#include <iostream>
+
 namespace gfx::core {
-FBO::FBO(float width, float height) : width(width), height(height) {
-  glGenFramebuffers(1, &ID);
-  glGenTextures(1, &textureID);
+namespace {
+
+struct PixelFormat {
+  GLenum format;
+  GLenum type;
+  size_t bytes;  // 每個 pixel（每個 sample）
+};
+
+// glTexImage2D 需要與 internal format 相容的 format / type（資料是 NULL，只是用來通過驗證）
+PixelFormat pixelFormat(GLenum internalFormat) {
+  switch (internalFormat) {
+    case GL_R8:
+      return {GL_RED, GL_UNSIGNED_BYTE, 1};
+    case GL_RG8:
+      return {GL_RG, GL_UNSIGNED_BYTE, 2};
+    case GL_RGB:
+    case GL_RGB8:
+      return {GL_RGB, GL_UNSIGNED_BYTE, 4};  // 實際上驅動多半補成 4 bytes
+    case GL_RGBA:
+    case GL_RGBA8:
+    case GL_SRGB8_ALPHA8:
+      return {GL_RGBA, GL_UNSIGNED_BYTE, 4};
+    case GL_R16F:
+      return {GL_RED, GL_FLOAT, 2};
+    case GL_RG16F:
+      return {GL_RG, GL_FLOAT, 4};
+    case GL_RGBA16F:
+      return {GL_RGBA, GL_FLOAT, 8};
+    case GL_R32F:
+      return {GL_RED, GL_FLOAT, 4};
+    case GL_RG32F:
+      return {GL_RG, GL_FLOAT, 8};
+    case GL_RGBA32F:
+      return {GL_RGBA, GL_FLOAT, 16};
+    case GL_R11F_G11F_B10F:
+      return {GL_RGB, GL_FLOAT, 4};
+    case GL_DEPTH_COMPONENT16:
+      return {GL_DEPTH_COMPONENT, GL_FLOAT, 2};
+    case GL_DEPTH_COMPONENT24:
+      return {GL_DEPTH_COMPONENT, GL_FLOAT, 4};
+    case GL_DEPTH_COMPONENT32F:
+      return {GL_DEPTH_COMPONENT, GL_FLOAT, 4};
+    case GL_DEPTH24_STENCIL8:
+      return {GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, 4};
+    case GL_DEPTH32F_STENCIL8:
+      return {GL_DEPTH_STENCIL, GL_FLOAT_32_UNSIGNED_INT_24_8_REV, 8};
+    default:
+      std::cerr << "FBO: unsupported internal format 0x" << std::hex << internalFormat << std::dec << std::endl;
+      return {GL_RGBA, GL_UNSIGNED_BYTE, 4};
+  }
+}
+
+bool hasStencil(GLenum depthFormat) {
+  return depthFormat == GL_DEPTH24_STENCIL8 || depthFormat == GL_DEPTH32F_STENCIL8;
+}
+
+GLenum depthAttachment(GLenum depthFormat) {
+  return hasStencil(depthFormat) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+}
+
+GLuint createTexture(GLenum internalFormat, int width, int height, GLenum filter) {
+  const PixelFormat pf = pixelFormat(internalFormat);
+  GLuint texture;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, pf.format, pf.type, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  return texture;
 }
 
-FBO::FBO(FBO &&o) noexcept : ID(o.ID), textureID(o.textureID), width(o.width), height(o.height) {
+GLuint createRenderbuffer(GLenum internalFormat, int width, int height, int samples) {
+  GLuint renderbuffer;
+  glGenRenderbuffers(1, &renderbuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+  glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, internalFormat, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  return renderbuffer;
+}
+
+// 所有 color attachment 都開啟寫入；沒有 color 時關掉，否則 depth-only 的 FBO 不完整
+void setDrawBuffers(size_t count) {
+  std::vector<GLenum> drawBuffers(count);
+  for (size_t i = 0; i < count; i++) drawBuffers[i] = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+  if (count > 0) {
+    glDrawBuffers(static_cast<GLsizei>(count), drawBuffers.data());
+  } else {
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+  }
+}
+
+}  // namespace
+
+FBO::FBO(const FBOSpec &spec)
+    : width(static_cast<float>(spec.width)), height(static_cast<float>(spec.height)), spec_(spec) {
+  allocate();
+}
+
+FBO::FBO(FBO &&o) noexcept
+    : ID(o.ID),
+      textureID(o.textureID),
+      depthTextureID(o.depthTextureID),
+      width(o.width),
+      height(o.height),
+      spec_(std::move(o.spec_)),
+      colorTextures_(std::move(o.colorTextures_)),
+      renderbuffers_(std::move(o.renderbuffers_)),
+      resolveID_(o.resolveID_) {
   o.ID = 0;
   o.textureID = 0;
+  o.depthTextureID = 0;
+  o.resolveID_ = 0;
 }
 FBO &FBO::operator=(FBO &&o) noexcept {
   if (this != &o) {
     reset();
     ID = o.ID;
     textureID = o.textureID;
+    depthTextureID = o.depthTextureID;
     width = o.width;
     height = o.height;
+    spec_ = std::move(o.spec_);
+    colorTextures_ = std::move(o.colorTextures_);
+    renderbuffers_ = std::move(o.renderbuffers_);
+    resolveID_ = o.resolveID_;
     o.ID = 0;
     o.textureID = 0;
+    o.depthTextureID = 0;
+    o.resolveID_ = 0;
   }
   return *this;
 }
@@ -26,27 +143,123 @@ void FBO::bind() const { glBindFramebuffer(GL_FRAMEBUFFER, ID); }
 
 void FBO::unbind() const { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
 
-void FBO::setupTexture() {
+void FBO::bindTexture(GLenum textureUnit) const {
+  glActiveTexture(textureUnit);
   glBindTexture(GL_TEXTURE_2D, textureID);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  bind();
-  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureID, 0);
-  unbind();
 }
 
-void FBO::bindTexture(GLenum textureUnit) {
-  glActiveTexture(textureUnit);
-  glBindTexture(GL_TEXTURE_2D, textureID);
+void FBO::resize(int newWidth, int newHeight) {
+  if (newWidth == spec_.width && newHeight == spec_.height) return;
+  reset();
+  spec_.width = newWidth;
+  spec_.height = newHeight;
+  width = static_cast<float>(newWidth);
+  height = static_cast<float>(newHeight);
+  allocate();
+}
+
+void FBO::allocate() {
+  const int w = spec_.width, h = spec_.height;
+  const bool multisample = spec_.samples > 1;
+
+  // 可取樣的 texture：單一 sample 時直接是 ID 的 attachment，MSAA 時放在 resolve 用的 FBO
+  for (GLenum format : spec_.colorFormats) colorTextures_.push_back(createTexture(format, w, h, GL_LINEAR));
+  if (spec_.depthFormat != GL_NONE) depthTextureID = createTexture(spec_.depthFormat, w, h, GL_NEAREST);
+  textureID = colorTextures_.empty() ? 0 : colorTextures_[0];
+
+  GLuint textureFBO;
+  glGenFramebuffers(1, &textureFBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, textureFBO);
+  for (size_t i = 0; i < colorTextures_.size(); i++) {
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i), GL_TEXTURE_2D,
+                           colorTextures_[i], 0);
+  }
+  if (depthTextureID) {
+    glFramebufferTexture2D(GL_FRAMEBUFFER, depthAttachment(spec_.depthFormat), GL_TEXTURE_2D, depthTextureID, 0);
+  }
+  setDrawBuffers(colorTextures_.size());
+
+  if (!multisample) {
+    ID = textureFBO;
+  } else {
+    resolveID_ = textureFBO;
+    glGenFramebuffers(1, &ID);
+    glBindFramebuffer(GL_FRAMEBUFFER, ID);
+    for (size_t i = 0; i < spec_.colorFormats.size(); i++) {
+      renderbuffers_.push_back(createRenderbuffer(spec_.colorFormats[i], w, h, spec_.samples));
+      glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i), GL_RENDERBUFFER,
+                                renderbuffers_.back());
+    }
+    if (spec_.depthFormat != GL_NONE) {
+      renderbuffers_.push_back(createRenderbuffer(spec_.depthFormat, w, h, spec_.samples));
+      glFramebufferRenderbuffer(GL_FRAMEBUFFER, depthAttachment(spec_.depthFormat), GL_RENDERBUFFER,
+                                renderbuffers_.back());
+    }
+    setDrawBuffers(spec_.colorFormats.size());
+  }
+  checkStatus();
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FBO::resolve() const {
+  if (!resolveID_) return;
+  const GLint w = spec_.width, h = spec_.height;
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, ID);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveID_);
+  // blit 一次只搬 read buffer → 各個 draw buffer，MRT 要逐一切換
+  for (size_t i = 0; i < colorTextures_.size(); i++) {
+    const GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+    glReadBuffer(attachment);
+    glDrawBuffers(1, &attachment);
+    glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  }
+  if (depthTextureID) {
+    const GLbitfield mask = GL_DEPTH_BUFFER_BIT | (hasStencil(spec_.depthFormat) ? GL_STENCIL_BUFFER_BIT : 0);
+    glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, mask, GL_NEAREST);
+  }
+  // 還原成所有 attachment 都寫入
+  glBindFramebuffer(GL_FRAMEBUFFER, resolveID_);
+  setDrawBuffers(colorTextures_.size());
+  glBindFramebuffer(GL_FRAMEBUFFER, ID);
+  if (!colorTextures_.empty()) glReadBuffer(GL_COLOR_ATTACHMENT0);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool FBO::checkStatus() const {
+  glBindFramebuffer(GL_FRAMEBUFFER, ID);
+  const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    std::cerr << "Framebuffer not complete: 0x" << std::hex << status << std::dec << std::endl;
+  }
+  return status == GL_FRAMEBUFFER_COMPLETE;
+}
+
+size_t FBO::memoryBytes() const {
+  size_t bytesPerPixel = 0;
+  for (GLenum format : spec_.colorFormats) bytesPerPixel += pixelFormat(format).bytes;
+  if (spec_.depthFormat != GL_NONE) bytesPerPixel += pixelFormat(spec_.depthFormat).bytes;
+  const size_t pixels = static_cast<size_t>(spec_.width) * spec_.height;
+  // MSAA 多一份 multisample renderbuffer
+  return pixels * bytesPerPixel * (spec_.samples > 1 ? spec_.samples + 1 : 1);
 }
 
 void FBO::reset() {
-  if (textureID) {
-    glDeleteTextures(1, &textureID);
-    textureID = 0;
+  if (!colorTextures_.empty()) {
+    glDeleteTextures(static_cast<GLsizei>(colorTextures_.size()), colorTextures_.data());
+    colorTextures_.clear();
+  }
+  if (!renderbuffers_.empty()) {
+    glDeleteRenderbuffers(static_cast<GLsizei>(renderbuffers_.size()), renderbuffers_.data());
+    renderbuffers_.clear();
+  }
+  if (depthTextureID) {
+    glDeleteTextures(1, &depthTextureID);
+    depthTextureID = 0;
+  }
+  textureID = 0;
+  if (resolveID_) {
+    glDeleteFramebuffers(1, &resolveID_);
+    resolveID_ = 0;
   }
   if (ID) {
     glDeleteFramebuffers(1, &ID);
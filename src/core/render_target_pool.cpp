@@ -0,0 +1,53 @@
+#include "core/render_target_pool.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace gfx::core {
+FBO &RenderTargetPool::acquire(const FBOSpec &spec) {
+  for (auto &entry : entries_) {
+    if (!entry.inUse && entry.target->spec() == spec) {
+      entry.inUse = true;
+      entry.lastUsedFrame = frame_;
+      return *entry.target;
+    }
+  }
+  Entry entry;
+  entry.target = std::make_unique<FBO>(spec);
+  entry.inUse = true;
+  entry.lastUsedFrame = frame_;
+  entries_.push_back(std::move(entry));
+  return *entries_.back().target;
+}
+
+void RenderTargetPool::release(const FBO &target) {
+  for (auto &entry : entries_) {
+    if (entry.target.get() == &target) {
+      entry.inUse = false;
+      entry.lastUsedFrame = frame_;
+      return;
+    }
+  }
+  std::cerr << "RenderTargetPool: releasing a target that does not belong to the pool" << std::endl;
+}
+
+void RenderTargetPool::endFrame(uint32_t maxIdleFrames) {
+  frame_++;
+  entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                [&](const Entry &entry) {
+                                  return !entry.inUse && frame_ - entry.lastUsedFrame > maxIdleFrames;
+                                }),
+                 entries_.end());
+}
+
+size_t RenderTargetPool::inUse() const {
+  return static_cast<size_t>(
+      std::count_if(entries_.begin(), entries_.end(), [](const Entry &entry) { return entry.inUse; }));
+}
+
+size_t RenderTargetPool::memoryBytes() const {
+  size_t bytes = 0;
+  for (const auto &entry : entries_) bytes += entry.target->memoryBytes();
+  return bytes;
+}
+}  // namespace gfx::core
@@ -0,0 +1,27 @@
+#include "core/ssbo.hpp"
+
+namespace gfx::core {
+SSBO::SSBO() { glGenBuffers(1, &ID); }
+
+SSBO::SSBO(SSBO &&o) noexcept : ID(o.ID) { o.ID = 0; }
+SSBO &SSBO::operator=(SSBO &&o) noexcept {
+  if (this != &o) {
+    reset();
+    ID = o.ID;
+    o.ID = 0;
+  }
+  return *this;
+}
+void SSBO::bind() const { glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID); }
+
+void SSBO::unbind() const { glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0); }
+
+void SSBO::bindBase(GLuint index) const { glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, ID); }
+
+void SSBO::reset() {
+  if (ID) {
+    glDeleteBuffers(1, &ID);
+    ID = 0;
+  }
+}
+}  // namespace gfx::core
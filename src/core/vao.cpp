@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 
 #include "core/vbo.hpp"
+#include "core/vertex_layout.hpp"
 
 namespace gfx::core {
 VAO::VAO() { glGenVertexArrays(1, &ID); }
@@ -17,13 +18,20 @@ VAO &VAO::operator=(VAO &&other) noexcept {
   }
   return *this;
 }
-void VAO::linkAttr(VBO &vbo, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, const void *offset) {
+void VAO::linkAttr(VBO &vbo, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, const void *offset,
+                   GLboolean normalized) {
   vbo.bind();
   glEnableVertexAttribArray(layout);
-  glVertexAttribPointer(layout, numComponents, type, GL_FALSE, stride, offset);
+  glVertexAttribPointer(layout, numComponents, type, normalized, stride, offset);
   vbo.unbind();
 }
 
+void VAO::linkLayout(VBO &vbo, const VertexLayout &vertexLayout) {
+  for (const auto &a : vertexLayout.attribs) {
+    linkAttr(vbo, a.location, a.numComponents, a.type, vertexLayout.stride, (void *)(intptr_t)a.offset, a.normalized);
+  }
+}
+
 void VAO::linkAttrDiv(VBO &vbo, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, const void *offset) {
   vbo.bind();
   glEnableVertexAttribArray(layout);
@@ -0,0 +1,42 @@
+#include "core/vertex_layout.hpp"
+
+#include <stdexcept>
+
+namespace gfx::core {
+
+VertexLayout &VertexLayout::add(GLuint location, GLint numComponents, GLenum type, GLboolean normalized) {
+  attribs.push_back({location, numComponents, type, normalized, stride});
+  stride += attribSize(numComponents, type);
+  return *this;
+}
+
+bool VertexLayout::has(GLuint location) const {
+  for (const auto &a : attribs) {
+    if (a.location == location) return true;
+  }
+  return false;
+}
+
+GLsizei VertexLayout::attribSize(GLint numComponents, GLenum type) {
+  switch (type) {
+    case GL_FLOAT:
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+      return 4 * numComponents;
+    case GL_HALF_FLOAT:
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+      return 2 * numComponents;
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+      return numComponents;
+    // packed：4 個分量塞在一個 32-bit word
+    case GL_INT_2_10_10_10_REV:
+    case GL_UNSIGNED_INT_2_10_10_10_REV:
+      return 4;
+    default:
+      throw std::invalid_argument("Unsupported vertex attribute type");
+  }
+}
+
+}  // namespace gfx::core
@@ -0,0 +1,51 @@
+#include "geom/bounds.hpp"
+
+#include <OPPCH.h>
+
+namespace gfx::geom {
+
+Bounds Bounds::fromVertices(const std::vector<Vertex> &vertices) {
+  Bounds b;
+  if (vertices.empty()) return b;
+
+  b.min = b.max = vertices[0].position;
+  for (const auto &v : vertices) {
+    b.min = glm::min(b.min, v.position);
+    b.max = glm::max(b.max, v.position);
+  }
+  b.center = (b.min + b.max) * 0.5f;
+
+  for (const auto &v : vertices) {
+    b.radius = std::max(b.radius, glm::length(v.position - b.center));
+  }
+  return b;
+}
+
+Bounds Bounds::merge(const Bounds &a, const Bounds &b) {
+  Bounds r;
+  r.min = glm::min(a.min, b.min);
+  r.max = glm::max(a.max, b.max);
+  r.center = (r.min + r.max) * 0.5f;
+  r.radius = std::max(glm::length(a.center - r.center) + a.radius, glm::length(b.center - r.center) + b.radius);
+  return r;
+}
+
+Bounds Bounds::transformed(const glm::mat4 &m) const {
+  // Arvo, "Transforming Axis-Aligned Bounding Boxes"
+  Bounds r;
+  r.min = r.max = glm::vec3(m[3]);
+  for (int col = 0; col < 3; col++) {
+    for (int row = 0; row < 3; row++) {
+      const float a = m[col][row] * min[col];
+      const float b = m[col][row] * max[col];
+      r.min[row] += std::min(a, b);
+      r.max[row] += std::max(a, b);
+    }
+  }
+  r.center = glm::vec3(m * glm::vec4(center, 1.0f));
+  const float s0 = glm::length(glm::vec3(m[0])), s1 = glm::length(glm::vec3(m[1])), s2 = glm::length(glm::vec3(m[2]));
+  r.radius = radius * std::max(s0, std::max(s1, s2));
+  return r;
+}
+
+}  // namespace gfx::geom
@@ -0,0 +1,157 @@
+#include "geom/bvh.hpp"
+
+#include <OPPCH.h>
+
+#include <numeric>
+
+namespace gfx::geom {
+
+namespace {
+
+constexpr int MAX_BINS = 32;
+// SAH 認為不該切時，超過這個數量仍然硬切，避免出現超大的 leaf
+constexpr size_t MAX_LEAF_SIZE = 16;
+
+struct Bin {
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{-std::numeric_limits<float>::max()};
+  uint32_t count = 0;
+
+  void grow(const glm::vec3 &lo, const glm::vec3 &hi) {
+    min = glm::min(min, lo);
+    max = glm::max(max, hi);
+  }
+};
+
+float halfArea(const glm::vec3 &lo, const glm::vec3 &hi) {
+  const glm::vec3 e = glm::max(hi - lo, glm::vec3(0.0f));
+  return e.x * e.y + e.y * e.z + e.z * e.x;
+}
+
+}  // namespace
+
+BVHData buildBVH(const std::vector<BVHPrimitive> &primitives, size_t maxLeafSize, int numBins) {
+  BVHData bvh;
+  const size_t n = primitives.size();
+  if (n == 0) return bvh;
+  maxLeafSize = std::max<size_t>(maxLeafSize, 1);
+  numBins = std::clamp(numBins, 2, MAX_BINS);
+
+  bvh.indices.resize(n);
+  std::iota(bvh.indices.begin(), bvh.indices.end(), 0u);
+  std::vector<glm::vec3> centroids(n);
+  for (size_t i = 0; i < n; i++) centroids[i] = (primitives[i].min + primitives[i].max) * 0.5f;
+
+  bvh.nodes.reserve(2 * n - 1);
+  bvh.nodes.push_back({glm::vec3(0.0f), 0, glm::vec3(0.0f), static_cast<int32_t>(n)});
+
+  struct Task {
+    uint32_t node;
+    int depth;
+  };
+  std::vector<Task> stack{{0, 1}};
+  while (!stack.empty()) {
+    const Task task = stack.back();
+    stack.pop_back();
+    bvh.depth = std::max(bvh.depth, task.depth);
+
+    const uint32_t first = bvh.nodes[task.node].leftOrFirst;
+    const uint32_t count = bvh.nodes[task.node].count;
+    Bin nodeBounds, centroidBounds;
+    for (uint32_t i = first; i < first + count; i++) {
+      const BVHPrimitive &p = primitives[bvh.indices[i]];
+      nodeBounds.grow(p.min, p.max);
+      centroidBounds.grow(centroids[bvh.indices[i]], centroids[bvh.indices[i]]);
+    }
+    bvh.nodes[task.node].boundsMin = nodeBounds.min;
+    bvh.nodes[task.node].boundsMax = nodeBounds.max;
+
+    const glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+    const bool overlapping = glm::max(extent.x, glm::max(extent.y, extent.z)) <= 0.0f;
+    if (count <= maxLeafSize || task.depth >= BVH_MAX_DEPTH || overlapping) continue;
+
+    // 在三個軸上各自分格，左右各掃一次算出每個切點的 SAH 成本
+    int bestAxis = -1, bestSplit = 0;
+    float bestCost = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; axis++) {
+      if (extent[axis] <= 0.0f) continue;
+      const float scale = numBins / extent[axis];
+      Bin bins[MAX_BINS];
+      for (uint32_t i = first; i < first + count; i++) {
+        const uint32_t prim = bvh.indices[i];
+        const float offset = centroids[prim][axis] - centroidBounds.min[axis];
+        const int b = std::min(numBins - 1, static_cast<int>(offset * scale));
+        bins[b].grow(primitives[prim].min, primitives[prim].max);
+        bins[b].count++;
+      }
+      float leftArea[MAX_BINS], rightArea[MAX_BINS];
+      uint32_t leftCount[MAX_BINS], rightCount[MAX_BINS];
+      Bin left, right;
+      uint32_t leftSum = 0, rightSum = 0;
+      for (int i = 0; i < numBins - 1; i++) {
+        leftSum += bins[i].count;
+        leftCount[i] = leftSum;
+        if (bins[i].count) left.grow(bins[i].min, bins[i].max);
+        leftArea[i] = leftSum ? halfArea(left.min, left.max) : 0.0f;
+
+        const int j = numBins - 1 - i;
+        rightSum += bins[j].count;
+        rightCount[j - 1] = rightSum;
+        if (bins[j].count) right.grow(bins[j].min, bins[j].max);
+        rightArea[j - 1] = rightSum ? halfArea(right.min, right.max) : 0.0f;
+      }
+      for (int i = 0; i < numBins - 1; i++) {
+        if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+        const float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestAxis = axis;
+          bestSplit = i;
+        }
+      }
+    }
+
+    const float leafCost = count * halfArea(nodeBounds.min, nodeBounds.max);
+    if (bestCost >= leafCost && count <= MAX_LEAF_SIZE) continue;
+
+    uint32_t mid;
+    if (bestAxis >= 0) {
+      const float scale = numBins / extent[bestAxis];
+      const float minC = centroidBounds.min[bestAxis];
+      auto it = std::partition(bvh.indices.begin() + first, bvh.indices.begin() + first + count, [&](uint32_t prim) {
+        return std::min(numBins - 1, static_cast<int>((centroids[prim][bestAxis] - minC) * scale)) <= bestSplit;
+      });
+      mid = static_cast<uint32_t>(it - bvh.indices.begin());
+    } else {
+      mid = first;
+    }
+    if (mid == first || mid == first + count) {
+      // 格子切不開（centroid 擠在同一格）：沿最長軸取中位數
+      const int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+      mid = first + count / 2;
+      std::nth_element(bvh.indices.begin() + first, bvh.indices.begin() + mid, bvh.indices.begin() + first + count,
+                       [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+    }
+
+    // 左右子節點相鄰，shader 端只需要存左邊的 index
+    const auto leftIndex = static_cast<uint32_t>(bvh.nodes.size());
+    const auto leftCount = static_cast<int32_t>(mid - first);
+    const auto rightCount = static_cast<int32_t>(first + count - mid);
+    bvh.nodes.push_back({glm::vec3(0.0f), static_cast<int32_t>(first), glm::vec3(0.0f), leftCount});
+    bvh.nodes.push_back({glm::vec3(0.0f), static_cast<int32_t>(mid), glm::vec3(0.0f), rightCount});
+    bvh.nodes[task.node].leftOrFirst = static_cast<int32_t>(leftIndex);
+    bvh.nodes[task.node].count = 0;
+    stack.push_back({leftIndex, task.depth + 1});
+    stack.push_back({leftIndex + 1, task.depth + 1});
+  }
+  return bvh;
+}
+
+void offsetBVH(BVHData &bvh, int32_t nodeOffset, int32_t indexOffset, uint32_t primitiveOffset) {
+  for (BVHNode &node : bvh.nodes) node.leftOrFirst += node.count > 0 ? indexOffset : nodeOffset;
+  if (primitiveOffset) {
+    for (uint32_t &index : bvh.indices) index += primitiveOffset;
+  }
+}
+
+}  // namespace gfx::geom
@@ -0,0 +1,40 @@
+#include "geom/frustum.hpp"
+
+#include <OPPCH.h>
+
+namespace gfx::geom {
+
+Frustum::Frustum(const glm::mat4 &m) {
+  // glm 是 column-major：m[col][row]
+  auto row = [&](int r) { return glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]); };
+  const glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+  planes[PLANE_LEFT] = r3 + r0;
+  planes[PLANE_RIGHT] = r3 - r0;
+  planes[PLANE_BOTTOM] = r3 + r1;
+  planes[PLANE_TOP] = r3 - r1;
+  planes[PLANE_NEAR] = r3 + r2;
+  planes[PLANE_FAR] = r3 - r2;
+
+  for (auto &p : planes) {
+    p /= glm::length(glm::vec3(p));
+  }
+}
+
+bool Frustum::sphereVisible(const glm::vec3 &center, float radius) const {
+  for (const auto &p : planes) {
+    if (glm::dot(glm::vec3(p), center) + p.w < -radius) return false;
+  }
+  return true;
+}
+
+bool Frustum::aabbVisible(const glm::vec3 &min, const glm::vec3 &max) const {
+  for (const auto &p : planes) {
+    // 取最靠近平面法向的角點（p-vertex）
+    glm::vec3 v(p.x >= 0.0f ? max.x : min.x, p.y >= 0.0f ? max.y : min.y, p.z >= 0.0f ? max.z : min.z);
+    if (glm::dot(glm::vec3(p), v) + p.w < 0.0f) return false;
+  }
+  return true;
+}
+
+}  // namespace gfx::geom
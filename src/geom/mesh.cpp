@@ -3,12 +3,14 @@
 #include <OPPCH.h>
 
 #include "BasicMesh.hpp"
+#include "resource/image_ops.hpp"
 #include "stb_image.h"
 
 namespace gfx::geom {
-Mesh::Mesh(const std::vector<Vertex> &vertices) : vertices(vertices), vao(), vbo(), instanceMatrixVBO(), ebo() {
+Mesh::Mesh(const std::vector<Vertex> &vertices)
+    : vertices(vertices), bounds(Bounds::fromVertices(vertices)), vao(), vbo(), instanceMatrixVBO(), ebo() {
   vao.bind();
-  vbo.bufferData(vertices);
+  uploadVertices();
 
   setupMeshAttributes();
 
@@ -16,37 +18,57 @@ Mesh::Mesh(const std::vector<Vertex> &vertices) : vertices(vertices), vao(), vbo
 }
 
 Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices)
-    : vertices(vertices), indices(indices), vao(), vbo(), ebo() {
+    : vertices(vertices), indices(indices), bounds(Bounds::fromVertices(vertices)), vao(), vbo(), ebo() {
   vao.bind();
   ebo.bind();
   ebo.bufferData(indices);
 
-  vbo.bufferData(vertices);
+  uploadVertices();
   setupMeshAttributes();
 
   vao.unbind();
 }
 
 Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices,
-           std::vector<std::shared_ptr<resource::Texture>> textures)
-    : vertices(vertices), indices(indices), textures(std::move(textures)), vao(), vbo(), ebo() {
+           std::vector<std::shared_ptr<resource::Texture>> textures, VertexFormat format)
+    : vertices(vertices),
+      indices(indices),
+      textures(std::move(textures)),
+      bounds(Bounds::fromVertices(vertices)),
+      vao(),
+      vbo(),
+      ebo(),
+      format_(format) {
   vao.bind();
   ebo.bind();
   ebo.bufferData(indices);
 
-  vbo.bufferData(vertices);
+  uploadVertices();
   setupMeshAttributes();
 
   vao.unbind();
 }
 
-void Mesh::setupMeshAttributes() {
-  vao.linkAttr(vbo, 0, 3, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, position));
-  vao.linkAttr(vbo, 1, 3, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, normal));
-  vao.linkAttr(vbo, 2, 3, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, color));
-  vao.linkAttr(vbo, 3, 2, GL_FLOAT, sizeof(Vertex), (void *)offsetof(Vertex, texCoords));
+void Mesh::uploadVertices() { vbo.bufferData(packVertices(vertices, format_)); }
+
+void Mesh::setupMeshAttributes() { vao.linkLayout(vbo, vertexLayout(format_)); }
+
+void Mesh::setVertexFormat(VertexFormat format) {
+  if (format == format_) return;
+  format_ = format;
+
+  vao.bind();
+  // 舊格式可能有新格式沒有的 attribute（例如 color），先全部關掉
+  for (const auto &a : vertexLayout(VertexFormat::Float32).attribs) {
+    glDisableVertexAttribArray(a.location);
+  }
+  uploadVertices();
+  setupMeshAttributes();
+  vao.unbind();
 }
 
+bool Mesh::hasVertexColor() const { return vertexLayout(format_).has(ATTRIB_COLOR); }
+
 unsigned int Mesh::numTriangles() { return indices.size() / 3; }
 
 void Mesh::setTexture(std::vector<std::shared_ptr<resource::Texture>> textures) {
@@ -55,12 +77,31 @@ void Mesh::setTexture(std::vector<std::shared_ptr<resource::Texture>> textures)
 
 bool Mesh::hasTexture() const { return !this->textures.empty(); }
 
+void Mesh::setIndices(const std::vector<GLuint> &indices) {
+  this->indices = indices;
+  lods.clear();
+  vao.bind();
+  ebo.bind();
+  ebo.bufferData(this->indices);
+  vao.unbind();
+}
+
+void Mesh::setLods(const LodChain &chain) {
+  if (chain.levels.empty()) return;
+  indices.assign(chain.indices.begin(), chain.indices.begin() + chain.levels[0].indexCount);
+  lods = chain.levels;
+  vao.bind();
+  ebo.bind();
+  ebo.bufferData(chain.indices);
+  vao.unbind();
+}
+
 void Mesh::setupInstanceMatrices(std::vector<glm::mat4> &instanceMatrices) {
   vao.bind();
   instanceMatrixVBO.bind();
   glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * instanceMatrices.size(), instanceMatrices.data(), GL_STATIC_DRAW);
 
-  vao.linkMat4(instanceMatrixVBO, 4);
+  vao.linkMat4(instanceMatrixVBO, ATTRIB_INSTANCE_MATRIX);
   vao.unbind();
 }
 
@@ -76,10 +117,12 @@ void Mesh::rotate(float angle, glm::vec3 axis) {
     vertex.position = glm::rotate(vertex.position, glm::radians(angle), axis);
     vertex.normal = glm::rotate(vertex.normal, glm::radians(angle), axis);
   }
+  bounds = Bounds::fromVertices(vertices);
 
+  std::vector<uint8_t> packed = packVertices(vertices, format_);
   vao.bind();
   vbo.bind();
-  glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Vertex) * vertices.size(), vertices.data());
+  glBufferSubData(GL_ARRAY_BUFFER, 0, packed.size(), packed.data());
   vbo.unbind();
 }
 
@@ -134,36 +177,32 @@ void Mesh::rotate(float angle, glm::vec3 axis) {
   Flip is true if you are using the skybox.
 */
 CubeMap::CubeMap(std::vector<std::string> &faces, bool flip) {
+  if (faces.size() == 1 && resource::isCompressedTexturePath(faces[0])) {
+    loadCompressed(faces[0]);
+    cubeMesh = createCubeMesh(1.0f);
+    return;
+  }
+
   glGenTextures(1, &textureID);
   glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
-  // origin order: right, left, top, bottom, front, back
-  char order[6] = {'r', 'l', 't', 'd', 'f', 'b'};
-
   // if flip is true, then the order is: right, left, top, bottom, front, back
   if (flip) std::swap(faces[4], faces[5]);
 
   int width, height, nrChannels;
+  std::vector<unsigned char> rgba;
   for (unsigned int i = 0; i < faces.size(); i++) {
     unsigned char *data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-    if (data) {
-      if (flip) {
-        switch (order[i]) {
-          case 'r':
-          case 'l':
-          case 'f':
-          case 'b':
-            flipHorizontally(data, width, height, nrChannels);
-            break;
-          case 't':
-          case 'd':
-            flipVertically(data, width, height, nrChannels);
-            break;
-          default:
-            break;
-        }
+    if (data && (nrChannels == 3 || nrChannels == 4)) {
+      // 補成 RGBA：row 一定 4-byte 對齊，翻轉也走 4 通道的 SIMD 路徑
+      unsigned char *pixels = data;
+      if (nrChannels == 3) {
+        rgba.resize(static_cast<size_t>(width) * height * 4);
+        resource::expandRgbToRgba(data, rgba.data(), static_cast<size_t>(width) * height);
+        pixels = rgba.data();
       }
-      glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+      if (flip) flipFace(pixels, width, height, 4, i);
+      glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
     } else {
       std::cerr << "Failed to load texture: " << faces[i] << std::endl;
     }
@@ -179,9 +218,24 @@ CubeMap::CubeMap(std::vector<std::string> &faces, bool flip) {
   cubeMesh = createCubeMesh(1.0f);
 }
 
+CubeMap::CubeMap(std::vector<std::string> &faces, resource::TextureStreamer &streamer, bool flip) {
+  if (flip) std::swap(faces[4], faces[5]);
+
+  resource::TextureStreamer::FaceTransform transform;
+  if (flip) {
+    transform = [](resource::DecodedImage &img, int face) {
+      flipFace(img.pixels.data(), img.width, img.height, img.channels, face);
+    };
+  }
+  texture = streamer.loadCubeMap(faces, 0, std::move(transform));
+
+  cubeMesh = createCubeMesh(1.0f);
+}
+
 CubeMap::~CubeMap() { reset(); }
 
-CubeMap::CubeMap(CubeMap &&other) noexcept : cubeMesh(std::move(other.cubeMesh)), textureID(other.textureID) {
+CubeMap::CubeMap(CubeMap &&other) noexcept
+    : textureID(other.textureID), texture(std::move(other.texture)), cubeMesh(std::move(other.cubeMesh)) {
   other.textureID = 0;
 }
 
@@ -190,11 +244,30 @@ CubeMap &CubeMap::operator=(CubeMap &&other) noexcept {
     reset();
     cubeMesh = std::move(other.cubeMesh);
     textureID = other.textureID;
+    texture = std::move(other.texture);
     other.textureID = 0;
   }
   return *this;
 }
 
+void CubeMap::loadCompressed(const std::string &path) {
+  resource::CompressedTexture tex;
+  if (!resource::readCompressedTexture(path, tex)) return;
+  if (tex.faceCount != 6 || !resource::compressedFormatSupported(tex.format, tex.srgb)) {
+    std::cerr << "Unsupported compressed cube map: " << path << std::endl;
+    return;
+  }
+
+  glGenTextures(1, &textureID);
+  glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+  resource::uploadCompressedTexture(GL_TEXTURE_CUBE_MAP, tex, tex.data.data());
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, tex.levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+}
+
 void CubeMap::reset() {
   if (textureID) {
     glDeleteTextures(1, &textureID);
@@ -202,33 +275,23 @@ void CubeMap::reset() {
   }
 }
 
-void CubeMap::flipHorizontally(unsigned char *data, int width, int height, int nrChannels) {
-  const int rowSize = width * nrChannels;
-  for (int y = 0; y < height; ++y) {
-    unsigned char *rowStart = data + y * rowSize;
-    for (int x = 0; x < width / 2; ++x) {
-      int left = x * nrChannels;
-      int right = (width - 1 - x) * nrChannels;
-      // change the left and right pixels
-      for (int c = 0; c < nrChannels; ++c) {
-        std::swap(rowStart[left + c], rowStart[right + c]);
-      }
-    }
+void CubeMap::flipFace(unsigned char *data, int width, int height, int nrChannels, int face) {
+  // origin order: right, left, top, bottom, front, back
+  static const char order[6] = {'r', 'l', 't', 'd', 'f', 'b'};
+  switch (order[face]) {
+    case 'r':
+    case 'l':
+    case 'f':
+    case 'b':
+      resource::flipImageHorizontal(data, width, height, nrChannels);
+      break;
+    case 't':
+    case 'd':
+      resource::flipImageVertical(data, width, height, nrChannels);
+      break;
+    default:
+      break;
   }
 }
 
-void CubeMap::flipVertically(unsigned char *data, int width, int height, int nrChannels) {
-  const int rowSize = width * nrChannels;
-  std::vector<unsigned char> tmp(rowSize);  // 暫存一行的數據
-
-  for (int y = 0; y < height / 2; ++y) {
-    unsigned char *topRowStart = data + y * rowSize;
-    unsigned char *bottomRowStart = data + (height - 1 - y) * rowSize;
-
-    // 交換整行數據
-    std::memcpy(tmp.data(), topRowStart, rowSize);
-    std::memcpy(topRowStart, bottomRowStart, rowSize);
-    std::memcpy(bottomRowStart, tmp.data(), rowSize);
-  }
-}
 }  // namespace gfx::geom
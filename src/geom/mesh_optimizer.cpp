@@ -0,0 +1,324 @@
+#include "geom/mesh_optimizer.hpp"
+
+#include <OPPCH.h>
+
+namespace gfx::geom {
+
+namespace {
+
+// ---- Forsyth 參數 ----
+constexpr int kCacheSize = 32;  // 模擬的 LRU cache 大小
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+float forsythVertexScore(int cachePos, unsigned remainingTris) {
+  if (remainingTris == 0) return -1.0f;  // 已經沒有三角形會用到它
+
+  float score = 0.0f;
+  if (cachePos >= 0) {
+    if (cachePos < 3) {
+      // 剛用過的三個頂點給固定分數，避免永遠選同一條 strip
+      score = kLastTriScore;
+    } else {
+      const float scaler = 1.0f / (kCacheSize - 3);
+      score = std::pow(1.0f - (cachePos - 3) * scaler, kCacheDecayPower);
+    }
+  }
+  // 剩下的三角形越少越優先處理，避免留下孤立的三角形
+  score += kValenceBoostScale * std::pow(static_cast<float>(remainingTris), -kValenceBoostPower);
+  return score;
+}
+
+struct VertexHash {
+  size_t operator()(const Vertex &v) const {
+    // FNV-1a over the raw bytes
+    const auto *p = reinterpret_cast<const unsigned char *>(&v);
+    size_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < sizeof(Vertex); i++) {
+      h ^= p[i];
+      h *= 1099511628211ull;
+    }
+    return h;
+  }
+};
+
+struct VertexEqual {
+  bool operator()(const Vertex &a, const Vertex &b) const { return std::memcmp(&a, &b, sizeof(Vertex)) == 0; }
+};
+
+}  // namespace
+
+VertexCacheStats analyzeVertexCache(const std::vector<GLuint> &indices, size_t vertexCount, unsigned cacheSize) {
+  VertexCacheStats stats;
+  if (indices.empty() || vertexCount == 0) return stats;
+
+  // timestamp-based FIFO：頂點進 cache 的時間點距今超過 cacheSize 就算被擠出
+  std::vector<size_t> timestamps(vertexCount, 0);
+  size_t time = cacheSize + 1;
+
+  for (GLuint idx : indices) {
+    if (time - timestamps[idx] > cacheSize) {
+      timestamps[idx] = time++;
+      stats.verticesTransformed++;
+    }
+  }
+
+  stats.acmr = static_cast<float>(stats.verticesTransformed) / (indices.size() / 3);
+  stats.atvr = static_cast<float>(stats.verticesTransformed) / vertexCount;
+  return stats;
+}
+
+size_t weldVertices(std::vector<Vertex> &vertices, std::vector<GLuint> &indices) {
+  std::unordered_map<Vertex, GLuint, VertexHash, VertexEqual> unique;
+  unique.reserve(vertices.size());
+
+  std::vector<GLuint> remap(vertices.size());
+  std::vector<Vertex> welded;
+  welded.reserve(vertices.size());
+
+  for (size_t i = 0; i < vertices.size(); i++) {
+    auto [it, inserted] = unique.emplace(vertices[i], static_cast<GLuint>(welded.size()));
+    if (inserted) welded.push_back(vertices[i]);
+    remap[i] = it->second;
+  }
+
+  for (auto &idx : indices) idx = remap[idx];
+  vertices.swap(welded);
+  return vertices.size();
+}
+
+void optimizeVertexCache(std::vector<GLuint> &indices, size_t vertexCount) {
+  const size_t triCount = indices.size() / 3;
+  if (triCount == 0) return;
+
+  // 每個頂點被哪些三角形使用（CSR 格式），liveTris 是還沒輸出的數量
+  std::vector<unsigned> liveTris(vertexCount, 0);
+  for (GLuint idx : indices) liveTris[idx]++;
+
+  std::vector<unsigned> adjOffset(vertexCount + 1, 0);
+  for (size_t v = 0; v < vertexCount; v++) adjOffset[v + 1] = adjOffset[v] + liveTris[v];
+
+  std::vector<unsigned> adjTris(indices.size());
+  {
+    std::vector<unsigned> cursor(adjOffset.begin(), adjOffset.end() - 1);
+    for (size_t t = 0; t < triCount; t++) {
+      for (int k = 0; k < 3; k++) adjTris[cursor[indices[t * 3 + k]]++] = static_cast<unsigned>(t);
+    }
+  }
+
+  std::vector<int> cachePos(vertexCount, -1);
+  std::vector<float> vertexScore(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++) vertexScore[v] = forsythVertexScore(-1, liveTris[v]);
+
+  std::vector<float> triScore(triCount);
+  std::vector<bool> emitted(triCount, false);
+  int best = 0;
+  for (size_t t = 0; t < triCount; t++) {
+    triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+    if (triScore[t] > triScore[best]) best = static_cast<int>(t);
+  }
+
+  std::vector<GLuint> output;
+  output.reserve(indices.size());
+  std::vector<GLuint> cache, newCache;
+  cache.reserve(kCacheSize + 3);
+  newCache.reserve(kCacheSize + 3);
+  size_t scanCursor = 0;
+
+  while (best >= 0) {
+    const GLuint tri[3] = {indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2]};
+    emitted[best] = true;
+    output.insert(output.end(), tri, tri + 3);
+
+    // 從頂點的 adjacency 中移除這個三角形
+    for (GLuint v : tri) {
+      unsigned *begin = adjTris.data() + adjOffset[v];
+      unsigned *end = begin + liveTris[v];
+      unsigned *it = std::find(begin, end, static_cast<unsigned>(best));
+      if (it != end) {
+        std::swap(*it, *(end - 1));
+        liveTris[v]--;
+      }
+    }
+
+    // 新的 cache：剛用到的頂點放最前面，其餘依原順序往後推
+    newCache.clear();
+    for (GLuint v : tri) {
+      if (std::find(newCache.begin(), newCache.end(), v) == newCache.end()) newCache.push_back(v);
+    }
+    for (GLuint v : cache) {
+      if (v != tri[0] && v != tri[1] && v != tri[2]) newCache.push_back(v);
+    }
+
+    // 更新分數（包含剛被擠出 cache 的頂點）
+    for (size_t i = 0; i < newCache.size(); i++) {
+      const GLuint v = newCache[i];
+      cachePos[v] = i < kCacheSize ? static_cast<int>(i) : -1;
+      vertexScore[v] = forsythVertexScore(cachePos[v], liveTris[v]);
+    }
+
+    // 只需要重新計算受影響頂點周圍的三角形，並從中挑出下一個
+    best = -1;
+    float bestScore = -1.0f;
+    for (GLuint v : newCache) {
+      for (unsigned a = adjOffset[v]; a < adjOffset[v] + liveTris[v]; a++) {
+        const unsigned t = adjTris[a];
+        triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+        if (triScore[t] > bestScore) {
+          bestScore = triScore[t];
+          best = static_cast<int>(t);
+        }
+      }
+    }
+
+    if (newCache.size() > kCacheSize) newCache.resize(kCacheSize);
+    cache.swap(newCache);
+
+    // cache 周圍沒有剩下的三角形：線性往後找下一個沒輸出的
+    if (best < 0) {
+      while (scanCursor < triCount && emitted[scanCursor]) scanCursor++;
+      best = scanCursor < triCount ? static_cast<int>(scanCursor) : -1;
+    }
+  }
+
+  indices.swap(output);
+}
+
+void optimizeOverdraw(std::vector<GLuint> &indices, const std::vector<Vertex> &vertices, float threshold) {
+  const size_t triCount = indices.size() / 3;
+  if (triCount < 2) return;
+
+  constexpr unsigned kFifoSize = 16;
+
+  // 兩個 pass 共用同一份 timestamp，換段落時把 time 往前推 kFifoSize + 1 就等於清空 cache
+  std::vector<size_t> timestamps(vertices.size(), 0);
+  size_t time = kFifoSize + 1;
+
+  // 1. hard boundary：三個頂點都 cache miss 的三角形，從這裡切開不會增加 ACMR
+  //    順便累計每個 hard cluster 的 miss 數，給下一步當 cluster ACMR
+  std::vector<size_t> hard;
+  std::vector<size_t> hardMisses;
+  for (size_t t = 0; t < triCount; t++) {
+    size_t misses = 0;
+    for (int k = 0; k < 3; k++) {
+      GLuint v = indices[t * 3 + k];
+      if (time - timestamps[v] > kFifoSize) {
+        timestamps[v] = time++;
+        misses++;
+      }
+    }
+    if (t == 0 || misses == 3) {
+      hard.push_back(t);
+      hardMisses.push_back(misses);
+    } else {
+      hardMisses.back() += misses;
+    }
+  }
+  hard.push_back(triCount);
+
+  // 2. soft boundary：在 hard cluster 內，當目前段落的 ACMR 已經不超過 cluster ACMR * threshold 就切
+  std::vector<size_t> clusters;
+  for (size_t h = 0; h + 1 < hard.size(); h++) {
+    const size_t start = hard[h], end = hard[h + 1];
+    const float clusterAcmr = static_cast<float>(hardMisses[h]) / (end - start);
+
+    time += kFifoSize + 1;  // 每個 hard cluster 從空 cache 開始
+    size_t misses = 0, segStart = start;
+    clusters.push_back(start);
+
+    for (size_t t = start; t < end; t++) {
+      for (int k = 0; k < 3; k++) {
+        GLuint v = indices[t * 3 + k];
+        if (time - timestamps[v] > kFifoSize) {
+          timestamps[v] = time++;
+          misses++;
+        }
+      }
+      const float segAcmr = static_cast<float>(misses) / (t - segStart + 1);
+      if (t + 1 < end && segAcmr <= clusterAcmr * threshold) {
+        clusters.push_back(t + 1);
+        segStart = t + 1;
+        misses = 0;
+        time += kFifoSize + 1;  // 新段落從空 cache 開始
+      }
+    }
+  }
+  clusters.push_back(triCount);
+
+  // 3. 每個 cluster 的排序鍵：面積加權的中心點相對於 mesh 中心，在 cluster 法向上的投影
+  //    越朝外的 cluster 越先畫，讓它遮住後面的三角形
+  glm::vec3 meshCenter(0.0f);
+  float meshArea = 0.0f;
+  std::vector<glm::vec3> centroids(clusters.size() - 1, glm::vec3(0.0f));
+  std::vector<glm::vec3> normals(clusters.size() - 1, glm::vec3(0.0f));
+  std::vector<float> areas(clusters.size() - 1, 0.0f);
+
+  for (size_t c = 0; c + 1 < clusters.size(); c++) {
+    for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+      const glm::vec3 &p0 = vertices[indices[t * 3]].position;
+      const glm::vec3 &p1 = vertices[indices[t * 3 + 1]].position;
+      const glm::vec3 &p2 = vertices[indices[t * 3 + 2]].position;
+      const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);  // 長度 = 2 * 面積
+      const float area = glm::length(n);
+      centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+      normals[c] += n;
+      areas[c] += area;
+    }
+    meshCenter += centroids[c];
+    meshArea += areas[c];
+  }
+  if (meshArea > 0.0f) meshCenter /= meshArea;
+
+  std::vector<std::pair<float, size_t>> order(clusters.size() - 1);
+  for (size_t c = 0; c + 1 < clusters.size(); c++) {
+    glm::vec3 centroid = areas[c] > 0.0f ? centroids[c] / areas[c] : vertices[indices[clusters[c] * 3]].position;
+    float len = glm::length(normals[c]);
+    glm::vec3 n = len > 0.0f ? normals[c] / len : glm::vec3(0.0f);
+    order[c] = {glm::dot(centroid - meshCenter, n), c};
+  }
+  std::stable_sort(order.begin(), order.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+  std::vector<GLuint> output;
+  output.reserve(indices.size());
+  for (const auto &[key, c] : order) {
+    output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+  }
+  indices.swap(output);
+}
+
+size_t optimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<GLuint> &indices) {
+  constexpr GLuint kUnused = ~0u;
+  std::vector<GLuint> remap(vertices.size(), kUnused);
+  std::vector<Vertex> reordered;
+  reordered.reserve(vertices.size());
+
+  for (auto &idx : indices) {
+    if (remap[idx] == kUnused) {
+      remap[idx] = static_cast<GLuint>(reordered.size());
+      reordered.push_back(vertices[idx]);
+    }
+    idx = remap[idx];
+  }
+
+  vertices.swap(reordered);
+  return vertices.size();
+}
+
+MeshOptimizeStats optimizeMesh(std::vector<Vertex> &vertices, std::vector<GLuint> &indices, float overdrawThreshold) {
+  MeshOptimizeStats stats;
+  stats.verticesBefore = vertices.size();
+  stats.before = analyzeVertexCache(indices, vertices.size());
+
+  weldVertices(vertices, indices);
+  optimizeVertexCache(indices, vertices.size());
+  optimizeOverdraw(indices, vertices, overdrawThreshold);
+  optimizeVertexFetch(vertices, indices);
+
+  stats.verticesAfter = vertices.size();
+  stats.after = analyzeVertexCache(indices, vertices.size());
+  return stats;
+}
+
+}  // namespace gfx::geom
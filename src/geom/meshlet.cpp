@@ -0,0 +1,110 @@
+#include "geom/meshlet.hpp"
+
+#include <OPPCH.h>
+
+namespace gfx::geom {
+
+namespace {
+
+void computeBounds(Meshlet &m, const std::vector<Vertex> &vertices, const GLuint *indices) {
+  // bounding sphere：AABB 中心 + 最遠距離
+  glm::vec3 bmin(std::numeric_limits<float>::max()), bmax(-std::numeric_limits<float>::max());
+  for (uint32_t i = 0; i < m.triangleCount * 3; i++) {
+    const glm::vec3 &p = vertices[indices[i]].position;
+    bmin = glm::min(bmin, p);
+    bmax = glm::max(bmax, p);
+  }
+  m.center = (bmin + bmax) * 0.5f;
+  m.radius = 0.0f;
+  for (uint32_t i = 0; i < m.triangleCount * 3; i++) {
+    m.radius = std::max(m.radius, glm::length(vertices[indices[i]].position - m.center));
+  }
+
+  // normal cone
+  std::vector<glm::vec3> normals;
+  std::vector<glm::vec3> centroids;
+  normals.reserve(m.triangleCount);
+  centroids.reserve(m.triangleCount);
+  glm::vec3 axis(0.0f);
+  for (uint32_t t = 0; t < m.triangleCount; t++) {
+    const glm::vec3 &p0 = vertices[indices[t * 3]].position;
+    const glm::vec3 &p1 = vertices[indices[t * 3 + 1]].position;
+    const glm::vec3 &p2 = vertices[indices[t * 3 + 2]].position;
+    glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+    float len = glm::length(n);
+    if (len == 0.0f) continue;  // degenerate
+    n /= len;
+    normals.push_back(n);
+    centroids.push_back((p0 + p1 + p2) / 3.0f);
+    axis += n;
+  }
+
+  m.coneApex = m.center;
+  m.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+  m.coneCutoff = 1.0f;
+
+  float axisLen = glm::length(axis);
+  if (normals.empty() || axisLen == 0.0f) return;
+  axis /= axisLen;
+
+  float minDot = 1.0f;
+  for (const auto &n : normals) minDot = std::min(minDot, glm::dot(axis, n));
+  // 張角超過 ~84 度時幾乎不可能整個背面，直接放棄
+  if (minDot <= 0.1f) return;
+
+  // apex 往 axis 反方向推，直到所有三角形平面都在 apex 前方：dot(centroid - (center - axis * t), n) >= 0
+  float maxT = 0.0f;
+  for (size_t i = 0; i < normals.size(); i++) {
+    float dc = glm::dot(m.center - centroids[i], normals[i]);
+    float dn = glm::dot(axis, normals[i]);
+    maxT = std::max(maxT, dc / dn);
+  }
+
+  m.coneApex = m.center - axis * maxT;
+  m.coneAxis = axis;
+  m.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+}  // namespace
+
+MeshletData buildMeshlets(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices, size_t maxVertices,
+                          size_t maxTriangles) {
+  MeshletData data;
+  data.indices.reserve(indices.size());
+
+  // 目前 meshlet 用到的頂點；用 generation 計數避免每次 flush 都清整個陣列
+  std::vector<uint32_t> seen(vertices.size(), 0);
+  uint32_t generation = 1;
+
+  Meshlet current{};
+  auto flush = [&]() {
+    if (current.triangleCount == 0) return;
+    computeBounds(current, vertices, data.indices.data() + current.indexOffset);
+    data.meshlets.push_back(current);
+    current = Meshlet{};
+    current.indexOffset = static_cast<uint32_t>(data.indices.size());
+    generation++;
+  };
+
+  for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+    const GLuint a = indices[t], b = indices[t + 1], c = indices[t + 2];
+
+    auto isNew = [&](GLuint v) { return seen[v] != generation; };
+    uint32_t newVerts = isNew(a) + (b != a && isNew(b)) + (c != a && c != b && isNew(c));
+
+    if (current.vertexCount + newVerts > maxVertices || current.triangleCount + 1 > maxTriangles) {
+      flush();
+      newVerts = 1 + (b != a) + (c != a && c != b);
+    }
+
+    seen[a] = seen[b] = seen[c] = generation;
+    current.vertexCount += newVerts;
+    current.triangleCount++;
+    data.indices.insert(data.indices.end(), {a, b, c});
+  }
+  flush();
+
+  return data;
+}
+
+}  // namespace gfx::geom
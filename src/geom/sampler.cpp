@@ -0,0 +1,196 @@
+#include "geom/sampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace gfx::geom {
+
+namespace {
+
+// 2^32 * R2 序列的 (1 / phi2, 1 / phi2^2) 與 2^32 / phi，整數相加溢位即為 fract
+constexpr uint32_t R2_X = 3242174889u;
+constexpr uint32_t R2_Y = 2447445413u;
+constexpr uint32_t GOLDEN = 2654435769u;
+
+uint32_t laineKarrasPermutation(uint32_t x, uint32_t seed) {
+  x += seed;
+  x ^= x * 0x6c50b47cu;
+  x ^= x * 0xb82f1e52u;
+  x ^= x * 0xc7afe638u;
+  x ^= x * 0x8d22f6e6u;
+  return x;
+}
+
+}  // namespace
+
+uint32_t hashU32(uint32_t x) {
+  // lowbias32（Chris Wellons）
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+uint32_t reverseBits32(uint32_t x) {
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+  x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+uint32_t sobol2(uint32_t index) {
+  uint32_t result = 0;
+  for (uint32_t v = 1u << 31; index != 0; index >>= 1, v ^= v >> 1) {
+    if (index & 1u) result ^= v;
+  }
+  return result;
+}
+
+uint32_t nestedUniformScramble(uint32_t x, uint32_t seed) {
+  // Laine-Karras permutation 只會讓低位影響高位，反轉前後即為對每個 bit 依更高位的 Owen scramble
+  return reverseBits32(laineKarrasPermutation(reverseBits32(x), seed));
+}
+
+glm::vec2 sobolOwen2D(uint32_t index, uint32_t seed) {
+  index = nestedUniformScramble(index, seed);  // 打亂順序，2 的冪次個 sample 仍是同一組分層的點
+  const uint32_t x = nestedUniformScramble(reverseBits32(index), hashU32(seed ^ 0x2545f491u));
+  const uint32_t y = nestedUniformScramble(sobol2(index), hashU32(seed ^ 0x9e3779b9u));
+  return {toUnitFloat(x), toUnitFloat(y)};
+}
+
+float toUnitFloat(uint32_t x) { return static_cast<float>(x >> 8) * (1.0f / 16777216.0f); }
+
+void Sampler::setBlueNoise(const uint8_t *rgba, int size) {
+  blueNoise_ = rgba;
+  blueNoiseSize_ = size;
+}
+
+void Sampler::begin(glm::uvec2 pixel, uint32_t sampleIndex) {
+  pixel_ = pixel;
+  index_ = sampleIndex;
+  dim_ = 0;
+  rng_ = hashU32(pixel.x ^ hashU32(pixel.y ^ hashU32(sampleIndex)));
+}
+
+uint32_t Sampler::seed() const { return hashU32(pixel_.x ^ hashU32(pixel_.y ^ hashU32(dim_))); }
+
+glm::uvec4 Sampler::blueNoiseTexel() const {
+  const auto size = static_cast<uint32_t>(blueNoiseSize_);
+  const uint32_t x = (pixel_.x + hashU32(dim_)) % size;
+  const uint32_t y = (pixel_.y + hashU32(dim_ ^ 0x9e3779b9u)) % size;
+  const uint8_t *t = blueNoise_ + (static_cast<size_t>(y) * size + x) * 4;
+  return {t[0], t[1], t[2], t[3]};
+}
+
+float Sampler::next1D() {
+  float u;
+  if (type_ == SamplerType::Sobol) {
+    u = sobolOwen2D(index_, seed()).x;
+  } else if (type_ == SamplerType::BlueNoise && blueNoise_) {
+    // 1D 在 B / A 兩個 channel 之間輪流；+0x800000 取 8-bit 量化格的中心
+    const glm::uvec4 t = blueNoiseTexel();
+    u = toUnitFloat((((dim_ & 1u) ? t.w : t.z) << 24) + 0x800000u + index_ * GOLDEN);
+  } else {
+    rng_ = hashU32(rng_ + 0x9e3779b9u);
+    u = toUnitFloat(rng_);
+  }
+  dim_++;
+  return u;
+}
+
+glm::vec2 Sampler::next2D() {
+  glm::vec2 u;
+  if (type_ == SamplerType::Sobol) {
+    u = sobolOwen2D(index_, seed());
+  } else if (type_ == SamplerType::BlueNoise && blueNoise_) {
+    const glm::uvec4 t = blueNoiseTexel();
+    u.x = toUnitFloat((t.x << 24) + 0x800000u + index_ * R2_X);
+    u.y = toUnitFloat((t.y << 24) + 0x800000u + index_ * R2_Y);
+  } else {
+    rng_ = hashU32(rng_ + 0x9e3779b9u);
+    u.x = toUnitFloat(rng_);
+    rng_ = hashU32(rng_ + 0x9e3779b9u);
+    u.y = toUnitFloat(rng_);
+  }
+  dim_++;
+  return u;
+}
+
+std::vector<uint32_t> generateBlueNoise(int size, uint32_t seed, float sigma) {
+  const int n = size * size;
+  std::vector<uint32_t> rank(n, 0);
+  if (n == 0) return rank;
+
+  // toroidal Gaussian，依 pixel 間的位移查表
+  std::vector<float> kernel(n);
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      const float dx = static_cast<float>(std::min(x, size - x));
+      const float dy = static_cast<float>(std::min(y, size - y));
+      kernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.0f * sigma * sigma));
+    }
+  }
+  auto splat = [&](std::vector<float> &energy, int p, float sign) {
+    const int px = p % size, py = p / size;
+    for (int y = 0; y < size; y++) {
+      const int ky = (y - py + size) % size;
+      for (int x = 0; x < size; x++) energy[y * size + x] += sign * kernel[ky * size + (x - px + size) % size];
+    }
+  };
+  // tightest cluster：1 之中能量最高；largest void：0 之中能量最低
+  auto extreme = [&](const std::vector<float> &energy, const std::vector<uint8_t> &bits, uint8_t value) {
+    int best = -1;
+    for (int i = 0; i < n; i++) {
+      if (bits[i] != value) continue;
+      if (best < 0 || (value ? energy[i] > energy[best] : energy[i] < energy[best])) best = i;
+    }
+    return best;
+  };
+
+  // 初始 pattern：隨機 10% 的 1，反覆把最擠的 1 搬到最空的位置直到收斂
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::mt19937 rng(seed);
+  std::shuffle(order.begin(), order.end(), rng);
+  const int ones = std::max(1, n / 10);
+  std::vector<uint8_t> bits(n, 0);
+  std::vector<float> energy(n, 0.0f);
+  for (int i = 0; i < ones; i++) {
+    bits[order[i]] = 1;
+    splat(energy, order[i], 1.0f);
+  }
+  for (int iteration = 0; iteration < n; iteration++) {
+    const int cluster = extreme(energy, bits, 1);
+    bits[cluster] = 0;
+    splat(energy, cluster, -1.0f);
+    const int hole = extreme(energy, bits, 0);
+    bits[hole] = 1;
+    splat(energy, hole, 1.0f);
+    if (hole == cluster) break;
+  }
+
+  // phase 1：從初始 pattern 逐一拿掉最擠的 1，rank 由 ones - 1 往下
+  std::vector<uint8_t> remaining = bits;
+  std::vector<float> remainingEnergy = energy;
+  for (int r = ones - 1; r >= 0; r--) {
+    const int cluster = extreme(remainingEnergy, remaining, 1);
+    remaining[cluster] = 0;
+    splat(remainingEnergy, cluster, -1.0f);
+    rank[cluster] = static_cast<uint32_t>(r);
+  }
+  // phase 2 / 3：逐一填最空的位置；過半之後「0 裡最擠的」與「1 的能量最低的 0」是同一個，不用另外算
+  for (int r = ones; r < n; r++) {
+    const int hole = extreme(energy, bits, 0);
+    bits[hole] = 1;
+    splat(energy, hole, 1.0f);
+    rank[hole] = static_cast<uint32_t>(r);
+  }
+  return rank;
+}
+
+}  // namespace gfx::geom
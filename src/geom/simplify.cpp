@@ -0,0 +1,289 @@
+#include "geom/simplify.hpp"
+
+#include <OPPCH.h>
+
+#include "geom/bounds.hpp"
+
+namespace gfx::geom {
+
+namespace {
+
+// 對稱 4x4 矩陣只存 10 個元素；w 是累積的面積權重，用來把誤差換算回距離平方
+struct Quadric {
+  double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+  double a11 = 0, a12 = 0, a13 = 0;
+  double a22 = 0, a23 = 0;
+  double a33 = 0;
+  double w = 0;
+
+  void addPlane(const glm::dvec3 &n, double d, double weight) {
+    a00 += weight * n.x * n.x;
+    a01 += weight * n.x * n.y;
+    a02 += weight * n.x * n.z;
+    a03 += weight * n.x * d;
+    a11 += weight * n.y * n.y;
+    a12 += weight * n.y * n.z;
+    a13 += weight * n.y * d;
+    a22 += weight * n.z * n.z;
+    a23 += weight * n.z * d;
+    a33 += weight * d * d;
+    w += weight;
+  }
+
+  Quadric &operator+=(const Quadric &o) {
+    a00 += o.a00, a01 += o.a01, a02 += o.a02, a03 += o.a03;
+    a11 += o.a11, a12 += o.a12, a13 += o.a13;
+    a22 += o.a22, a23 += o.a23;
+    a33 += o.a33;
+    w += o.w;
+    return *this;
+  }
+
+  // v^T Q v, v = (x, y, z, 1)
+  double eval(const glm::dvec3 &v) const {
+    double r = a00 * v.x * v.x + a11 * v.y * v.y + a22 * v.z * v.z + a33;
+    r += 2.0 * (a01 * v.x * v.y + a02 * v.x * v.z + a12 * v.y * v.z);
+    r += 2.0 * (a03 * v.x + a13 * v.y + a23 * v.z);
+    return r;
+  }
+};
+
+struct Collapse {
+  GLuint from;
+  GLuint to;
+  double cost;
+};
+
+struct PositionHash {
+  size_t operator()(const glm::vec3 &p) const {
+    uint32_t h[3];
+    std::memcpy(h, &p, sizeof(h));
+    return (h[0] * 73856093u) ^ (h[1] * 19349663u) ^ (h[2] * 83492791u);
+  }
+};
+
+struct PositionEqual {
+  bool operator()(const glm::vec3 &a, const glm::vec3 &b) const { return std::memcmp(&a, &b, sizeof(glm::vec3)) == 0; }
+};
+
+glm::dvec3 triNormal(const glm::dvec3 &p0, const glm::dvec3 &p1, const glm::dvec3 &p2) {
+  return glm::cross(p1 - p0, p2 - p0);
+}
+
+}  // namespace
+
+std::vector<GLuint> simplifyMesh(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices,
+                                 size_t targetIndexCount, float targetError, float *resultError) {
+  std::vector<GLuint> result(indices);
+  if (resultError) *resultError = 0.0f;
+  if (indices.size() <= targetIndexCount || vertices.empty()) return result;
+
+  const size_t vertexCount = vertices.size();
+
+  // 正規化到單位大小再算 quadric，避免大座標的數值問題；誤差也因此是相對於半徑的比例
+  const Bounds bounds = Bounds::fromVertices(vertices);
+  const double invScale = bounds.radius > 0.0f ? 1.0 / bounds.radius : 1.0;
+  std::vector<glm::dvec3> pos(vertexCount);
+  for (size_t i = 0; i < vertexCount; i++) {
+    pos[i] = glm::dvec3(vertices[i].position - bounds.center) * invScale;
+  }
+
+  // 同位置的頂點歸為一組（glTF 會在 UV seam 把頂點拆開）
+  std::unordered_map<glm::vec3, GLuint, PositionHash, PositionEqual> posIds;
+  std::vector<GLuint> posId(vertexCount);
+  std::vector<unsigned> wedgeCount;
+  for (size_t i = 0; i < vertexCount; i++) {
+    auto [it, inserted] = posIds.emplace(vertices[i].position, static_cast<GLuint>(wedgeCount.size()));
+    if (inserted) wedgeCount.push_back(0);
+    posId[i] = it->second;
+    wedgeCount[it->second]++;
+  }
+
+  // 鎖住：seam（同位置有多個頂點）以及邊界（只屬於一個三角形的邊）
+  std::vector<bool> locked(vertexCount, false);
+  for (size_t i = 0; i < vertexCount; i++) locked[i] = wedgeCount[posId[i]] > 1;
+  {
+    std::unordered_map<uint64_t, int> edges;
+    edges.reserve(indices.size());
+    auto key = [](GLuint a, GLuint b) { return (uint64_t(a) << 32) | b; };
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+      for (int k = 0; k < 3; k++) {
+        GLuint a = posId[indices[t + k]], b = posId[indices[t + (k + 1) % 3]];
+        edges[key(a, b)]++;
+      }
+    }
+    std::vector<bool> borderPos(wedgeCount.size(), false);
+    for (const auto &[k, count] : edges) {
+      GLuint a = GLuint(k >> 32), b = GLuint(k & 0xffffffffu);
+      if (edges.find(key(b, a)) == edges.end()) borderPos[a] = borderPos[b] = true;
+    }
+    for (size_t i = 0; i < vertexCount; i++) {
+      if (borderPos[posId[i]]) locked[i] = true;
+    }
+  }
+
+  // 每個頂點的 quadric：周圍三角形平面，以面積加權
+  std::vector<Quadric> quadrics(vertexCount);
+  for (size_t t = 0; t + 2 < result.size(); t += 3) {
+    const GLuint i0 = result[t], i1 = result[t + 1], i2 = result[t + 2];
+    glm::dvec3 n = triNormal(pos[i0], pos[i1], pos[i2]);
+    double len = glm::length(n);
+    if (len == 0.0) continue;
+    n /= len;
+    const double area = len * 0.5;
+    const double d = -glm::dot(n, pos[i0]);
+    Quadric q;
+    q.addPlane(n, d, area);
+    quadrics[i0] += q;
+    quadrics[i1] += q;
+    quadrics[i2] += q;
+  }
+
+  const double maxCost = double(targetError) * double(targetError);
+  double worstCost = 0.0;
+
+  std::vector<GLuint> remap(vertexCount);
+  std::vector<bool> touched(vertexCount);
+  std::vector<Collapse> collapses;
+  std::vector<unsigned> adjOffset(vertexCount + 1), adjTris;
+
+  while (result.size() > targetIndexCount) {
+    const size_t triCount = result.size() / 3;
+
+    // vertex -> triangle adjacency（CSR）
+    std::fill(adjOffset.begin(), adjOffset.end(), 0);
+    for (GLuint idx : result) adjOffset[idx + 1]++;
+    for (size_t v = 0; v < vertexCount; v++) adjOffset[v + 1] += adjOffset[v];
+    adjTris.resize(result.size());
+    {
+      std::vector<unsigned> cursor(adjOffset.begin(), adjOffset.end() - 1);
+      for (size_t t = 0; t < triCount; t++) {
+        for (int k = 0; k < 3; k++) adjTris[cursor[result[t * 3 + k]]++] = static_cast<unsigned>(t);
+      }
+    }
+
+    // 候選：每條邊的兩個方向；from 會消失並移到 to 的位置
+    collapses.clear();
+    for (size_t t = 0; t < triCount; t++) {
+      for (int k = 0; k < 3; k++) {
+        const GLuint a = result[t * 3 + k], b = result[t * 3 + (k + 1) % 3];
+        const GLuint edge[2][2] = {{a, b}, {b, a}};
+        for (const auto &e : edge) {
+          const GLuint from = e[0], to = e[1];
+          // to 必須是該位置唯一的頂點，不然 from 的三角形不知道要接到哪個 UV
+          if (from == to || locked[from] || wedgeCount[posId[to]] > 1) continue;
+          Quadric q = quadrics[from];
+          q += quadrics[to];
+          const double cost = q.w > 0.0 ? std::max(0.0, q.eval(pos[to])) / q.w : 0.0;
+          collapses.push_back({from, to, cost});
+        }
+      }
+    }
+    if (collapses.empty()) break;
+    std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y) { return x.cost < y.cost; });
+
+    for (size_t v = 0; v < vertexCount; v++) remap[v] = static_cast<GLuint>(v);
+    std::fill(touched.begin(), touched.end(), false);
+
+    // 每輪最多收斂到一半的 collapse，剩下的下一輪重新評估
+    const size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+    const size_t passLimit = std::max<size_t>(1, trianglesToRemove / 2);
+    size_t removed = 0, accepted = 0;
+
+    for (const Collapse &c : collapses) {
+      if (c.cost > maxCost) break;
+      if (removed >= passLimit) break;
+      if (touched[c.from] || touched[c.to]) continue;
+
+      // flip 檢查：from 周圍不含 to 的三角形，移動後法向不可以翻轉
+      bool flips = false;
+      int collapsedTris = 0;
+      for (unsigned a = adjOffset[c.from]; a < adjOffset[c.from + 1] && !flips; a++) {
+        const size_t t = adjTris[a];
+        const GLuint tri[3] = {result[t * 3], result[t * 3 + 1], result[t * 3 + 2]};
+        if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) {
+          collapsedTris++;
+          continue;
+        }
+        glm::dvec3 p[3], q[3];
+        for (int k = 0; k < 3; k++) {
+          p[k] = pos[tri[k]];
+          q[k] = tri[k] == c.from ? pos[c.to] : pos[tri[k]];
+        }
+        const glm::dvec3 n0 = triNormal(p[0], p[1], p[2]);
+        const glm::dvec3 n1 = triNormal(q[0], q[1], q[2]);
+        // 翻面或退化成很細長都不接受
+        if (glm::dot(n0, n1) <= 0.25 * glm::length(n0) * glm::length(n1)) flips = true;
+      }
+      if (flips) continue;
+
+      remap[c.from] = c.to;
+      quadrics[c.to] += quadrics[c.from];
+      worstCost = std::max(worstCost, c.cost);
+      removed += collapsedTris;
+      accepted++;
+
+      // from 的鄰居這輪都不能再動，確保上面的 flip 檢查仍然成立
+      touched[c.from] = touched[c.to] = true;
+      for (unsigned a = adjOffset[c.from]; a < adjOffset[c.from + 1]; a++) {
+        const size_t t = adjTris[a];
+        for (int k = 0; k < 3; k++) touched[result[t * 3 + k]] = true;
+      }
+    }
+
+    if (accepted == 0) break;
+
+    // 套用 remap，移除退化三角形
+    size_t write = 0;
+    for (size_t t = 0; t < triCount; t++) {
+      const GLuint i0 = remap[result[t * 3]], i1 = remap[result[t * 3 + 1]], i2 = remap[result[t * 3 + 2]];
+      if (i0 == i1 || i1 == i2 || i0 == i2) continue;
+      result[write++] = i0;
+      result[write++] = i1;
+      result[write++] = i2;
+    }
+    result.resize(write);
+  }
+
+  if (resultError) *resultError = static_cast<float>(std::sqrt(worstCost));
+  return result;
+}
+
+LodChain buildLodChain(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices, size_t maxLevels,
+                       float reduction) {
+  LodChain chain;
+  chain.indices = indices;
+  chain.levels.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+
+  size_t target = indices.size();
+  for (size_t level = 1; level < maxLevels; level++) {
+    target = static_cast<size_t>(target * reduction) / 3 * 3;
+    if (target < 3) break;
+
+    float error = 0.0f;
+    std::vector<GLuint> lod = simplifyMesh(vertices, indices, target, 1.0f, &error);
+
+    // 被鎖住的頂點太多時就縮不下去了，沒有明顯變少就停
+    const MeshLod &prev = chain.levels.back();
+    if (lod.empty() || lod.size() > prev.indexCount * 0.9f) break;
+
+    // 各層從原始 mesh 簡化，誤差取累積最大值讓 LOD 選擇單調
+    chain.levels.push_back({static_cast<uint32_t>(chain.indices.size()), static_cast<uint32_t>(lod.size()),
+                            std::max(error, prev.error)});
+    chain.indices.insert(chain.indices.end(), lod.begin(), lod.end());
+    target = lod.size();
+  }
+
+  return chain;
+}
+
+uint32_t selectLod(const std::vector<MeshLod> &levels, float radiusPx, float maxErrorPx) {
+  uint32_t lod = 0;
+  for (uint32_t i = 1; i < levels.size(); i++) {
+    if (levels[i].error * radiusPx > maxErrorPx) break;
+    lod = i;
+  }
+  return lod;
+}
+
+}  // namespace gfx::geom
@@ -0,0 +1,87 @@
+#include "geom/vertex.hpp"
+
+#include <OPPCH.h>
+
+#include <glm/gtc/packing.hpp>
+
+namespace gfx::geom {
+
+namespace {
+core::VertexLayout makeLayout(VertexFormat format) {
+  core::VertexLayout layout;
+  switch (format) {
+    case VertexFormat::Float32:
+      layout.add(ATTRIB_POSITION, 3, GL_FLOAT)
+          .add(ATTRIB_NORMAL, 3, GL_FLOAT)
+          .add(ATTRIB_COLOR, 3, GL_FLOAT)
+          .add(ATTRIB_TEXCOORD, 2, GL_FLOAT);
+      break;
+    case VertexFormat::Compact:
+      layout.add(ATTRIB_POSITION, 3, GL_FLOAT)
+          .add(ATTRIB_NORMAL, 4, GL_INT_2_10_10_10_REV, GL_TRUE)
+          .add(ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE)
+          .add(ATTRIB_TEXCOORD, 2, GL_HALF_FLOAT);
+      break;
+    case VertexFormat::CompactNoColor:
+      layout.add(ATTRIB_POSITION, 3, GL_FLOAT)
+          .add(ATTRIB_NORMAL, 4, GL_INT_2_10_10_10_REV, GL_TRUE)
+          .add(ATTRIB_TEXCOORD, 2, GL_HALF_FLOAT);
+      break;
+  }
+  return layout;
+}
+}  // namespace
+
+const core::VertexLayout &vertexLayout(VertexFormat format) {
+  static const core::VertexLayout float32 = makeLayout(VertexFormat::Float32);
+  static const core::VertexLayout compact = makeLayout(VertexFormat::Compact);
+  static const core::VertexLayout compactNoColor = makeLayout(VertexFormat::CompactNoColor);
+  switch (format) {
+    case VertexFormat::Compact:
+      return compact;
+    case VertexFormat::CompactNoColor:
+      return compactNoColor;
+    default:
+      return float32;
+  }
+}
+
+std::vector<uint8_t> packVertices(const std::vector<Vertex> &vertices, VertexFormat format) {
+  const core::VertexLayout &layout = vertexLayout(format);
+  std::vector<uint8_t> bytes(vertices.size() * layout.stride);
+
+  if (format == VertexFormat::Float32) {
+    static_assert(sizeof(Vertex) == 44, "Vertex must stay tightly packed for the Float32 layout");
+    std::memcpy(bytes.data(), vertices.data(), bytes.size());
+    return bytes;
+  }
+
+  const bool hasColor = layout.has(ATTRIB_COLOR);
+  uint8_t *dst = bytes.data();
+  for (const auto &v : vertices) {
+    uint8_t *p = dst;
+    std::memcpy(p, &v.position, sizeof(glm::vec3));
+    p += sizeof(glm::vec3);
+
+    // 10-bit snorm 只能表示 [-1, 1]，先正規化（Model 的 node matrix 可能帶 scale）
+    float len = glm::length(v.normal);
+    glm::vec3 n = len > 0.0f ? v.normal / len : v.normal;
+    uint32_t normal = glm::packSnorm3x10_1x2(glm::vec4(n, 0.0f));
+    std::memcpy(p, &normal, 4);
+    p += 4;
+
+    if (hasColor) {
+      uint32_t color = glm::packUnorm4x8(glm::vec4(v.color, 1.0f));
+      std::memcpy(p, &color, 4);
+      p += 4;
+    }
+
+    uint32_t uv = glm::packHalf2x16(v.texCoords);
+    std::memcpy(p, &uv, 4);
+
+    dst += layout.stride;
+  }
+  return bytes;
+}
+
+}  // namespace gfx::geom
@@ -0,0 +1,81 @@
+#include "render/cluster_culler.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "geom/frustum.hpp"
+
+namespace gfx::render {
+
+// meshlet 數量少於這個值時，開 thread 的成本比 culling 本身還高
+static constexpr size_t kMinMeshletsPerThread = 512;
+
+ClusterCuller::ClusterCuller(unsigned numThreads)
+    : numThreads_(numThreads ? numThreads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+void ClusterCuller::cull(const geom::MeshletData& data, const glm::mat4& modelMatrix, const glm::mat4& viewProj,
+                         const glm::vec3& camPosition, ClusterDrawList& out) {
+  const size_t n = data.meshlets.size();
+  visible_.resize(n);
+
+  // 全部在 mesh local space 做：frustum 平面乘上 model matrix，相機位置反過來轉
+  const geom::Frustum frustum(viewProj * modelMatrix);
+  const glm::vec3 eye = glm::vec3(glm::inverse(modelMatrix) * glm::vec4(camPosition, 1.0f));
+
+  auto cullRange = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      const geom::Meshlet& m = data.meshlets[i];
+      bool vis = true;
+      if (frustumCulling && !frustum.sphereVisible(m.center, m.radius)) vis = false;
+      if (vis && backfaceCulling && m.coneCutoff < 1.0f) {
+        glm::vec3 dir = m.coneApex - eye;
+        float len = glm::length(dir);
+        if (len > 0.0f && glm::dot(dir / len, m.coneAxis) >= m.coneCutoff) vis = false;
+      }
+      visible_[i] = vis;
+    }
+  };
+
+  const size_t threads = std::min<size_t>(numThreads_, std::max<size_t>(1, n / kMinMeshletsPerThread));
+  if (threads <= 1) {
+    cullRange(0, n);
+  } else {
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    const size_t chunk = (n + threads - 1) / threads;
+    for (size_t t = 1; t < threads; t++) {
+      workers.emplace_back(cullRange, std::min(n, t * chunk), std::min(n, (t + 1) * chunk));
+    }
+    cullRange(0, std::min(n, chunk));
+    for (auto& w : workers) w.join();
+  }
+
+  // compaction：把相鄰的可見 meshlet 合併成一個 draw
+  out.counts.clear();
+  out.offsets.clear();
+  out.visibleMeshlets = 0;
+  out.visibleTriangles = 0;
+
+  size_t runStart = 0, runCount = 0;
+  auto emit = [&]() {
+    if (runCount == 0) return;
+    out.counts.push_back(static_cast<GLsizei>(runCount));
+    out.offsets.push_back(reinterpret_cast<const void*>(runStart * sizeof(GLuint)));
+    runCount = 0;
+  };
+
+  for (size_t i = 0; i < n; i++) {
+    if (!visible_[i]) {
+      emit();
+      continue;
+    }
+    const geom::Meshlet& m = data.meshlets[i];
+    if (runCount == 0) runStart = m.indexOffset;
+    runCount += m.triangleCount * 3;
+    out.visibleMeshlets++;
+    out.visibleTriangles += m.triangleCount;
+  }
+  emit();
+}
+
+}  // namespace gfx::render
@@ -9,8 +9,12 @@ namespace gfx::render {
 
 void CubeMapRenderer::draw(const geom::CubeMap& cm, Shader& shader) const {
   shader.use();
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, cm.textureID);
+  if (cm.texture) {
+    cm.texture->bind();  // 串流載入的 cube map 固定在 unit 0
+  } else {
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cm.textureID);
+  }
   glUniform1i(glGetUniformLocation(shader.PROGRAM_ID, "cubemapTxt"), 0);
 
   meshRenderer_.draw(*cm.cubeMesh, shader, 1);
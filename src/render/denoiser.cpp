@@ -0,0 +1,103 @@
+#include "render/denoiser.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "ShaderClass.hpp"
+
+namespace gfx::render {
+
+Denoiser::Denoiser(int width, int height) : width(width), height(height) {
+  varianceShader_ = std::make_unique<Shader>("./shaders/fullscreen_vert.glsl", "./shaders/denoise_variance_frag.glsl");
+  atrousShader_ = std::make_unique<Shader>("./shaders/fullscreen_vert.glsl", "./shaders/denoise_atrous_frag.glsl");
+  modulateShader_ = std::make_unique<Shader>("./shaders/fullscreen_vert.glsl", "./shaders/denoise_modulate_frag.glsl");
+
+  // variance 要 32F，光照在 demodulate 之後可能遠大於 1
+  scratchSpec_.width = width;
+  scratchSpec_.height = height;
+  scratchSpec_.colorFormats = {GL_RGBA32F};
+  outputSpec_ = scratchSpec_;
+  outputSpec_.colorFormats = {GL_RGBA16F};
+
+  glGenVertexArrays(1, &emptyVAO_);
+}
+
+Denoiser::~Denoiser() {
+  if (emptyVAO_) glDeleteVertexArrays(1, &emptyVAO_);
+}
+
+RenderGraph::Resource Denoiser::addPasses(RenderGraph& graph, Input color, Input albedo, Input normalDepth,
+                                          int sampleCount, const Settings& settings, Input history) {
+  using Resource = RenderGraph::Resource;
+
+  // 1. demodulate + variance
+  Resource lighting = RenderGraph::kInvalid;
+  graph.addPass(
+      "denoise_variance",
+      [&](RenderGraph::Builder& builder) {
+        builder.read(color.resource, "colorTex", color.attachment);
+        builder.read(albedo.resource, "albedoTex", albedo.attachment);
+        builder.read(normalDepth.resource, "normalDepthTex", normalDepth.attachment);
+        if (history.resource != RenderGraph::kInvalid) {
+          builder.read(history.resource, "historyTex", history.attachment);
+        }
+        lighting = builder.create("denoise_lighting", scratchSpec_);
+        builder.write(lighting);
+      },
+      [this, sampleCount, history](const RenderGraph::Context& context) {
+        varianceShader_->use();
+        const GLuint program = varianceShader_->PROGRAM_ID;
+        context.bindInputs(program);
+        glUniform1i(glGetUniformLocation(program, "sampleCount"), std::max(sampleCount, 1));
+        glUniform1i(glGetUniformLocation(program, "perPixelHistory"), history.resource != RenderGraph::kInvalid);
+        drawFullscreen();
+      });
+
+  // 2. à-trous，step 每次加倍
+  for (int i = 0; i < settings.iterations; i++) {
+    const Resource src = lighting;
+    graph.addPass(
+        "denoise_atrous_" + std::to_string(i),
+        [&](RenderGraph::Builder& builder) {
+          builder.read(src, "colorTex");
+          builder.read(normalDepth.resource, "normalDepthTex", normalDepth.attachment);
+          lighting = builder.create("denoise_atrous_" + std::to_string(i), scratchSpec_);
+          builder.write(lighting);
+        },
+        [this, settings, i](const RenderGraph::Context& context) {
+          atrousShader_->use();
+          const GLuint program = atrousShader_->PROGRAM_ID;
+          context.bindInputs(program);
+          glUniform1f(glGetUniformLocation(program, "sigmaLuminance"), settings.sigmaLuminance);
+          glUniform1f(glGetUniformLocation(program, "sigmaNormal"), settings.sigmaNormal);
+          glUniform1f(glGetUniformLocation(program, "sigmaDepth"), settings.sigmaDepth);
+          glUniform1i(glGetUniformLocation(program, "stepSize"), 1 << i);
+          drawFullscreen();
+        });
+  }
+
+  // 3. 乘回 albedo
+  Resource output = RenderGraph::kInvalid;
+  graph.addPass(
+      "denoise_modulate",
+      [&](RenderGraph::Builder& builder) {
+        builder.read(lighting, "colorTex");
+        builder.read(albedo.resource, "albedoTex", albedo.attachment);
+        output = builder.create("denoised", outputSpec_);
+        builder.write(output);
+      },
+      [this](const RenderGraph::Context& context) {
+        modulateShader_->use();
+        context.bindInputs(modulateShader_->PROGRAM_ID);
+        drawFullscreen();
+      });
+  return output;
+}
+
+void Denoiser::drawFullscreen() const {
+  glBindVertexArray(emptyVAO_);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  glBindVertexArray(0);
+}
+
+}  // namespace gfx::render
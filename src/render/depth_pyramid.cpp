@@ -0,0 +1,59 @@
+#include "render/depth_pyramid.hpp"
+
+#include <algorithm>
+
+#include "ShaderClass.hpp"
+
+namespace gfx::render {
+
+static constexpr GLuint kTileSize = 8;  // 與 hiz_build_comp.glsl 的 local_size 一致
+
+DepthPyramid::DepthPyramid(int width, int height) : width(width), height(height), levels(1) {
+  while ((std::max(width, height) >> levels) > 0) levels++;
+
+  glGenTextures(1, &textureID);
+  glBindTexture(GL_TEXTURE_2D, textureID);
+  glTexStorage2D(GL_TEXTURE_2D, levels, GL_R32F, width, height);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  shader_ = std::make_unique<Shader>("./shaders/hiz_build_comp.glsl");
+}
+
+DepthPyramid::~DepthPyramid() {
+  if (textureID) glDeleteTextures(1, &textureID);
+}
+
+bool DepthPyramid::supported() { return GLEW_VERSION_4_3 || GLEW_ARB_compute_shader; }
+
+void DepthPyramid::build(GLuint depthTexture) {
+  shader_->use();
+  const GLuint program = shader_->PROGRAM_ID;
+  glUniform1i(glGetUniformLocation(program, "srcTex"), 0);
+  glActiveTexture(GL_TEXTURE0);
+
+  for (int level = 0; level < levels; level++) {
+    const int w = std::max(1, width >> level);
+    const int h = std::max(1, height >> level);
+
+    // level 0 從 depth buffer 複製，之後每層從上一層做 2x2 max
+    glBindTexture(GL_TEXTURE_2D, level == 0 ? depthTexture : textureID);
+    glUniform1i(glGetUniformLocation(program, "srcLevel"), level == 0 ? 0 : level - 1);
+    glUniform1i(glGetUniformLocation(program, "reduce"), level == 0 ? GL_FALSE : GL_TRUE);
+    glBindImageTexture(0, textureID, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+    glDispatchCompute((w + kTileSize - 1) / kTileSize, (h + kTileSize - 1) / kTileSize, 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void DepthPyramid::bindTexture(GLenum textureUnit) const {
+  glActiveTexture(textureUnit);
+  glBindTexture(GL_TEXTURE_2D, textureID);
+}
+
+}  // namespace gfx::render
@@ -0,0 +1,79 @@
+#include "render/gpu_instance_culler.hpp"
+
+#include "ShaderClass.hpp"
+#include "geom/frustum.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+namespace gfx::render {
+
+static constexpr GLuint kWorkGroupSize = 64;  // 與 instance_cull_comp.glsl 的 local_size_x 一致
+
+GpuInstanceCuller::GpuInstanceCuller() {
+  if (supported()) shader_ = std::make_unique<Shader>("./shaders/instance_cull_comp.glsl");
+}
+
+GpuInstanceCuller::~GpuInstanceCuller() = default;
+
+bool GpuInstanceCuller::supported() {
+  return GLEW_VERSION_4_3 ||
+         (GLEW_ARB_compute_shader && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_draw_indirect);
+}
+
+void GpuInstanceCuller::setInstances(const std::vector<glm::mat4>& instances) {
+  instanceCount_ = static_cast<GLuint>(instances.size());
+
+  instances_.bind();
+  instances_.bufferData(instances.data(), instances.size(), GL_STATIC_DRAW);
+  // 輸出 buffer 同時會被當成 instance attribute 讀
+  visible_.bind();
+  visible_.bufferData<glm::mat4>(nullptr, instances.size(), GL_DYNAMIC_COPY);
+  visible_.unbind();
+}
+
+void GpuInstanceCuller::setDrawCommands(const std::vector<GLuint>& indexCounts) {
+  initialCommands_.clear();
+  for (GLuint count : indexCounts) initialCommands_.push_back({count, 0, 0, 0, 0});
+
+  commands_.bind();
+  commands_.bufferData(initialCommands_.data(), initialCommands_.size(), GL_DYNAMIC_DRAW);
+  commands_.unbind();
+}
+
+void GpuInstanceCuller::cull(const glm::mat4& viewProj, const glm::vec3& localCenter, float localRadius) {
+  if (!shader_ || initialCommands_.empty()) return;
+
+  // instanceCount 歸零
+  commands_.bind();
+  commands_.bufferSubData(initialCommands_.data(), initialCommands_.size());
+  commands_.unbind();
+
+  const geom::Frustum frustum(viewProj);
+  shader_->use();
+  const GLuint program = shader_->PROGRAM_ID;
+  glUniform1ui(glGetUniformLocation(program, "instanceCount"), instanceCount_);
+  glUniform1ui(glGetUniformLocation(program, "commandCount"), static_cast<GLuint>(initialCommands_.size()));
+  glUniform4fv(glGetUniformLocation(program, "frustumPlanes"), geom::Frustum::PLANE_COUNT,
+               glm::value_ptr(frustum.planes[0]));
+  glUniform4f(glGetUniformLocation(program, "boundingSphere"), localCenter.x, localCenter.y, localCenter.z,
+              localRadius);
+
+  instances_.bindBase(0);
+  visible_.bindBase(1);
+  commands_.bindBase(2);
+  glDispatchCompute((instanceCount_ + kWorkGroupSize - 1) / kWorkGroupSize, 1, 1);
+
+  // 接下來會被當成 indirect command 與 vertex attribute 讀
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+GLuint GpuInstanceCuller::readVisibleCount() const {
+  if (initialCommands_.empty()) return 0;
+  DrawElementsIndirectCommand cmd{};
+  commands_.bind();
+  glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+  glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(cmd), &cmd);
+  commands_.unbind();
+  return cmd.instanceCount;
+}
+
+}  // namespace gfx::render
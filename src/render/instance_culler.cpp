@@ -0,0 +1,123 @@
+#include "render/instance_culler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "geom/frustum.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GFX_INSTANCE_CULL_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace gfx::render {
+
+namespace {
+
+// 非等比縮放時取最大軸，radius 會偏保守但不會誤剔除
+inline float maxScale(const glm::mat4& m) {
+  const float s0 = glm::dot(glm::vec3(m[0]), glm::vec3(m[0]));
+  const float s1 = glm::dot(glm::vec3(m[1]), glm::vec3(m[1]));
+  const float s2 = glm::dot(glm::vec3(m[2]), glm::vec3(m[2]));
+  return std::sqrt(std::max(s0, std::max(s1, s2)));
+}
+
+size_t cullScalar(const glm::mat4* instances, size_t begin, size_t end, const glm::vec3& c, float r,
+                  const geom::Frustum& frustum, std::vector<uint32_t>& visible) {
+  for (size_t i = begin; i < end; i++) {
+    const glm::mat4& m = instances[i];
+    const glm::vec3 center = glm::vec3(m * glm::vec4(c, 1.0f));
+    if (frustum.sphereVisible(center, r * maxScale(m))) visible.push_back(static_cast<uint32_t>(i));
+  }
+  return visible.size();
+}
+
+#ifdef GFX_INSTANCE_CULL_SSE
+// 一次處理 4 個 instance：每個 column 轉置成 SoA，之後全部是垂直運算
+size_t cullSse(const glm::mat4* instances, size_t count, const glm::vec3& c, float r, const geom::Frustum& frustum,
+               std::vector<uint32_t>& visible) {
+  __m128 px[geom::Frustum::PLANE_COUNT], py[geom::Frustum::PLANE_COUNT], pz[geom::Frustum::PLANE_COUNT],
+      pw[geom::Frustum::PLANE_COUNT];
+  for (int p = 0; p < geom::Frustum::PLANE_COUNT; p++) {
+    px[p] = _mm_set1_ps(frustum.planes[p].x);
+    py[p] = _mm_set1_ps(frustum.planes[p].y);
+    pz[p] = _mm_set1_ps(frustum.planes[p].z);
+    pw[p] = _mm_set1_ps(frustum.planes[p].w);
+  }
+  const __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+  const __m128 radius = _mm_set1_ps(r);
+
+  const size_t simdEnd = count & ~size_t(3);
+  for (size_t i = 0; i < simdEnd; i += 4) {
+    const float* m0 = &instances[i][0][0];
+    const float* m1 = &instances[i + 1][0][0];
+    const float* m2 = &instances[i + 2][0][0];
+    const float* m3 = &instances[i + 3][0][0];
+
+    // col[k][j]：4 個 instance 的第 k 個 column 的第 j 個分量
+    __m128 col[4][4];
+    for (int k = 0; k < 4; k++) {
+      col[k][0] = _mm_loadu_ps(m0 + k * 4);
+      col[k][1] = _mm_loadu_ps(m1 + k * 4);
+      col[k][2] = _mm_loadu_ps(m2 + k * 4);
+      col[k][3] = _mm_loadu_ps(m3 + k * 4);
+      _MM_TRANSPOSE4_PS(col[k][0], col[k][1], col[k][2], col[k][3]);
+    }
+
+    // world center = M * (c, 1)
+    __m128 wx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[0][0], cx), _mm_mul_ps(col[1][0], cy)),
+                           _mm_add_ps(_mm_mul_ps(col[2][0], cz), col[3][0]));
+    __m128 wy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[0][1], cx), _mm_mul_ps(col[1][1], cy)),
+                           _mm_add_ps(_mm_mul_ps(col[2][1], cz), col[3][1]));
+    __m128 wz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[0][2], cx), _mm_mul_ps(col[1][2], cy)),
+                           _mm_add_ps(_mm_mul_ps(col[2][2], cz), col[3][2]));
+
+    // world radius = r * max column length
+    __m128 s[3];
+    for (int k = 0; k < 3; k++) {
+      s[k] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[k][0], col[k][0]), _mm_mul_ps(col[k][1], col[k][1])),
+                        _mm_mul_ps(col[k][2], col[k][2]));
+    }
+    const __m128 negR = _mm_sub_ps(_mm_setzero_ps(),
+                                   _mm_mul_ps(radius, _mm_sqrt_ps(_mm_max_ps(s[0], _mm_max_ps(s[1], s[2])))));
+
+    __m128 outside = _mm_setzero_ps();
+    for (int p = 0; p < geom::Frustum::PLANE_COUNT; p++) {
+      __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], wx), _mm_mul_ps(py[p], wy)),
+                            _mm_add_ps(_mm_mul_ps(pz[p], wz), pw[p]));
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(d, negR));
+    }
+
+    const int visibleMask = ~_mm_movemask_ps(outside) & 0xF;
+    for (int k = 0; k < 4; k++) {
+      if (visibleMask & (1 << k)) visible.push_back(static_cast<uint32_t>(i + k));
+    }
+  }
+
+  return cullScalar(instances, simdEnd, count, c, r, frustum, visible);
+}
+#endif
+
+}  // namespace
+
+bool InstanceCuller::simdAvailable() {
+#ifdef GFX_INSTANCE_CULL_SSE
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t InstanceCuller::cull(const glm::mat4* instances, size_t count, const glm::vec3& localCenter, float localRadius,
+                            const glm::mat4& viewProj, std::vector<uint32_t>& visible) const {
+  visible.clear();
+  visible.reserve(count);
+  const geom::Frustum frustum(viewProj);
+
+#ifdef GFX_INSTANCE_CULL_SSE
+  if (useSimd) return cullSse(instances, count, localCenter, localRadius, frustum, visible);
+#endif
+  return cullScalar(instances, 0, count, localCenter, localRadius, frustum, visible);
+}
+
+}  // namespace gfx::render
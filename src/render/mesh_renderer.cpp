@@ -4,6 +4,9 @@
 
 #include "ShaderClass.hpp"  // 只在這裡依賴 Shader
 #include "geom/mesh.hpp"    // 取得 VAO/VBO/EBO/Textures/UBO
+#include "core/ssbo.hpp"
+#include "render/cluster_culler.hpp"
+#include "render/gpu_instance_culler.hpp"
 
 namespace gfx::render {
 
@@ -35,6 +38,20 @@ void MeshRenderer::bindTextures_(const geom::Mesh& mesh, Shader& shader) const {
   }
 }
 
+void MeshRenderer::bindConstantAttribs_(const geom::Mesh& mesh) const {
+  // 沒有 per-vertex color 的格式：attribute 關閉時 shader 讀 generic value，固定給白色
+  if (!mesh.hasVertexColor()) glVertexAttrib4f(geom::ATTRIB_COLOR, 1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+void MeshRenderer::linkInstanceMatrices_(size_t byteOffset) const {
+  // 目前綁在 GL_ARRAY_BUFFER 的 buffer 從 byteOffset 開始當作 mat4 陣列
+  const size_t vec4Size = sizeof(glm::vec4);
+  for (GLuint i = 0; i < 4; i++) {
+    glVertexAttribPointer(geom::ATTRIB_INSTANCE_MATRIX + i, 4, GL_FLOAT, GL_FALSE, 4 * vec4Size,
+                          (void*)(byteOffset + i * vec4Size));
+  }
+}
+
 void MeshRenderer::draw(const geom::Mesh& mesh, Shader& shader, uint32_t instanceCount,
                         const std::vector<uint32_t>& uboBindingPoints, unsigned primitive) const {
   shader.use();
@@ -42,6 +59,7 @@ void MeshRenderer::draw(const geom::Mesh& mesh, Shader& shader, uint32_t instanc
   bindUbos_(mesh, uboBindingPoints);
 
   mesh.vao.bind();
+  bindConstantAttribs_(mesh);
 
   const bool hasIndex = !mesh.indices.empty();
   const unsigned prim = toGLPrimitive(primitive);
@@ -68,6 +86,79 @@ void MeshRenderer::draw(const geom::Mesh& mesh, Shader& shader, uint32_t instanc
   // 負責任清潔：可視需要 unbind textures/UBOs
 }
 
+void MeshRenderer::drawClusters(const geom::Mesh& mesh, Shader& shader, const ClusterDrawList& drawList,
+                                const std::vector<uint32_t>& uboBindingPoints) const {
+  if (drawList.counts.empty()) return;
+
+  shader.use();
+  bindTextures_(mesh, shader);
+  bindUbos_(mesh, uboBindingPoints);
+
+  mesh.vao.bind();
+  bindConstantAttribs_(mesh);
+  glMultiDrawElements(GL_TRIANGLES, drawList.counts.data(), GL_UNSIGNED_INT, drawList.offsets.data(),
+                      static_cast<GLsizei>(drawList.counts.size()));
+  mesh.vao.unbind();
+}
+
+void MeshRenderer::drawLod(const geom::Mesh& mesh, Shader& shader, uint32_t lod, uint32_t instanceCount,
+                           uint32_t baseInstance, const std::vector<uint32_t>& uboBindingPoints) const {
+  if (instanceCount == 0) return;
+  if (mesh.lods.empty()) {
+    draw(mesh, shader, instanceCount, uboBindingPoints);
+    return;
+  }
+
+  const geom::MeshLod& level = mesh.lods[std::min<size_t>(lod, mesh.lods.size() - 1)];
+
+  shader.use();
+  bindTextures_(mesh, shader);
+  bindUbos_(mesh, uboBindingPoints);
+
+  mesh.vao.bind();
+  bindConstantAttribs_(mesh);
+
+  // instance mat4 從 baseInstance 開始讀
+  mesh.instanceMatrixVBO.bind();
+  linkInstanceMatrices_(baseInstance * sizeof(glm::mat4));
+
+  glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(level.indexCount), GL_UNSIGNED_INT,
+                          (void*)(level.indexOffset * sizeof(GLuint)), static_cast<GLsizei>(instanceCount));
+
+  // 還原成從 0 開始，避免影響一般的 draw
+  if (baseInstance != 0) linkInstanceMatrices_(0);
+  mesh.instanceMatrixVBO.unbind();
+  mesh.vao.unbind();
+}
+
+void MeshRenderer::drawIndirect(const geom::Mesh& mesh, Shader& shader, const core::SSBO& commands,
+                                size_t commandIndex, const core::SSBO* instances,
+                                const std::vector<uint32_t>& uboBindingPoints) const {
+  shader.use();
+  bindTextures_(mesh, shader);
+  bindUbos_(mesh, uboBindingPoints);
+
+  mesh.vao.bind();
+  bindConstantAttribs_(mesh);
+
+  // instance mat4 改從 culling 的輸出讀
+  if (instances) {
+    glBindBuffer(GL_ARRAY_BUFFER, instances->ID);
+    linkInstanceMatrices_(0);
+  }
+
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.ID);
+  glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(commandIndex * sizeof(DrawElementsIndirectCommand)));
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+  if (instances) {
+    mesh.instanceMatrixVBO.bind();
+    linkInstanceMatrices_(0);
+    mesh.instanceMatrixVBO.unbind();
+  }
+  mesh.vao.unbind();
+}
+
 void MeshRenderer::drawRange(const geom::Mesh& mesh, Shader& shader, uint32_t numVertices, uint32_t startIdx,
                              uint32_t instanceCount, const std::vector<uint32_t>& uboBindingPoints,
                              unsigned primitive) const {
@@ -76,6 +167,7 @@ void MeshRenderer::drawRange(const geom::Mesh& mesh, Shader& shader, uint32_t nu
   bindUbos_(mesh, uboBindingPoints);
 
   mesh.vao.bind();
+  bindConstantAttribs_(mesh);
   const unsigned prim = toGLPrimitive(primitive);
 
   // 僅支援非索引（對應你原本的 drawTri）
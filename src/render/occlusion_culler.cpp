@@ -0,0 +1,111 @@
+#include "render/occlusion_culler.hpp"
+
+#include "ShaderClass.hpp"
+#include "geom/frustum.hpp"
+#include "glm/gtc/type_ptr.hpp"
+#include "render/depth_pyramid.hpp"
+#include "render/gpu_instance_culler.hpp"
+
+namespace gfx::render {
+
+static constexpr GLuint kWorkGroupSize = 64;  // 與 occlusion_cull_comp.glsl 的 local_size_x 一致
+
+namespace {
+// std430：兩個 vec4
+struct ObjectBounds {
+  glm::vec4 aabbMin;
+  glm::vec4 aabbMax;
+};
+}  // namespace
+
+OcclusionCuller::OcclusionCuller() {
+  if (supported()) shader_ = std::make_unique<Shader>("./shaders/occlusion_cull_comp.glsl");
+}
+
+OcclusionCuller::~OcclusionCuller() = default;
+
+bool OcclusionCuller::supported() {
+  return GLEW_VERSION_4_3 ||
+         (GLEW_ARB_compute_shader && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_draw_indirect);
+}
+
+void OcclusionCuller::setObjects(const std::vector<geom::Bounds>& bounds, const std::vector<GLuint>& indexCounts) {
+  objectCount_ = static_cast<GLuint>(bounds.size());
+
+  std::vector<ObjectBounds> objects;
+  std::vector<DrawElementsIndirectCommand> commands;
+  objects.reserve(bounds.size());
+  commands.reserve(bounds.size());
+  for (size_t i = 0; i < bounds.size(); i++) {
+    objects.push_back({glm::vec4(bounds[i].min, 1.0f), glm::vec4(bounds[i].max, 1.0f)});
+    commands.push_back({indexCounts[i], 1, 0, 0, 0});
+  }
+  // 第一幀全部當作上一幀可見，early phase 畫全部
+  const std::vector<GLuint> visibility(bounds.size(), 1);
+  const Stats zero{};
+
+  objects_.bind();
+  objects_.bufferData(objects.data(), objects.size(), GL_STATIC_DRAW);
+  visibility_.bind();
+  visibility_.bufferData(visibility.data(), visibility.size(), GL_DYNAMIC_COPY);
+  earlyCommands_.bind();
+  earlyCommands_.bufferData(commands.data(), commands.size(), GL_DYNAMIC_DRAW);
+  lateCommands_.bind();
+  lateCommands_.bufferData(commands.data(), commands.size(), GL_DYNAMIC_DRAW);
+  stats_.bind();
+  stats_.bufferData(&zero, 1, GL_DYNAMIC_READ);
+  stats_.unbind();
+}
+
+void OcclusionCuller::cullEarly(const glm::mat4& viewProj) {
+  if (!shader_ || objectCount_ == 0) return;
+
+  const Stats zero{};
+  stats_.bind();
+  stats_.bufferSubData(&zero, 1);
+  stats_.unbind();
+
+  dispatch_(false, viewProj, earlyCommands_);
+}
+
+void OcclusionCuller::cullLate(const glm::mat4& viewProj, const DepthPyramid& pyramid) {
+  if (!shader_ || objectCount_ == 0) return;
+
+  shader_->use();
+  pyramid.bindTexture(GL_TEXTURE0);
+  glUniform1i(glGetUniformLocation(shader_->PROGRAM_ID, "depthPyramid"), 0);
+  glUniform1i(glGetUniformLocation(shader_->PROGRAM_ID, "occlusionEnabled"), occlusionEnabled);
+
+  dispatch_(true, viewProj, lateCommands_);
+}
+
+void OcclusionCuller::dispatch_(bool latePhase, const glm::mat4& viewProj, const core::SSBO& commands) {
+  const geom::Frustum frustum(viewProj);
+  shader_->use();
+  const GLuint program = shader_->PROGRAM_ID;
+  glUniform1ui(glGetUniformLocation(program, "objectCount"), objectCount_);
+  glUniform1i(glGetUniformLocation(program, "latePhase"), latePhase);
+  glUniformMatrix4fv(glGetUniformLocation(program, "viewProj"), 1, GL_FALSE, glm::value_ptr(viewProj));
+  glUniform4fv(glGetUniformLocation(program, "frustumPlanes"), geom::Frustum::PLANE_COUNT,
+               glm::value_ptr(frustum.planes[0]));
+
+  objects_.bindBase(0);
+  visibility_.bindBase(1);
+  commands.bindBase(2);
+  stats_.bindBase(3);
+  glDispatchCompute((objectCount_ + kWorkGroupSize - 1) / kWorkGroupSize, 1, 1);
+
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+OcclusionCuller::Stats OcclusionCuller::readStats() const {
+  Stats stats{};
+  if (objectCount_ == 0) return stats;
+  stats_.bind();
+  glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+  glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(stats), &stats);
+  stats_.unbind();
+  return stats;
+}
+
+}  // namespace gfx::render
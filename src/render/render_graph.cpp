@@ -0,0 +1,261 @@
+#include "render/render_graph.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+
+namespace gfx::render {
+
+RenderGraph::Resource RenderGraph::Builder::create(const std::string& name, const core::FBOSpec& spec) {
+  ResourceNode node;
+  node.name = name;
+  node.kind = Kind::Transient;
+  node.spec = spec;
+  graph_.resources_.push_back(std::move(node));
+  return static_cast<Resource>(graph_.resources_.size()) - 1;
+}
+
+void RenderGraph::Builder::read(Resource resource, const char* uniform, size_t attachment) {
+  graph_.passes_[pass_].reads.push_back({resource, uniform, attachment});
+}
+
+void RenderGraph::Builder::write(Resource resource) {
+  PassNode& pass = graph_.passes_[pass_];
+  if (!pass.writes.empty()) {
+    std::cerr << "RenderGraph: pass " << pass.name << " writes more than one render target, use MRT instead"
+              << std::endl;
+    return;
+  }
+  if (graph_.resources_[resource].kind == Kind::Texture) {
+    std::cerr << "RenderGraph: " << graph_.resources_[resource].name << " is a plain texture, use writeImage()"
+              << std::endl;
+    return;
+  }
+  pass.writes.push_back(resource);
+}
+
+void RenderGraph::Builder::writeImage(Resource resource) { graph_.passes_[pass_].imageWrites.push_back(resource); }
+
+GLuint RenderGraph::Context::texture(Resource resource, size_t attachment) const {
+  const ResourceNode& node = graph_.resources_[resource];
+  if (node.kind == Kind::Texture) return node.texture;
+  return node.target ? node.target->colorTexture(attachment) : 0;
+}
+
+core::FBO* RenderGraph::Context::target(Resource resource) const { return graph_.resources_[resource].target; }
+
+void RenderGraph::Context::bindInputs(GLuint program) const {
+  GLint unit = 0;
+  for (const Input& input : graph_.passes_[pass_].reads) {
+    if (!input.uniform) continue;
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture(input.resource, input.attachment));
+    glUniform1i(glGetUniformLocation(program, input.uniform), unit);
+    unit++;
+  }
+}
+
+RenderGraph::Resource RenderGraph::importTarget(const std::string& name, core::FBO& target) {
+  ResourceNode node;
+  node.name = name;
+  node.kind = Kind::Target;
+  node.spec = target.spec();
+  node.target = &target;
+  resources_.push_back(std::move(node));
+  return static_cast<Resource>(resources_.size()) - 1;
+}
+
+RenderGraph::Resource RenderGraph::importTexture(const std::string& name, GLuint texture, int width, int height) {
+  ResourceNode node;
+  node.name = name;
+  node.kind = Kind::Texture;
+  node.spec.width = width;
+  node.spec.height = height;
+  node.spec.colorFormats.clear();
+  node.texture = texture;
+  resources_.push_back(std::move(node));
+  return static_cast<Resource>(resources_.size()) - 1;
+}
+
+RenderGraph::Resource RenderGraph::importBackbuffer(int width, int height) {
+  ResourceNode node;
+  node.name = "backbuffer";
+  node.kind = Kind::Backbuffer;
+  node.spec.width = width;
+  node.spec.height = height;
+  resources_.push_back(std::move(node));
+  return static_cast<Resource>(resources_.size()) - 1;
+}
+
+void RenderGraph::addPass(const std::string& name, const SetupFn& setup, ExecuteFn execute) {
+  PassNode pass;
+  pass.name = name;
+  pass.execute = std::move(execute);
+  passes_.push_back(std::move(pass));
+  Builder builder(*this, static_cast<int>(passes_.size()) - 1);
+  setup(builder);
+}
+
+void RenderGraph::markOutput(Resource resource) { resources_[resource].output = true; }
+
+bool RenderGraph::writesTo(const PassNode& pass, Resource resource) const {
+  return std::find(pass.writes.begin(), pass.writes.end(), resource) != pass.writes.end() ||
+         std::find(pass.imageWrites.begin(), pass.imageWrites.end(), resource) != pass.imageWrites.end();
+}
+
+std::vector<int> RenderGraph::sortPasses() const {
+  const int count = static_cast<int>(passes_.size());
+  std::vector<std::vector<int>> before(count);  // before[j]：必須在 j 之前執行的 pass
+  for (int j = 0; j < count; j++) {
+    const PassNode& pass = passes_[j];
+    // 讀：依賴先加入的寫入者；沒有的話（先宣告讀、後宣告寫）依賴所有寫入者
+    for (const Input& input : pass.reads) {
+      std::vector<int> producers;
+      for (int i = 0; i < count; i++) {
+        if (i != j && writesTo(passes_[i], input.resource)) producers.push_back(i);
+      }
+      const bool earlier = std::any_of(producers.begin(), producers.end(), [j](int i) { return i < j; });
+      for (int i : producers) {
+        if (!earlier || i < j) before[j].push_back(i);
+      }
+    }
+    // 寫：先加入的讀取者與寫入者都要先做完（WAR / WAW）
+    for (int i = 0; i < j; i++) {
+      const PassNode& other = passes_[i];
+      auto readByOther = [&](const Input& in) { return writesTo(pass, in.resource); };
+      auto writtenByOther = [&](Resource r) { return writesTo(other, r); };
+      const bool conflict = std::any_of(other.reads.begin(), other.reads.end(), readByOther) ||
+                            std::any_of(pass.writes.begin(), pass.writes.end(), writtenByOther) ||
+                            std::any_of(pass.imageWrites.begin(), pass.imageWrites.end(), writtenByOther);
+      if (conflict) before[j].push_back(i);
+    }
+  }
+
+  // 只排存活的 pass；可以選的時候取加入順序最前面的，沒有依賴關係的 pass 維持原本的順序
+  std::vector<int> pending(count, 0);
+  for (int j = 0; j < count; j++) {
+    if (!passes_[j].alive) continue;
+    for (int i : before[j]) pending[j] += passes_[i].alive ? 1 : 0;
+  }
+  std::vector<int> order;
+  std::vector<bool> done(count, false);
+  while (true) {
+    int next = -1;
+    for (int j = 0; j < count && next < 0; j++) {
+      if (passes_[j].alive && !done[j] && pending[j] == 0) next = j;
+    }
+    if (next < 0) break;
+    done[next] = true;
+    order.push_back(next);
+    for (int j = 0; j < count; j++) {
+      if (!passes_[j].alive || done[j]) continue;
+      pending[j] -= static_cast<int>(std::count(before[j].begin(), before[j].end(), next));
+    }
+  }
+  const auto alive = std::count_if(passes_.begin(), passes_.end(), [](const PassNode& p) { return p.alive; });
+  if (order.size() != static_cast<size_t>(alive)) {
+    std::cerr << "RenderGraph: dependency cycle, some passes are skipped" << std::endl;
+  }
+  return order;
+}
+
+void RenderGraph::execute() {
+  const int count = static_cast<int>(passes_.size());
+
+  // cull：從寫入 imported / output 資源的 pass 往回找它讀的資源的寫入者
+  std::vector<int> work;
+  for (int j = 0; j < count; j++) {
+    PassNode& pass = passes_[j];
+    bool root = false;
+    for (size_t r = 0; r < resources_.size() && !root; r++) {
+      const ResourceNode& node = resources_[r];
+      root = writesTo(pass, static_cast<Resource>(r)) && (node.kind != Kind::Transient || node.output);
+    }
+    if (root) {
+      pass.alive = true;
+      work.push_back(j);
+    }
+  }
+  while (!work.empty()) {
+    const int j = work.back();
+    work.pop_back();
+    for (int i = 0; i < count; i++) {
+      if (passes_[i].alive) continue;
+      bool needed = false;
+      for (const Input& input : passes_[j].reads) needed = needed || writesTo(passes_[i], input.resource);
+      // 同一個 target 前面的寫入（例如先 clear 再畫）也要保留
+      for (Resource r : passes_[j].writes) needed = needed || (i < j && writesTo(passes_[i], r));
+      if (needed) {
+        passes_[i].alive = true;
+        work.push_back(i);
+      }
+    }
+  }
+
+  const std::vector<int> order = sortPasses();
+
+  // transient 的生命週期：排序後第一個與最後一個用到它的位置
+  const int unused = -1;
+  std::vector<int> first(resources_.size(), unused), last(resources_.size(), unused);
+  for (int pos = 0; pos < static_cast<int>(order.size()); pos++) {
+    const PassNode& pass = passes_[order[pos]];
+    auto touch = [&](Resource r) {
+      if (first[r] == unused) first[r] = pos;
+      last[r] = pos;
+    };
+    for (const Input& input : pass.reads) touch(input.resource);
+    for (Resource r : pass.writes) touch(r);
+    for (Resource r : pass.imageWrites) touch(r);
+  }
+
+  stats_ = Stats{};
+  stats_.passes = order.size();
+  stats_.culled = passes_.size() - order.size();
+  std::set<const core::FBO*> targets;
+  executed_.clear();
+
+  for (int pos = 0; pos < static_cast<int>(order.size()); pos++) {
+    PassNode& pass = passes_[order[pos]];
+    for (size_t r = 0; r < resources_.size(); r++) {
+      ResourceNode& node = resources_[r];
+      if (node.kind != Kind::Transient || first[r] != pos) continue;
+      node.target = &pool_.acquire(node.spec);
+      targets.insert(node.target);
+      stats_.transients++;
+    }
+
+    // compute 寫的內容要給 texture fetch / framebuffer 看得到
+    bool barrier = false;
+    for (const Input& input : pass.reads) {
+      barrier = barrier || resources_[input.resource].pendingImageWrite;
+      resources_[input.resource].pendingImageWrite = false;
+    }
+    if (barrier) glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    if (!pass.writes.empty()) {
+      const ResourceNode& node = resources_[pass.writes[0]];
+      glBindFramebuffer(GL_FRAMEBUFFER, node.target ? node.target->ID : 0);
+      glViewport(0, 0, node.spec.width, node.spec.height);
+    }
+    pass.execute(Context(*this, order[pos]));
+    for (Resource r : pass.imageWrites) resources_[r].pendingImageWrite = true;
+    executed_.push_back(pass.name);
+
+    for (size_t r = 0; r < resources_.size(); r++) {
+      ResourceNode& node = resources_[r];
+      if (node.kind != Kind::Transient || last[r] != pos) continue;
+      pool_.release(*node.target);
+      node.target = nullptr;
+    }
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  stats_.targets = targets.size();
+  reset();
+}
+
+void RenderGraph::reset() {
+  resources_.clear();
+  passes_.clear();
+}
+
+}  // namespace gfx::render
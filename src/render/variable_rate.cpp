@@ -0,0 +1,45 @@
+#include "render/variable_rate.hpp"
+
+#include "ShaderClass.hpp"
+
+namespace gfx::render {
+
+void VariableRateRenderer::render(Shader& shader, int width, int height, int scale, GLuint firstUnit,
+                                  const std::function<void()>& draw) {
+  const GLuint program = shader.PROGRAM_ID;
+  const core::FBOSpec spec = variableRateSpec(width, height, scale, GL_RGBA8);
+  if (!lowRes_ || lowRes_->spec() != spec) lowRes_ = std::make_unique<core::FBO>(spec);
+
+  // 1. 低解析度：guide 的 w 是距離，不能 blend；沒畫到的地方維持透明
+  const GLboolean blend = glIsEnabled(GL_BLEND);
+  glDisable(GL_BLEND);
+  lowRes_->bind();
+  glViewport(0, 0, spec.width, spec.height);
+  glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  glClear(GL_COLOR_BUFFER_BIT);
+  glUniform1i(glGetUniformLocation(program, "variableRatePass"), static_cast<GLint>(VariableRatePass::Low));
+  glUniform1f(glGetUniformLocation(program, "variableRateScale"), static_cast<float>(scale));
+  glUniform2f(glGetUniformLocation(program, "resolution"), static_cast<float>(width) / scale,
+              static_cast<float>(height) / scale);
+  draw();
+  lowRes_->unbind();
+  if (blend) glEnable(GL_BLEND);
+  glViewport(0, 0, width, height);
+
+  // 2. 全解析度：平滑的地方內插，邊緣重新 march
+  glActiveTexture(GL_TEXTURE0 + firstUnit);
+  glBindTexture(GL_TEXTURE_2D, lowRes_->colorTexture(0));
+  glActiveTexture(GL_TEXTURE0 + firstUnit + 1);
+  glBindTexture(GL_TEXTURE_2D, lowRes_->colorTexture(1));
+  glUniform1i(glGetUniformLocation(program, "lowResColor"), static_cast<GLint>(firstUnit));
+  glUniform1i(glGetUniformLocation(program, "lowResGuide"), static_cast<GLint>(firstUnit + 1));
+  glUniform1i(glGetUniformLocation(program, "variableRatePass"), static_cast<GLint>(VariableRatePass::Upsample));
+  glUniform2f(glGetUniformLocation(program, "resolution"), static_cast<float>(width), static_cast<float>(height));
+  draw();
+}
+
+void VariableRateRenderer::disable(Shader& shader) {
+  glUniform1i(glGetUniformLocation(shader.PROGRAM_ID, "variableRatePass"), static_cast<GLint>(VariableRatePass::Off));
+}
+
+}  // namespace gfx::render
@@ -0,0 +1,207 @@
+#include "render/wavefront_tracer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "ShaderClass.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+namespace gfx::render {
+
+static constexpr GLuint kWorkGroupSize = 64;  // 與 rt_wavefront.glsl 的 WF_GROUP_SIZE 一致
+static constexpr int kMaxStatBounces = 16;
+
+// 與 shader 端 std430 layout 一致（rt_wavefront.glsl）
+struct PathState {
+  glm::vec4 origin, direction, throughput, radiance;
+  GLuint rng, sampleIndex, padding[2];
+};
+static_assert(sizeof(PathState) == 80, "PathState must match the std430 layout");
+struct HitRecord {
+  glm::vec3 normal;
+  float dst;
+  GLint primitive, padding[3];
+};
+static_assert(sizeof(HitRecord) == 32, "HitRecord must match the std430 layout");
+struct ShadowRay {
+  glm::vec3 origin;
+  float dist;
+  glm::vec3 direction;
+  GLuint path;
+  glm::vec4 contribution;
+};
+static_assert(sizeof(ShadowRay) == 48, "ShadowRay must match the std430 layout");
+struct Counters {
+  GLuint rayCount[2];
+  GLuint shadowCount[2];
+  GLuint rayArgs[4];  // glDispatchComputeIndirect 的 x, y, z（第 4 個為 padding）
+  GLuint shadowArgs[4];
+};
+
+WavefrontPathTracer::WavefrontPathTracer(int width, int height, const ShaderDefines& defines)
+    : width(width), height(height), defines_(defines) {
+  if (!supported()) return;
+
+  static const char* kPassPaths[PASS_COUNT] = {
+      "./shaders/rt_wf_generate_comp.glsl", "./shaders/rt_wf_extend_comp.glsl",  "./shaders/rt_wf_shade_comp.glsl",
+      "./shaders/rt_wf_prepare_comp.glsl",  "./shaders/rt_wf_connect_comp.glsl", "./shaders/rt_wf_resolve_comp.glsl",
+  };
+  for (int i = 0; i < PASS_COUNT; i++) passes_[i] = std::make_unique<Shader>(kPassPaths[i], defines_);
+
+  // 每個 pixel 一條 path；queue 與 shadow ray 最多也是每個 pixel 一筆
+  const size_t pathCount = static_cast<size_t>(width) * height;
+  paths_.bind();
+  paths_.bufferData<PathState>(nullptr, pathCount, GL_DYNAMIC_COPY);
+  for (auto& queue : queues_) {
+    queue.bind();
+    queue.bufferData<GLuint>(nullptr, pathCount, GL_DYNAMIC_COPY);
+  }
+  hits_.bind();
+  hits_.bufferData<HitRecord>(nullptr, pathCount, GL_DYNAMIC_COPY);
+  shadowRays_.bind();
+  shadowRays_.bufferData<ShadowRay>(nullptr, pathCount, GL_DYNAMIC_COPY);
+  counters_.bind();
+  counters_.bufferData<Counters>(nullptr, 1, GL_DYNAMIC_COPY);
+  activePaths_.bind();
+  activePaths_.bufferData<GLuint>(nullptr, kMaxStatBounces, GL_DYNAMIC_COPY);
+  activePaths_.unbind();
+
+  for (GLuint* texture : {&textureID, &albedoTextureID, &normalDepthTextureID}) {
+    glGenTextures(1, texture);
+    glBindTexture(GL_TEXTURE_2D, *texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+WavefrontPathTracer::~WavefrontPathTracer() {
+  const GLuint textures[] = {textureID, albedoTextureID, normalDepthTextureID};
+  glDeleteTextures(3, textures);  // 0 會被忽略
+}
+
+bool WavefrontPathTracer::supported() { return GLEW_VERSION_4_3; }
+
+void WavefrontPathTracer::setDefines(const ShaderDefines& defines) {
+  if (defines == defines_) return;
+  defines_ = defines;
+  for (auto& pass : passes_) {
+    if (pass) pass->setDefines(defines_);
+  }
+}
+
+void WavefrontPathTracer::setLights(const std::vector<int32_t>& lights) { lights_ = lights; }
+
+void WavefrontPathTracer::render(const Frame& frame) {
+  if (!passes_[GENERATE]) return;
+
+  const auto pathCount = static_cast<GLuint>(width * height);
+  const GLuint groups = (pathCount + kWorkGroupSize - 1) / kWorkGroupSize;
+  const int numBounces = std::max(frame.numBounces, 1);
+  const int numRays = std::max(frame.numRays, 1);
+
+  // 沒用到的 uniform location 是 -1，glUniform 會直接忽略，所以每個 pass 設同一組
+  for (auto& pass : passes_) {
+    pass->use();
+    const GLuint program = pass->PROGRAM_ID;
+    glUniform1f(glGetUniformLocation(program, "fov"), frame.fov);
+    glUniform1ui(glGetUniformLocation(program, "frameIdx"), frame.frameIdx);
+    glUniform2f(glGetUniformLocation(program, "resolution"), static_cast<float>(width), static_cast<float>(height));
+    glUniform3fv(glGetUniformLocation(program, "camPosition"), 1, glm::value_ptr(frame.camPosition));
+    glUniformMatrix4fv(glGetUniformLocation(program, "viewMatrix"), 1, GL_FALSE, glm::value_ptr(frame.viewMatrix));
+    glUniform1f(glGetUniformLocation(program, "ambientLight"), frame.ambientLight);
+    glUniform1i(glGetUniformLocation(program, "sphereRoot"), frame.sphereRoot);
+    glUniform1i(glGetUniformLocation(program, "triangleRoot"), frame.triangleRoot);
+    glUniform1ui(glGetUniformLocation(program, "pathCount"), pathCount);
+    glUniform1i(glGetUniformLocation(program, "lightCount"), static_cast<GLint>(lights_.size()));
+    if (!lights_.empty()) {
+      glUniform1iv(glGetUniformLocation(program, "lightList"), static_cast<GLsizei>(lights_.size()), lights_.data());
+    }
+    glUniform1i(glGetUniformLocation(program, "numBounces"), numBounces);
+    glUniform1i(glGetUniformLocation(program, "numSamples"), numRays);
+    glUniform1i(glGetUniformLocation(program, "samplerType"), frame.samplerType);
+    if (frame.blueNoiseUnit >= 0) glUniform1i(glGetUniformLocation(program, "blueNoiseTex"), frame.blueNoiseUnit);
+  }
+
+  paths_.bindBase(4);
+  hits_.bindBase(7);
+  shadowRays_.bindBase(8);
+  counters_.bindBase(9);
+  glBindImageTexture(1, albedoTextureID, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+  glBindImageTexture(2, normalDepthTextureID, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+  glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, counters_.ID);
+
+  const auto dispatchRays = static_cast<GLintptr>(offsetof(Counters, rayArgs));
+  const auto dispatchShadows = static_cast<GLintptr>(offsetof(Counters, shadowArgs));
+  lastBounces_ = std::min(numBounces, kMaxStatBounces);
+
+  for (int sample = 0; sample < numRays; sample++) {
+    // 所有 path 都在第一個 queue，第一個 bounce 的 dispatch 大小已知
+    const Counters initial{{pathCount, 0}, {0, 0}, {groups, 1, 1, 0}, {0, 1, 1, 0}};
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    counters_.bind();
+    counters_.bufferSubData(&initial, 1);
+    counters_.unbind();
+
+    passes_[GENERATE]->use();
+    glUniform1i(glGetUniformLocation(passes_[GENERATE]->PROGRAM_ID, "sampleIndex"), sample);
+    queues_[0].bindBase(6);
+    glDispatchCompute(groups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);  // G-buffer 先清再由 shade 寫
+
+    for (int bounce = 0; bounce < numBounces; bounce++) {
+      const int in = bounce & 1;
+      queues_[in].bindBase(5);
+      queues_[in ^ 1].bindBase(6);
+      if (sample == 0 && bounce < kMaxStatBounces) {
+        glBindBuffer(GL_COPY_READ_BUFFER, counters_.ID);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, activePaths_.ID);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, in * sizeof(GLuint), bounce * sizeof(GLuint),
+                            sizeof(GLuint));
+      }
+
+      passes_[EXTEND]->use();
+      glUniform1i(glGetUniformLocation(passes_[EXTEND]->PROGRAM_ID, "queueIndex"), in);
+      glDispatchComputeIndirect(dispatchRays);
+      glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+      passes_[SHADE]->use();
+      glUniform1i(glGetUniformLocation(passes_[SHADE]->PROGRAM_ID, "queueIndex"), in);
+      glUniform1i(glGetUniformLocation(passes_[SHADE]->PROGRAM_ID, "bounce"), bounce);
+      glUniform1i(glGetUniformLocation(passes_[SHADE]->PROGRAM_ID, "writeGBuffer"), sample == 0 && bounce == 0);
+      glDispatchComputeIndirect(dispatchRays);
+      glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+      // queue 大小 → 下一個 indirect dispatch 的參數
+      passes_[PREPARE]->use();
+      glUniform1i(glGetUniformLocation(passes_[PREPARE]->PROGRAM_ID, "queueIndex"), in);
+      glDispatchCompute(1, 1, 1);
+      glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+      passes_[CONNECT]->use();
+      glUniform1i(glGetUniformLocation(passes_[CONNECT]->PROGRAM_ID, "queueIndex"), in);
+      glDispatchComputeIndirect(dispatchShadows);
+      glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+  }
+  glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+
+  passes_[RESOLVE]->use();
+  glBindImageTexture(0, textureID, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+  glDispatchCompute(groups, 1, 1);
+  glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);  // 也涵蓋 generate / shade 寫的 G-buffer
+}
+
+std::vector<GLuint> WavefrontPathTracer::readActivePaths() {
+  std::vector<GLuint> counts(lastBounces_);
+  if (counts.empty()) return counts;
+  activePaths_.bind();
+  glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, counts.size() * sizeof(GLuint), counts.data());
+  activePaths_.unbind();
+  return counts;
+}
+
+}  // namespace gfx::render
@@ -0,0 +1,324 @@
+#include "resource/bc_encoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace gfx::resource {
+
+namespace {
+
+// 用 covariance 的主軸（power iteration）找 endpoints，比各通道 min/max 的 bounding box 更貼近實際分布
+void fitEndpoints(const float px[16][4], int channels, float e0[4], float e1[4]) {
+  float mean[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 16; i++)
+    for (int c = 0; c < channels; c++) mean[c] += px[i][c] / 16.0f;
+
+  float cov[4][4] = {};
+  for (int i = 0; i < 16; i++) {
+    for (int a = 0; a < channels; a++) {
+      for (int b = 0; b < channels; b++) cov[a][b] += (px[i][a] - mean[a]) * (px[i][b] - mean[b]);
+    }
+  }
+
+  // 起點取 min/max 對角線，比固定向量收斂快
+  float axis[4] = {0, 0, 0, 0};
+  for (int c = 0; c < channels; c++) {
+    float lo = 255.0f, hi = 0.0f;
+    for (int i = 0; i < 16; i++) {
+      lo = std::min(lo, px[i][c]);
+      hi = std::max(hi, px[i][c]);
+    }
+    axis[c] = hi - lo;
+  }
+  for (int iter = 0; iter < 8; iter++) {
+    float next[4] = {0, 0, 0, 0};
+    float len = 0.0f;
+    for (int a = 0; a < channels; a++) {
+      for (int b = 0; b < channels; b++) next[a] += cov[a][b] * axis[b];
+      len += next[a] * next[a];
+    }
+    if (len < 1e-12f) break;
+    len = std::sqrt(len);
+    for (int c = 0; c < channels; c++) axis[c] = next[c] / len;
+  }
+
+  float tMin = 0.0f, tMax = 0.0f;
+  for (int i = 0; i < 16; i++) {
+    float t = 0.0f;
+    for (int c = 0; c < channels; c++) t += (px[i][c] - mean[c]) * axis[c];
+    tMin = std::min(tMin, t);
+    tMax = std::max(tMax, t);
+  }
+  for (int c = 0; c < channels; c++) {
+    e0[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+    e1[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+  }
+}
+
+void toFloat(const uint8_t rgba[64], float px[16][4]) {
+  for (int i = 0; i < 16; i++)
+    for (int c = 0; c < 4; c++) px[i][c] = rgba[i * 4 + c];
+}
+
+uint16_t to565(const float c[3]) {
+  const int r = static_cast<int>(std::lround(c[0] * 31.0f / 255.0f));
+  const int g = static_cast<int>(std::lround(c[1] * 63.0f / 255.0f));
+  const int b = static_cast<int>(std::lround(c[2] * 31.0f / 255.0f));
+  return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void from565(uint16_t v, int c[3]) {
+  const int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+  c[0] = (r << 3) | (r >> 2);
+  c[1] = (g << 2) | (g >> 4);
+  c[2] = (b << 3) | (b >> 2);
+}
+
+void writeLE16(uint8_t *out, uint16_t v) {
+  out[0] = static_cast<uint8_t>(v & 0xFF);
+  out[1] = static_cast<uint8_t>(v >> 8);
+}
+
+// BC1 的 color 部分，永遠用 4 色模式（c0 > c1），BC3 也共用
+void encodeColorBlock(const float px[16][4], uint8_t out[8]) {
+  float e0[4], e1[4];
+  fitEndpoints(px, 3, e0, e1);
+  uint16_t c0 = to565(e1), c1 = to565(e0);
+  if (c0 < c1) std::swap(c0, c1);
+  writeLE16(out, c0);
+  writeLE16(out + 2, c1);
+
+  uint32_t bits = 0;
+  if (c0 != c1) {
+    int p[4][3];
+    from565(c0, p[0]);
+    from565(c1, p[1]);
+    for (int c = 0; c < 3; c++) {
+      p[2][c] = (2 * p[0][c] + p[1][c]) / 3;
+      p[3][c] = (p[0][c] + 2 * p[1][c]) / 3;
+    }
+    for (int i = 0; i < 16; i++) {
+      int best = 0;
+      float bestErr = 1e30f;
+      for (int k = 0; k < 4; k++) {
+        float err = 0.0f;
+        for (int c = 0; c < 3; c++) err += (px[i][c] - p[k][c]) * (px[i][c] - p[k][c]);
+        if (err < bestErr) {
+          bestErr = err;
+          best = k;
+        }
+      }
+      bits |= static_cast<uint32_t>(best) << (2 * i);
+    }
+  }
+  std::memcpy(out + 4, &bits, 4);  // little-endian host
+}
+
+// BC4：單通道 8 值模式（a0 > a1）
+void encodeSingleChannel(const float px[16][4], int channel, uint8_t out[8]) {
+  float lo = 255.0f, hi = 0.0f;
+  for (int i = 0; i < 16; i++) {
+    lo = std::min(lo, px[i][channel]);
+    hi = std::max(hi, px[i][channel]);
+  }
+  const int a0 = static_cast<int>(std::lround(hi)), a1 = static_cast<int>(std::lround(lo));
+  out[0] = static_cast<uint8_t>(a0);
+  out[1] = static_cast<uint8_t>(a1);
+
+  uint64_t bits = 0;
+  if (a0 != a1) {
+    int palette[8] = {a0, a1};
+    for (int k = 2; k < 8; k++) palette[k] = ((8 - k) * a0 + (k - 1) * a1) / 7;
+    for (int i = 0; i < 16; i++) {
+      int best = 0;
+      float bestErr = 1e30f;
+      for (int k = 0; k < 8; k++) {
+        const float err = std::fabs(px[i][channel] - palette[k]);
+        if (err < bestErr) {
+          bestErr = err;
+          best = k;
+        }
+      }
+      bits |= static_cast<uint64_t>(best) << (3 * i);
+    }
+  }
+  for (int b = 0; b < 6; b++) out[2 + b] = static_cast<uint8_t>(bits >> (8 * b));
+}
+
+// BC7 bit stream 是 LSB first
+struct BitWriter {
+  uint8_t *out;
+  int pos = 0;
+  void write(uint32_t value, int count) {
+    for (int i = 0; i < count; i++, pos++) {
+      if (value & (1u << i)) out[pos >> 3] |= static_cast<uint8_t>(1u << (pos & 7));
+    }
+  }
+};
+
+}  // namespace
+
+size_t bcBlockBytes(BcFormat format) { return format == BcFormat::BC1 ? 8 : 16; }
+
+size_t bcImageBytes(BcFormat format, int width, int height) {
+  return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * bcBlockBytes(format);
+}
+
+const char *bcFormatName(BcFormat format) {
+  switch (format) {
+    case BcFormat::BC1:
+      return "BC1";
+    case BcFormat::BC3:
+      return "BC3";
+    case BcFormat::BC5:
+      return "BC5";
+    case BcFormat::BC7:
+      return "BC7";
+  }
+  return "?";
+}
+
+void encodeBlockBC1(const uint8_t rgba[64], uint8_t out[8]) {
+  float px[16][4];
+  toFloat(rgba, px);
+  encodeColorBlock(px, out);
+}
+
+void encodeBlockBC3(const uint8_t rgba[64], uint8_t out[16]) {
+  float px[16][4];
+  toFloat(rgba, px);
+  encodeSingleChannel(px, 3, out);
+  encodeColorBlock(px, out + 8);
+}
+
+void encodeBlockBC5(const uint8_t rgba[64], uint8_t out[16]) {
+  float px[16][4];
+  toFloat(rgba, px);
+  encodeSingleChannel(px, 0, out);
+  encodeSingleChannel(px, 1, out + 8);
+}
+
+void encodeBlockBC7(const uint8_t rgba[64], uint8_t out[16]) {
+  static const int weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+  float px[16][4];
+  toFloat(rgba, px);
+  float e[2][4];
+  fitEndpoints(px, 4, e[0], e[1]);
+
+  // 每個 endpoint 是 7-bit + 共用的 p-bit，試兩種 p-bit 取誤差小的
+  int q[2][4], p[2];
+  for (int k = 0; k < 2; k++) {
+    float bestErr = 1e30f;
+    for (int pb = 0; pb < 2; pb++) {
+      float err = 0.0f;
+      int cand[4];
+      for (int c = 0; c < 4; c++) {
+        cand[c] = std::clamp(static_cast<int>(std::lround((e[k][c] - pb) / 2.0f)), 0, 127);
+        const float d = e[k][c] - static_cast<float>((cand[c] << 1) | pb);
+        err += d * d;
+      }
+      if (err < bestErr) {
+        bestErr = err;
+        p[k] = pb;
+        std::copy(cand, cand + 4, q[k]);
+      }
+    }
+  }
+
+  auto buildPalette = [&](int palette[16][4]) {
+    for (int c = 0; c < 4; c++) {
+      const int v0 = (q[0][c] << 1) | p[0], v1 = (q[1][c] << 1) | p[1];
+      for (int w = 0; w < 16; w++) palette[w][c] = ((64 - weights[w]) * v0 + weights[w] * v1 + 32) >> 6;
+    }
+  };
+  int palette[16][4];
+  buildPalette(palette);
+
+  int idx[16];
+  for (int i = 0; i < 16; i++) {
+    float bestErr = 1e30f;
+    for (int w = 0; w < 16; w++) {
+      float err = 0.0f;
+      for (int c = 0; c < 4; c++) err += (px[i][c] - palette[w][c]) * (px[i][c] - palette[w][c]);
+      if (err < bestErr) {
+        bestErr = err;
+        idx[i] = w;
+      }
+    }
+  }
+
+  // anchor（第 0 個 texel）的 index 最高位隱含為 0，不符合就交換 endpoints 並反轉 index
+  if (idx[0] & 8) {
+    std::swap(q[0], q[1]);
+    std::swap(p[0], p[1]);
+    for (int &i : idx) i = 15 - i;
+  }
+
+  std::memset(out, 0, 16);
+  BitWriter bw{out};
+  bw.write(1u << 6, 7);  // mode 6
+  for (int c = 0; c < 4; c++) {
+    bw.write(q[0][c], 7);
+    bw.write(q[1][c], 7);
+  }
+  bw.write(p[0], 1);
+  bw.write(p[1], 1);
+  bw.write(idx[0], 3);
+  for (int i = 1; i < 16; i++) bw.write(idx[i], 4);
+}
+
+std::vector<uint8_t> compressImage(const uint8_t *rgba, int width, int height, BcFormat format, unsigned numThreads) {
+  const int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+  const size_t blockBytes = bcBlockBytes(format);
+  std::vector<uint8_t> out(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+  auto encodeRows = [&](int rowBegin, int rowEnd) {
+    uint8_t block[64];
+    for (int by = rowBegin; by < rowEnd; by++) {
+      for (int bx = 0; bx < blocksX; bx++) {
+        for (int y = 0; y < 4; y++) {
+          const int sy = std::min(by * 4 + y, height - 1);
+          for (int x = 0; x < 4; x++) {
+            const int sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(block + (y * 4 + x) * 4, rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+          }
+        }
+        uint8_t *dst = out.data() + (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+        switch (format) {
+          case BcFormat::BC1:
+            encodeBlockBC1(block, dst);
+            break;
+          case BcFormat::BC3:
+            encodeBlockBC3(block, dst);
+            break;
+          case BcFormat::BC5:
+            encodeBlockBC5(block, dst);
+            break;
+          case BcFormat::BC7:
+            encodeBlockBC7(block, dst);
+            break;
+        }
+      }
+    }
+  };
+
+  if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+  numThreads = std::min<unsigned>(numThreads, static_cast<unsigned>(blocksY));
+  if (numThreads <= 1) {
+    encodeRows(0, blocksY);
+    return out;
+  }
+
+  std::vector<std::thread> threads;
+  const int rowsPerThread = (blocksY + static_cast<int>(numThreads) - 1) / static_cast<int>(numThreads);
+  for (int begin = 0; begin < blocksY; begin += rowsPerThread) {
+    threads.emplace_back(encodeRows, begin, std::min(begin + rowsPerThread, blocksY));
+  }
+  for (auto &t : threads) t.join();
+  return out;
+}
+
+}  // namespace gfx::resource
@@ -0,0 +1,443 @@
+#include "resource/image_ops.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GFX_IMAGE_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define GFX_IMAGE_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define GFX_IMAGE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace gfx::resource {
+
+namespace {
+
+// 小圖開 thread 不划算，約 1 MB 以上才分
+constexpr size_t PARALLEL_MIN_BYTES = 1u << 20;
+
+template <typename F>
+void parallelRows(int rows, size_t bytes, F &&fn) {
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  const int numThreads = std::min<int>(static_cast<int>(hw), rows / 16);
+  if (bytes < PARALLEL_MIN_BYTES || numThreads <= 1) {
+    fn(0, rows);
+    return;
+  }
+  std::vector<std::thread> threads;
+  const int rowsPerThread = (rows + numThreads - 1) / numThreads;
+  for (int begin = 0; begin < rows; begin += rowsPerThread) {
+    threads.emplace_back(fn, begin, std::min(begin + rowsPerThread, rows));
+  }
+  for (auto &t : threads) t.join();
+}
+
+void swapBytes(uint8_t *a, uint8_t *b, size_t n) {
+  size_t i = 0;
+#ifdef GFX_IMAGE_AVX2
+  for (; i + 32 <= n; i += 32) {
+    const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), vb);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(b + i), va);
+  }
+#endif
+#ifdef GFX_IMAGE_SSE2
+  for (; i + 16 <= n; i += 16) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(a + i), vb);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(b + i), va);
+  }
+#endif
+  for (; i < n; i++) std::swap(a[i], b[i]);
+}
+
+// 把 [lo, hi] 之間的 pixel 兩兩交換（scalar，處理 SIMD 剩下的中段）
+void reversePixels(uint8_t *row, int lo, int hi, int channels) {
+  for (; lo < hi; lo++, hi--) {
+    uint8_t *a = row + lo * channels;
+    uint8_t *b = row + hi * channels;
+    for (int c = 0; c < channels; c++) std::swap(a[c], b[c]);
+  }
+}
+
+void flipRowRgba(uint8_t *row, int width) {
+  int lo = 0, hi = width - 1;  // 還沒處理的範圍 [lo, hi]
+#ifdef GFX_IMAGE_AVX2
+  const __m256i reverse8 = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+  for (; hi - lo + 1 >= 16; lo += 8, hi -= 8) {
+    auto *pl = reinterpret_cast<__m256i *>(row + lo * 4);
+    auto *ph = reinterpret_cast<__m256i *>(row + (hi - 7) * 4);
+    const __m256i l = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(pl), reverse8);
+    const __m256i h = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(ph), reverse8);
+    _mm256_storeu_si256(pl, h);
+    _mm256_storeu_si256(ph, l);
+  }
+#endif
+#ifdef GFX_IMAGE_SSE2
+  for (; hi - lo + 1 >= 8; lo += 4, hi -= 4) {
+    auto *pl = reinterpret_cast<__m128i *>(row + lo * 4);
+    auto *ph = reinterpret_cast<__m128i *>(row + (hi - 3) * 4);
+    const __m128i l = _mm_shuffle_epi32(_mm_loadu_si128(pl), _MM_SHUFFLE(0, 1, 2, 3));
+    const __m128i h = _mm_shuffle_epi32(_mm_loadu_si128(ph), _MM_SHUFFLE(0, 1, 2, 3));
+    _mm_storeu_si128(pl, h);
+    _mm_storeu_si128(ph, l);
+  }
+#endif
+  reversePixels(row, lo, hi, 4);
+}
+
+void flipRowGray(uint8_t *row, int width) {
+  int lo = 0, hi = width - 1;
+#ifdef GFX_IMAGE_SSSE3
+  const __m128i reverse16 = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  for (; hi - lo + 1 >= 32; lo += 16, hi -= 16) {
+    auto *pl = reinterpret_cast<__m128i *>(row + lo);
+    auto *ph = reinterpret_cast<__m128i *>(row + hi - 15);
+    const __m128i l = _mm_shuffle_epi8(_mm_loadu_si128(pl), reverse16);
+    const __m128i h = _mm_shuffle_epi8(_mm_loadu_si128(ph), reverse16);
+    _mm_storeu_si128(pl, h);
+    _mm_storeu_si128(ph, l);
+  }
+#endif
+  reversePixels(row, lo, hi, 1);
+}
+
+struct SrgbTables {
+  float toLinear[256];
+  uint8_t toSrgb[4096];  // linear 量化成 12-bit 後查表
+
+  SrgbTables() {
+    for (int i = 0; i < 256; i++) {
+      const float c = i / 255.0f;
+      toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    for (int i = 0; i < 4096; i++) {
+      const float l = i / 4095.0f;
+      const float s = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+      toSrgb[i] = static_cast<uint8_t>(std::lround(std::clamp(s, 0.0f, 1.0f) * 255.0f));
+    }
+  }
+};
+
+const SrgbTables &srgbTables() {
+  static const SrgbTables tables;
+  return tables;
+}
+
+inline uint8_t encodeSrgb(const SrgbTables &t, float linear) {
+  const int idx = static_cast<int>(std::clamp(linear, 0.0f, 1.0f) * 4095.0f + 0.5f);
+  return t.toSrgb[idx];
+}
+
+inline int clampedPixel(int x, int size) { return std::min(x, size - 1); }
+
+void downsampleRowScalar(const uint8_t *r0, const uint8_t *r1, int srcWidth, int channels, uint8_t *dst, int xBegin,
+                         int xEnd) {
+  for (int x = xBegin; x < xEnd; x++) {
+    const int x0 = clampedPixel(2 * x, srcWidth) * channels, x1 = clampedPixel(2 * x + 1, srcWidth) * channels;
+    for (int c = 0; c < channels; c++) {
+      dst[x * channels + c] = static_cast<uint8_t>((r0[x0 + c] + r0[x1 + c] + r1[x0 + c] + r1[x1 + c] + 2) >> 2);
+    }
+  }
+}
+
+void downsampleRowSrgb(const uint8_t *r0, const uint8_t *r1, int srcWidth, int channels, uint8_t *dst, int dstWidth) {
+  const SrgbTables &t = srgbTables();
+  const int colorChannels = channels == 4 ? 3 : (channels == 2 ? 1 : channels);
+  for (int x = 0; x < dstWidth; x++) {
+    const int x0 = clampedPixel(2 * x, srcWidth) * channels, x1 = clampedPixel(2 * x + 1, srcWidth) * channels;
+    for (int c = 0; c < channels; c++) {
+      if (c < colorChannels) {
+        const float sum = t.toLinear[r0[x0 + c]] + t.toLinear[r0[x1 + c]] + t.toLinear[r1[x0 + c]] +
+                          t.toLinear[r1[x1 + c]];
+        dst[x * channels + c] = encodeSrgb(t, sum * 0.25f);
+      } else {
+        dst[x * channels + c] = static_cast<uint8_t>((r0[x0 + c] + r0[x1 + c] + r1[x0 + c] + r1[x1 + c] + 2) >> 2);
+      }
+    }
+  }
+}
+
+#ifdef GFX_IMAGE_SSE2
+// 一次讀 4 個來源 pixel（16 bytes）產生 2 個輸出 pixel；回傳處理到的輸出 x
+int downsampleRowRgbaSse2(const uint8_t *r0, const uint8_t *r1, int srcWidth, uint8_t *dst, int dstWidth) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i two = _mm_set1_epi16(2);
+  int x = 0;
+  for (; x + 2 <= dstWidth && 2 * x + 4 <= srcWidth; x += 2) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r0 + x * 8));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r1 + x * 8));
+    // 上下兩列先相加：lo 為來源 pixel 0,1，hi 為 2,3（16-bit）
+    const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+    // 再左右相加
+    const __m128i s01 = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+    const __m128i s23 = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+    const __m128i sum = _mm_unpacklo_epi64(s01, s23);
+    const __m128i avg = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + x * 4), _mm_packus_epi16(avg, zero));
+  }
+  return x;
+}
+#endif
+
+// reflect-101：... 2 1 | 0 1 2 ... n-2 n-1 | n-2 n-3 ...
+inline int reflect101(int i, int n) {
+  if (n == 1) return 0;
+  while (i < 0 || i >= n) i = i < 0 ? -i : 2 * (n - 1) - i;
+  return i;
+}
+
+// 與 cv::getGaussianKernel 相同的權重（sigma <= 0 時由 kernel 大小推得），總和為 1
+std::vector<float> gaussianKernel(int radius, float sigma) {
+  const int size = 2 * radius + 1;
+  if (sigma <= 0.0f) sigma = 0.3f * ((size - 1) * 0.5f - 1.0f) + 0.8f;
+  std::vector<float> kernel(size);
+  float sum = 0.0f;
+  for (int i = 0; i < size; i++) {
+    const float d = static_cast<float>(i - radius);
+    kernel[i] = std::exp(-d * d / (2.0f * sigma * sigma));
+    sum += kernel[i];
+  }
+  for (float &k : kernel) k /= sum;
+  return kernel;
+}
+
+void bytesToFloat(const uint8_t *src, float *dst, size_t count) {
+  size_t i = 0;
+#ifdef GFX_IMAGE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= count; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    const __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+    _mm_storeu_ps(dst + i + 0, _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+    _mm_storeu_ps(dst + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)));
+    _mm_storeu_ps(dst + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)));
+    _mm_storeu_ps(dst + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)));
+  }
+#endif
+  for (; i < count; i++) dst[i] = src[i];
+}
+
+void floatToBytes(const float *src, uint8_t *dst, size_t count) {
+  size_t i = 0;
+#ifdef GFX_IMAGE_SSE2
+  // cvtps 四捨五入，pack 時飽和到 [0, 255]
+  for (; i + 16 <= count; i += 16) {
+    const __m128i a = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 0));
+    const __m128i b = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 4));
+    const __m128i c = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 8));
+    const __m128i d = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 12));
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), packed);
+  }
+#endif
+  for (; i < count; i++) dst[i] = static_cast<uint8_t>(std::clamp(static_cast<int>(src[i] + 0.5f), 0, 255));
+}
+
+// acc[i] += weight * src[i]，blur 的兩個方向都只用這個
+void madRow(float *acc, const float *src, float weight, size_t count) {
+  size_t i = 0;
+#ifdef GFX_IMAGE_AVX2
+  const __m256 w8 = _mm256_set1_ps(weight);
+  for (; i + 8 <= count; i += 8) {
+    const __m256 v = _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(w8, _mm256_loadu_ps(src + i)));
+    _mm256_storeu_ps(acc + i, v);
+  }
+#endif
+#ifdef GFX_IMAGE_SSE2
+  const __m128 w4 = _mm_set1_ps(weight);
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(w4, _mm_loadu_ps(src + i))));
+  }
+#endif
+  for (; i < count; i++) acc[i] += weight * src[i];
+}
+
+}  // namespace
+
+void flipImageHorizontal(uint8_t *data, int width, int height, int channels) {
+  const size_t stride = static_cast<size_t>(width) * channels;
+  parallelRows(height, stride * height, [&](int begin, int end) {
+    for (int y = begin; y < end; y++) {
+      uint8_t *row = data + y * stride;
+      if (channels == 4) {
+        flipRowRgba(row, width);
+      } else if (channels == 1) {
+        flipRowGray(row, width);
+      } else {
+        reversePixels(row, 0, width - 1, channels);
+      }
+    }
+  });
+}
+
+void flipImageVertical(uint8_t *data, int width, int height, int channels) {
+  const size_t stride = static_cast<size_t>(width) * channels;
+  parallelRows(height / 2, stride * height, [&](int begin, int end) {
+    for (int y = begin; y < end; y++) swapBytes(data + y * stride, data + (height - 1 - y) * stride, stride);
+  });
+}
+
+void swizzleRgba(uint8_t *data, size_t pixelCount, const int order[4]) {
+  size_t i = 0;
+#ifdef GFX_IMAGE_SSSE3
+  alignas(16) int8_t mask[16];
+  for (int p = 0; p < 4; p++)
+    for (int c = 0; c < 4; c++) mask[p * 4 + c] = static_cast<int8_t>(p * 4 + order[c]);
+  const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+#ifdef GFX_IMAGE_AVX2
+  const __m256i shuffle256 = _mm256_broadcastsi128_si256(shuffle);
+  for (; i + 8 <= pixelCount; i += 8) {
+    auto *p = reinterpret_cast<__m256i *>(data + i * 4);
+    _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), shuffle256));
+  }
+#endif
+  for (; i + 4 <= pixelCount; i += 4) {
+    auto *p = reinterpret_cast<__m128i *>(data + i * 4);
+    _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), shuffle));
+  }
+#endif
+  for (; i < pixelCount; i++) {
+    uint8_t *px = data + i * 4;
+    const uint8_t src[4] = {px[0], px[1], px[2], px[3]};
+    for (int c = 0; c < 4; c++) px[c] = src[order[c]];
+  }
+}
+
+void expandRgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixelCount, uint8_t alpha) {
+  size_t i = 0;
+#ifdef GFX_IMAGE_SSSE3
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+  // 每次讀 16 bytes 只用前 12 bytes，最後幾個 pixel 留給 scalar 避免讀超出 src
+  for (; i + 6 <= pixelCount; i += 4) {
+    const __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alphaMask));
+  }
+#endif
+  for (; i < pixelCount; i++) {
+    dst[i * 4 + 0] = src[i * 3 + 0];
+    dst[i * 4 + 1] = src[i * 3 + 1];
+    dst[i * 4 + 2] = src[i * 3 + 2];
+    dst[i * 4 + 3] = alpha;
+  }
+}
+
+void srgbToLinear(const uint8_t *src, float *dst, size_t count) {
+  const SrgbTables &t = srgbTables();
+  for (size_t i = 0; i < count; i++) dst[i] = t.toLinear[src[i]];
+}
+
+void linearToSrgb(const float *src, uint8_t *dst, size_t count) {
+  const SrgbTables &t = srgbTables();
+  for (size_t i = 0; i < count; i++) dst[i] = encodeSrgb(t, src[i]);
+}
+
+void downsampleBox(const uint8_t *src, int width, int height, int channels, uint8_t *dst, bool srgb) {
+  const int dstWidth = std::max(1, width / 2), dstHeight = std::max(1, height / 2);
+  const size_t srcStride = static_cast<size_t>(width) * channels;
+  const size_t dstStride = static_cast<size_t>(dstWidth) * channels;
+
+  parallelRows(dstHeight, srcStride * height, [&](int begin, int end) {
+    for (int y = begin; y < end; y++) {
+      const uint8_t *r0 = src + clampedPixel(2 * y, height) * srcStride;
+      const uint8_t *r1 = src + clampedPixel(2 * y + 1, height) * srcStride;
+      uint8_t *out = dst + y * dstStride;
+      if (srgb) {
+        downsampleRowSrgb(r0, r1, width, channels, out, dstWidth);
+        continue;
+      }
+      int x = 0;
+#ifdef GFX_IMAGE_SSE2
+      if (channels == 4) x = downsampleRowRgbaSse2(r0, r1, width, out, dstWidth);
+#endif
+      downsampleRowScalar(r0, r1, width, channels, out, x, dstWidth);
+    }
+  });
+}
+
+void rollImage(const uint8_t *src, uint8_t *dst, int width, int height, int channels, int dx, int dy) {
+  dx = ((dx % width) + width) % width;
+  dy = ((dy % height) + height) % height;
+  const size_t stride = static_cast<size_t>(width) * channels;
+  const size_t head = static_cast<size_t>(width - dx) * channels;  // 搬到 dst 右段的長度
+  parallelRows(height, stride * height, [&](int begin, int end) {
+    for (int y = begin; y < end; y++) {
+      const uint8_t *in = src + y * stride;
+      uint8_t *out = dst + ((y + dy) % height) * stride;
+      std::memcpy(out + stride - head, in, head);
+      std::memcpy(out, in + head, stride - head);
+    }
+  });
+}
+
+void gaussianBlur(const uint8_t *src, int width, int height, int channels, uint8_t *dst, int radius, float sigma) {
+  gaussianBlurRegion(src, width, height, channels, dst, radius, sigma, 0, 0, width, height);
+}
+
+void gaussianBlurRegion(const uint8_t *src, int width, int height, int channels, uint8_t *dst, int radius,
+                        float sigma, int x, int y, int w, int h) {
+  x = std::clamp(x, 0, width);
+  y = std::clamp(y, 0, height);
+  w = std::min(w, width - x);
+  h = std::min(h, height - y);
+  if (w <= 0 || h <= 0) return;
+
+  const std::vector<float> kernel = gaussianKernel(std::max(radius, 0), sigma);
+  const int taps = static_cast<int>(kernel.size());
+  radius = taps / 2;
+  const size_t stride = static_cast<size_t>(width) * channels;
+  const size_t rowFloats = static_cast<size_t>(w) * channels;
+
+  // 每個 thread 負責一段輸出 row；水平結果放在 taps 列的 ring buffer，垂直方向再加權，
+  // 不需要整張 float 暫存圖
+  parallelRows(h, rowFloats * h, [&](int begin, int end) {
+    std::vector<float> padded(static_cast<size_t>(w + 2 * radius) * channels);
+    std::vector<float> ring(rowFloats * taps);
+    std::vector<float> acc(rowFloats);
+
+    // 來源第 sy 列在 [x - radius, x + w + radius) 的水平 blur
+    auto horizontal = [&](int sy, float *out) {
+      const uint8_t *row = src + reflect101(sy, height) * stride;
+      for (int px = 0; px < w + 2 * radius;) {
+        const int sx = x - radius + px;
+        if (sx >= 0 && sx < width) {
+          const int run = std::min(w + 2 * radius - px, width - sx);
+          bytesToFloat(row + sx * channels, padded.data() + px * channels, static_cast<size_t>(run) * channels);
+          px += run;
+        } else {
+          const uint8_t *p = row + reflect101(sx, width) * channels;
+          for (int c = 0; c < channels; c++) padded[px * channels + c] = p[c];
+          px++;
+        }
+      }
+      std::fill(out, out + rowFloats, 0.0f);
+      for (int k = 0; k < taps; k++) madRow(out, padded.data() + k * channels, kernel[k], rowFloats);
+    };
+    auto slot = [&](int i) { return ring.data() + (i % taps) * rowFloats; };  // i 為相對 begin - radius 的列
+
+    for (int i = 0; i < taps - 1; i++) horizontal(y + begin - radius + i, slot(i));
+    for (int row = begin; row < end; row++) {
+      const int first = row - begin;  // 這一列需要的 taps 列中最上面那列
+      horizontal(y + row + radius, slot(first + taps - 1));
+      std::fill(acc.begin(), acc.end(), 0.0f);
+      for (int k = 0; k < taps; k++) madRow(acc.data(), slot(first + k), kernel[k], rowFloats);
+      floatToBytes(acc.data(), dst + (y + row) * stride + static_cast<size_t>(x) * channels, rowFloats);
+    }
+  });
+}
+
+}  // namespace gfx::resource
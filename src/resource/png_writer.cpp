@@ -0,0 +1,96 @@
+#include "resource/png_writer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace gfx::resource {
+
+namespace {
+
+uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0) {
+  static const auto table = [] {
+    std::vector<uint32_t> t(256);
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+    return t;
+  }();
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+uint32_t adler32(const uint8_t *data, size_t size) {
+  uint32_t a = 1, b = 0;
+  while (size > 0) {
+    const size_t n = std::min<size_t>(size, 5552);  // 5552 之內 b 不會溢位，再取 mod
+    for (size_t i = 0; i < n; i++) {
+      a += data[i];
+      b += a;
+    }
+    a %= 65521;
+    b %= 65521;
+    data += n;
+    size -= n;
+  }
+  return (b << 16) | a;
+}
+
+void appendBigEndian(std::vector<uint8_t> &bytes, uint32_t v) {
+  const uint8_t b[4] = {uint8_t(v >> 24), uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v)};
+  bytes.insert(bytes.end(), b, b + 4);
+}
+
+void appendChunk(std::vector<uint8_t> &png, const char *type, const std::vector<uint8_t> &data) {
+  appendBigEndian(png, static_cast<uint32_t>(data.size()));
+  const size_t start = png.size();
+  png.insert(png.end(), type, type + 4);
+  png.insert(png.end(), data.begin(), data.end());
+  appendBigEndian(png, crc32(png.data() + start, png.size() - start));
+}
+
+}  // namespace
+
+bool writePng(const std::string &path, const uint8_t *pixels, int width, int height, int channels) {
+  static const uint8_t COLOR_TYPE[5] = {0, 0, 4, 2, 6};  // 依 channels：gray, gray + alpha, RGB, RGBA
+  if (channels < 1 || channels > 4 || width <= 0 || height <= 0) return false;
+  const size_t stride = static_cast<size_t>(width) * channels;
+
+  // 每列前面加 filter type 0（None）
+  std::vector<uint8_t> raw;
+  raw.reserve((stride + 1) * height);
+  for (int y = 0; y < height; y++) {
+    raw.push_back(0);
+    raw.insert(raw.end(), pixels + y * stride, pixels + (y + 1) * stride);
+  }
+
+  std::vector<uint8_t> zlib = {0x78, 0x01};
+  for (size_t offset = 0; offset < raw.size();) {
+    const size_t n = std::min<size_t>(raw.size() - offset, 65535);
+    const bool last = offset + n == raw.size();
+    const uint8_t header[5] = {uint8_t(last ? 1 : 0), uint8_t(n), uint8_t(n >> 8), uint8_t(~n), uint8_t(~n >> 8)};
+    zlib.insert(zlib.end(), header, header + 5);
+    zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + n);
+    offset += n;
+  }
+  appendBigEndian(zlib, adler32(raw.data(), raw.size()));
+
+  std::vector<uint8_t> ihdr;
+  appendBigEndian(ihdr, static_cast<uint32_t>(width));
+  appendBigEndian(ihdr, static_cast<uint32_t>(height));
+  const uint8_t format[5] = {8, COLOR_TYPE[channels], 0, 0, 0};  // bit depth, color type, 壓縮, filter, interlace
+  ihdr.insert(ihdr.end(), format, format + 5);
+
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  appendChunk(png, "IHDR", ihdr);
+  appendChunk(png, "IDAT", zlib);
+  appendChunk(png, "IEND", {});
+
+  std::ofstream file(path, std::ios::binary);
+  return file && file.write(reinterpret_cast<const char *>(png.data()), png.size());
+}
+
+}  // namespace gfx::resource
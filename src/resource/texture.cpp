@@ -2,19 +2,67 @@
 
 #include <OPPCH.h>
 
+#include "resource/image_ops.hpp"
 #include "stb_image.h"
 
 namespace gfx::resource {
 Texture::Texture() : ID(0), unit(0), type("") {}
 
+bool compressedFormatSupported(BcFormat format, bool srgb) {
+  switch (format) {
+    case BcFormat::BC1:
+    case BcFormat::BC3:
+      return GLEW_EXT_texture_compression_s3tc && (!srgb || GLEW_EXT_texture_sRGB);
+    case BcFormat::BC5:
+      return GLEW_VERSION_3_0 || GLEW_ARB_texture_compression_rgtc;
+    case BcFormat::BC7:
+      return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+  }
+  return false;
+}
+
+GLenum compressedInternalFormat(BcFormat format, bool srgb) {
+  switch (format) {
+    case BcFormat::BC1:
+      return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case BcFormat::BC3:
+      return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case BcFormat::BC5:
+      return GL_COMPRESSED_RG_RGTC2;
+    case BcFormat::BC7:
+      return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+  }
+  return 0;
+}
+
+void uploadCompressedTexture(GLenum target, const CompressedTexture &tex, const uint8_t *base) {
+  const GLenum internalFormat = compressedInternalFormat(tex.format, tex.srgb);
+  for (int face = 0; face < tex.faceCount; face++) {
+    const GLenum faceTarget = target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : target;
+    for (int mip = 0; mip < tex.levelCount; mip++) {
+      const auto &l = tex.level(face, mip);
+      glCompressedTexImage2D(faceTarget, mip, internalFormat, l.width, l.height, 0, static_cast<GLsizei>(l.size),
+                             base ? base + l.offset : reinterpret_cast<const void *>(l.offset));
+    }
+  }
+  // mip chain 可能不完整（例如只壓到 4x4），要告訴 driver 否則 texture 不 complete
+  glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0);
+  glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, tex.levelCount - 1);
+}
+
 Texture::Texture(const char *image, const char *texType, GLuint slot) : type(texType) {
+  unit = slot;
+  if (isCompressedTexturePath(image)) {
+    loadCompressed(image);
+    return;
+  }
+
   int width, height, nrChannels;
 
   unsigned char *data = stbi_load(image, &width, &height, &nrChannels, 0);
 
   glGenTextures(1, &ID);
   glActiveTexture(GL_TEXTURE0 + slot);
-  unit = slot;
   glBindTexture(GL_TEXTURE_2D, ID);
 
   if (data) {
@@ -29,22 +77,49 @@ Texture::Texture(const char *image, const char *texType, GLuint slot) : type(tex
   if (nrChannels == 4) {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
   } else if (nrChannels == 3) {
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+    // 補成 RGBA 再上傳，寬度 * 3 不是 4 的倍數時不會受 GL_UNPACK_ALIGNMENT 影響
+    std::vector<unsigned char> rgba(static_cast<size_t>(width) * height * 4);
+    expandRgbToRgba(data, rgba.data(), static_cast<size_t>(width) * height);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
   } else if (nrChannels == 1) {
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
   } else {
     throw std::invalid_argument("Automatic conversion of image channels is not supported.");
   }
 
   // Generate mipmaps
   glGenerateMipmap(GL_TEXTURE_2D);
+  if (data) memoryBytes = static_cast<size_t>(width) * height * nrChannels * 4 / 3;
 
   stbi_image_free(data);
 
   glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-Texture::Texture(Texture &&other) noexcept { *this = std::move(other); }
+void Texture::loadCompressed(const char *image) {
+  ID = 0;
+  CompressedTexture tex;
+  if (!readCompressedTexture(image, tex)) return;
+  if (!compressedFormatSupported(tex.format, tex.srgb)) {
+    std::cerr << "Compressed format " << bcFormatName(tex.format) << " not supported: " << image << std::endl;
+    return;
+  }
+
+  glGenTextures(1, &ID);
+  glActiveTexture(GL_TEXTURE0 + unit);
+  glBindTexture(GL_TEXTURE_2D, ID);
+  uploadCompressedTexture(GL_TEXTURE_2D, tex, tex.data.data());
+  memoryBytes = tex.payloadBytes();
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, tex.levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+Texture::Texture(Texture &&other) noexcept : ID(0), unit(0) { *this = std::move(other); }
 Texture &Texture::operator=(Texture &&other) noexcept {
   if (this != &other) {
     // 先釋放自己舊的 GL 資源（若你有擁有權）
@@ -52,6 +127,9 @@ Texture &Texture::operator=(Texture &&other) noexcept {
 
     ID = other.ID;
     unit = other.unit;
+    target = other.target;
+    ready = other.ready;
+    memoryBytes = other.memoryBytes;
     type = std::move(other.type);
 
     other.ID = 0;  // 防止重複刪
@@ -61,10 +139,10 @@ Texture &Texture::operator=(Texture &&other) noexcept {
 
 void Texture::bind() const {
   glActiveTexture(GL_TEXTURE0 + unit);
-  glBindTexture(GL_TEXTURE_2D, ID);
+  glBindTexture(target, ID);
 }
 
-void Texture::unbind() const { glBindTexture(GL_TEXTURE_2D, 0); }
+void Texture::unbind() const { glBindTexture(target, 0); }
 
 void Texture::reset() {
   if (ID) {
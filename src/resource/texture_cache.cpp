@@ -0,0 +1,104 @@
+#include "resource/texture_cache.hpp"
+
+#include <OPPCH.h>
+
+#include "resource/texture_streamer.hpp"
+
+namespace gfx::resource {
+
+TextureCache &TextureCache::instance() {
+  static TextureCache cache;
+  return cache;
+}
+
+std::shared_ptr<Texture> TextureCache::load(const std::string &path, const char *texType, GLuint slot) {
+  const std::string key = path + '|' + texType + '|' + std::to_string(slot);
+
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    if (auto texture = it->second.weak.lock()) {
+      hits_++;
+      touch(it->second, key);
+      it->second.strong = texture;
+      return texture;
+    }
+  }
+
+  misses_++;
+  auto texture = TextureStreamer::instance().load(path, texType, slot);
+  Entry &entry = entries_[key];
+  entry.weak = texture;
+  entry.strong = texture;
+  touch(entry, key);
+  trim();
+  return texture;
+}
+
+void TextureCache::touch(Entry &entry, const std::string &key) {
+  if (entry.strong) lru_.erase(entry.lruIt);
+  lru_.push_front(key);
+  entry.lruIt = lru_.begin();
+}
+
+void TextureCache::trim() {
+  size_t total = 0;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto texture = it->second.weak.lock();
+    if (!texture) {
+      it = entries_.erase(it);  // 只剩 weak 且已經被釋放
+      continue;
+    }
+    total += texture->byteSize();
+    ++it;
+  }
+
+  // 從最久沒用的開始，跳過外面還有人持有的
+  for (auto it = lru_.end(); it != lru_.begin() && total > budgetBytes_;) {
+    --it;
+    Entry &entry = entries_[*it];
+    if (entry.strong.use_count() > 1) continue;
+    total -= entry.strong->byteSize();
+    entry.strong.reset();
+    entries_.erase(*it);
+    it = lru_.erase(it);
+    evictions_++;
+  }
+}
+
+void TextureCache::setBudget(size_t bytes) {
+  budgetBytes_ = bytes;
+  trim();
+}
+
+void TextureCache::clear() {
+  for (auto it = lru_.begin(); it != lru_.end();) {
+    Entry &entry = entries_[*it];
+    if (entry.strong.use_count() > 1) {
+      ++it;
+      continue;
+    }
+    entry.strong.reset();
+    entries_.erase(*it);
+    it = lru_.erase(it);
+    evictions_++;
+  }
+}
+
+TextureCacheStats TextureCache::stats() const {
+  TextureCacheStats s;
+  s.hits = hits_;
+  s.misses = misses_;
+  s.evictions = evictions_;
+  s.budgetBytes = budgetBytes_;
+  for (const auto &[key, entry] : entries_) {
+    auto texture = entry.weak.lock();
+    if (!texture) continue;
+    s.entries++;
+    s.totalBytes += texture->byteSize();
+    // 這裡的 lock() 也算一個 reference
+    if (entry.strong && entry.strong.use_count() <= 2) s.cachedBytes += texture->byteSize();
+  }
+  return s;
+}
+
+}  // namespace gfx::resource
@@ -0,0 +1,441 @@
+#include "resource/texture_container.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "resource/image_ops.hpp"
+
+namespace gfx::resource {
+
+namespace {
+
+// 兩種格式都是 little-endian，這裡假設 host 也是（x86 / ARM）
+template <typename T>
+T readValue(const std::vector<uint8_t> &bytes, size_t offset) {
+  T v{};
+  if (offset + sizeof(T) <= bytes.size()) std::memcpy(&v, bytes.data() + offset, sizeof(T));
+  return v;
+}
+
+template <typename T>
+void appendValue(std::vector<uint8_t> &bytes, T v) {
+  const auto *p = reinterpret_cast<const uint8_t *>(&v);
+  bytes.insert(bytes.end(), p, p + sizeof(T));
+}
+
+bool readFile(const std::string &path, std::vector<uint8_t> &bytes) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) return false;
+  bytes.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  return static_cast<bool>(file.read(reinterpret_cast<char *>(bytes.data()), bytes.size()));
+}
+
+bool hasExtension(const std::string &path, const char *ext) {
+  const size_t n = std::strlen(ext);
+  if (path.size() < n) return false;
+  return std::equal(path.end() - n, path.end(), ext, [](char a, char b) { return std::tolower(a) == b; });
+}
+
+// 完整 mip chain 的層數 floor(log2(max(w, h))) + 1；檔頭的 levelCount 超過就是壞檔，不能拿來算 offset
+uint32_t maxLevelCount(int width, int height) {
+  uint32_t levels = 1;
+  for (int size = std::max(width, height); size > 1; size >>= 1) levels++;
+  return levels;
+}
+
+constexpr uint32_t fourCC(char a, char b, char c, char d) {
+  return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) |
+         (uint32_t(uint8_t(d)) << 24);
+}
+
+// ---- DDS ----
+constexpr uint32_t DDS_MAGIC = fourCC('D', 'D', 'S', ' ');
+constexpr uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000,
+                   DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+constexpr uint32_t DDPF_FOURCC = 0x4;
+constexpr uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+constexpr uint32_t DDSCAPS2_CUBEMAP_ALL = 0x200 | 0xFC00;
+constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+constexpr uint32_t DXGI_BC1 = 71, DXGI_BC1_SRGB = 72, DXGI_BC3 = 77, DXGI_BC3_SRGB = 78, DXGI_BC5 = 83, DXGI_BC7 = 98,
+                   DXGI_BC7_SRGB = 99;
+
+bool dxgiToBc(uint32_t dxgi, BcFormat &format, bool &srgb) {
+  srgb = dxgi == DXGI_BC1_SRGB || dxgi == DXGI_BC3_SRGB || dxgi == DXGI_BC7_SRGB;
+  switch (dxgi) {
+    case DXGI_BC1:
+    case DXGI_BC1_SRGB:
+      format = BcFormat::BC1;
+      return true;
+    case DXGI_BC3:
+    case DXGI_BC3_SRGB:
+      format = BcFormat::BC3;
+      return true;
+    case DXGI_BC5:
+      format = BcFormat::BC5;
+      return true;
+    case DXGI_BC7:
+    case DXGI_BC7_SRGB:
+      format = BcFormat::BC7;
+      return true;
+    default:
+      return false;
+  }
+}
+
+uint32_t bcToDxgi(BcFormat format, bool srgb) {
+  switch (format) {
+    case BcFormat::BC1:
+      return srgb ? DXGI_BC1_SRGB : DXGI_BC1;
+    case BcFormat::BC3:
+      return srgb ? DXGI_BC3_SRGB : DXGI_BC3;
+    case BcFormat::BC5:
+      return DXGI_BC5;
+    case BcFormat::BC7:
+      return srgb ? DXGI_BC7_SRGB : DXGI_BC7;
+  }
+  return 0;
+}
+
+bool readDds(std::vector<uint8_t> &bytes, CompressedTexture &out) {
+  if (bytes.size() < 128 || readValue<uint32_t>(bytes, 0) != DDS_MAGIC) return false;
+  out.height = static_cast<int>(readValue<uint32_t>(bytes, 12));
+  out.width = static_cast<int>(readValue<uint32_t>(bytes, 16));
+  const uint32_t levelCount = std::max(1u, readValue<uint32_t>(bytes, 28));
+  if (out.width <= 0 || out.height <= 0 || levelCount > maxLevelCount(out.width, out.height)) return false;
+  out.levelCount = static_cast<int>(levelCount);
+  const uint32_t pfFlags = readValue<uint32_t>(bytes, 80);
+  const uint32_t pfFourCC = readValue<uint32_t>(bytes, 84);
+  const uint32_t caps2 = readValue<uint32_t>(bytes, 112);
+  out.faceCount = (caps2 & DDSCAPS2_CUBEMAP_ALL) == DDSCAPS2_CUBEMAP_ALL ? 6 : 1;
+
+  size_t offset = 128;
+  if (!(pfFlags & DDPF_FOURCC)) return false;
+  if (pfFourCC == fourCC('D', 'X', '1', '0')) {
+    if (!dxgiToBc(readValue<uint32_t>(bytes, 128), out.format, out.srgb)) return false;
+    if (readValue<uint32_t>(bytes, 136) & DDS_RESOURCE_MISC_TEXTURECUBE) out.faceCount = 6;
+    offset += 20;
+  } else if (pfFourCC == fourCC('D', 'X', 'T', '1')) {
+    out.format = BcFormat::BC1;
+  } else if (pfFourCC == fourCC('D', 'X', 'T', '5')) {
+    out.format = BcFormat::BC3;
+  } else if (pfFourCC == fourCC('A', 'T', 'I', '2') || pfFourCC == fourCC('B', 'C', '5', 'U')) {
+    out.format = BcFormat::BC5;
+  } else {
+    return false;
+  }
+
+  // DDS 是 face major：每個 face 依序放完整的 mip chain
+  out.levels.clear();
+  for (int face = 0; face < out.faceCount; face++) {
+    for (int mip = 0; mip < out.levelCount; mip++) {
+      const int w = std::max(1, out.width >> mip), h = std::max(1, out.height >> mip);
+      const size_t size = bcImageBytes(out.format, w, h);
+      if (offset + size > bytes.size()) return false;
+      out.levels.push_back({offset, size, w, h});
+      offset += size;
+    }
+  }
+  out.data = std::move(bytes);  // level offset 直接指向檔案內容
+  return true;
+}
+
+bool writeDds(const std::string &path, const CompressedTexture &tex) {
+  std::vector<uint8_t> bytes;
+  // 舊的 FourCC 沒有 sRGB，sRGB 的 BC1 / BC3 也要走 DX10 header
+  const bool dx10 = tex.format == BcFormat::BC5 || tex.format == BcFormat::BC7 || tex.srgb;
+  const bool cube = tex.faceCount == 6;
+
+  appendValue<uint32_t>(bytes, DDS_MAGIC);
+  appendValue<uint32_t>(bytes, 124);
+  appendValue<uint32_t>(bytes,
+                        DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE);
+  appendValue<uint32_t>(bytes, tex.height);
+  appendValue<uint32_t>(bytes, tex.width);
+  appendValue<uint32_t>(bytes, static_cast<uint32_t>(bcImageBytes(tex.format, tex.width, tex.height)));
+  appendValue<uint32_t>(bytes, 0);  // depth
+  appendValue<uint32_t>(bytes, tex.levelCount);
+  for (int i = 0; i < 11; i++) appendValue<uint32_t>(bytes, 0);
+
+  // pixel format
+  appendValue<uint32_t>(bytes, 32);
+  appendValue<uint32_t>(bytes, DDPF_FOURCC);
+  appendValue<uint32_t>(bytes, dx10                            ? fourCC('D', 'X', '1', '0')
+                               : tex.format == BcFormat::BC1 ? fourCC('D', 'X', 'T', '1')
+                                                             : fourCC('D', 'X', 'T', '5'));
+  for (int i = 0; i < 5; i++) appendValue<uint32_t>(bytes, 0);
+
+  appendValue<uint32_t>(bytes, DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | (tex.levelCount > 1 ? DDSCAPS_MIPMAP : 0));
+  appendValue<uint32_t>(bytes, cube ? DDSCAPS2_CUBEMAP_ALL : 0);
+  for (int i = 0; i < 3; i++) appendValue<uint32_t>(bytes, 0);
+
+  if (dx10) {
+    appendValue<uint32_t>(bytes, bcToDxgi(tex.format, tex.srgb));
+    appendValue<uint32_t>(bytes, 3);  // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+    appendValue<uint32_t>(bytes, cube ? DDS_RESOURCE_MISC_TEXTURECUBE : 0);
+    appendValue<uint32_t>(bytes, 1);  // array size
+    appendValue<uint32_t>(bytes, 0);
+  }
+
+  for (int face = 0; face < tex.faceCount; face++) {
+    for (int mip = 0; mip < tex.levelCount; mip++) {
+      const auto &l = tex.level(face, mip);
+      bytes.insert(bytes.end(), tex.data.begin() + l.offset, tex.data.begin() + l.offset + l.size);
+    }
+  }
+
+  std::ofstream file(path, std::ios::binary);
+  return file && file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+// ---- KTX2 ----
+const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr uint32_t VK_BC1_RGB_UNORM = 131, VK_BC1_RGB_SRGB = 132, VK_BC1_RGBA_UNORM = 133, VK_BC1_RGBA_SRGB = 134,
+                   VK_BC3_UNORM = 137, VK_BC3_SRGB = 138, VK_BC5_UNORM = 141, VK_BC7_UNORM = 145, VK_BC7_SRGB = 146;
+
+bool vkToBc(uint32_t vk, BcFormat &format, bool &srgb) {
+  srgb = vk == VK_BC1_RGB_SRGB || vk == VK_BC1_RGBA_SRGB || vk == VK_BC3_SRGB || vk == VK_BC7_SRGB;
+  switch (vk) {
+    case VK_BC1_RGB_UNORM:
+    case VK_BC1_RGB_SRGB:
+    case VK_BC1_RGBA_UNORM:
+    case VK_BC1_RGBA_SRGB:
+      format = BcFormat::BC1;
+      return true;
+    case VK_BC3_UNORM:
+    case VK_BC3_SRGB:
+      format = BcFormat::BC3;
+      return true;
+    case VK_BC5_UNORM:
+      format = BcFormat::BC5;
+      return true;
+    case VK_BC7_UNORM:
+    case VK_BC7_SRGB:
+      format = BcFormat::BC7;
+      return true;
+    default:
+      return false;
+  }
+}
+
+uint32_t bcToVk(BcFormat format, bool srgb) {
+  switch (format) {
+    case BcFormat::BC1:
+      // 與 DFD 的 KHR_DF_MODEL_BC1A 一致；encoder 只用 4 色模式，alpha 永遠是 1，RGB / RGBA 解碼結果相同
+      return srgb ? VK_BC1_RGBA_SRGB : VK_BC1_RGBA_UNORM;
+    case BcFormat::BC3:
+      return srgb ? VK_BC3_SRGB : VK_BC3_UNORM;
+    case BcFormat::BC5:
+      return VK_BC5_UNORM;
+    case BcFormat::BC7:
+      return srgb ? VK_BC7_SRGB : VK_BC7_UNORM;
+  }
+  return 0;
+}
+
+bool readKtx2(std::vector<uint8_t> &bytes, CompressedTexture &out) {
+  if (bytes.size() < 80 || std::memcmp(bytes.data(), KTX2_IDENTIFIER, 12) != 0) return false;
+  if (!vkToBc(readValue<uint32_t>(bytes, 12), out.format, out.srgb)) return false;
+  out.width = static_cast<int>(readValue<uint32_t>(bytes, 20));
+  out.height = static_cast<int>(readValue<uint32_t>(bytes, 24));
+  const uint32_t layerCount = readValue<uint32_t>(bytes, 32);
+  out.faceCount = static_cast<int>(readValue<uint32_t>(bytes, 36));
+  const uint32_t levelCount = std::max(1u, readValue<uint32_t>(bytes, 40));
+  const uint32_t supercompression = readValue<uint32_t>(bytes, 44);
+  if (layerCount > 1 || supercompression != 0 || (out.faceCount != 1 && out.faceCount != 6)) return false;
+  if (out.width <= 0 || out.height <= 0 || levelCount > maxLevelCount(out.width, out.height)) return false;
+  out.levelCount = static_cast<int>(levelCount);
+
+  // KTX2 是 level major：每個 level 內依序放所有 face
+  std::vector<CompressedTexture::Level> levels(static_cast<size_t>(out.faceCount) * out.levelCount);
+  for (int mip = 0; mip < out.levelCount; mip++) {
+    const size_t entry = 80 + static_cast<size_t>(mip) * 24;
+    const size_t offset = static_cast<size_t>(readValue<uint64_t>(bytes, entry));
+    const size_t length = static_cast<size_t>(readValue<uint64_t>(bytes, entry + 8));
+    if (offset + length > bytes.size()) return false;
+    const int w = std::max(1, out.width >> mip), h = std::max(1, out.height >> mip);
+    const size_t faceSize = bcImageBytes(out.format, w, h);
+    if (faceSize * out.faceCount > length) return false;
+    for (int face = 0; face < out.faceCount; face++) {
+      levels[face * out.levelCount + mip] = {offset + face * faceSize, faceSize, w, h};
+    }
+  }
+  out.levels = std::move(levels);
+  out.data = std::move(bytes);
+  return true;
+}
+
+// Khronos Data Format descriptor：BC 格式只需要一個 basic block
+std::vector<uint8_t> buildKtx2Dfd(BcFormat format, bool srgb) {
+  struct Sample {
+    uint16_t bitOffset;
+    uint8_t bitLength;
+    uint8_t channel;
+  };
+  Sample samples[2] = {};
+  int sampleCount = 1;
+  uint8_t colorModel = 0;
+  switch (format) {
+    case BcFormat::BC1:
+      colorModel = 128;  // KHR_DF_MODEL_BC1A
+      samples[0] = {0, 64, 0};
+      break;
+    case BcFormat::BC3:
+      colorModel = 130;  // KHR_DF_MODEL_BC3
+      samples[0] = {0, 64, 15};
+      samples[1] = {64, 64, 0};
+      sampleCount = 2;
+      break;
+    case BcFormat::BC5:
+      colorModel = 132;  // KHR_DF_MODEL_BC5
+      samples[0] = {0, 64, 0};
+      samples[1] = {64, 64, 1};
+      sampleCount = 2;
+      break;
+    case BcFormat::BC7:
+      colorModel = 134;  // KHR_DF_MODEL_BC7
+      samples[0] = {0, 128, 0};
+      break;
+  }
+
+  const uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(sampleCount);
+  std::vector<uint8_t> dfd;
+  appendValue<uint32_t>(dfd, 4 + blockSize);
+  appendValue<uint32_t>(dfd, 0);                      // vendor / descriptor type
+  appendValue<uint32_t>(dfd, 2 | (blockSize << 16));  // version 2
+  appendValue<uint8_t>(dfd, colorModel);
+  appendValue<uint8_t>(dfd, 1);  // BT709 primaries
+  appendValue<uint8_t>(dfd, srgb ? 2 : 1);  // sRGB / linear transfer
+  appendValue<uint8_t>(dfd, 0);  // straight alpha
+  appendValue<uint32_t>(dfd, 3 | (3 << 8));  // 4x4 texel block
+  appendValue<uint32_t>(dfd, static_cast<uint32_t>(bcBlockBytes(format)));
+  appendValue<uint32_t>(dfd, 0);
+  for (int i = 0; i < sampleCount; i++) {
+    const Sample &s = samples[i];
+    appendValue<uint16_t>(dfd, s.bitOffset);
+    appendValue<uint8_t>(dfd, static_cast<uint8_t>(s.bitLength - 1));
+    appendValue<uint8_t>(dfd, s.channel);
+    appendValue<uint32_t>(dfd, 0);  // sample position
+    appendValue<uint32_t>(dfd, 0);
+    appendValue<uint32_t>(dfd, 0xFFFFFFFFu);
+  }
+  return dfd;
+}
+
+bool writeKtx2(const std::string &path, const CompressedTexture &tex) {
+  const std::vector<uint8_t> dfd = buildKtx2Dfd(tex.format, tex.srgb);
+  const size_t levelIndexBytes = static_cast<size_t>(tex.levelCount) * 24;
+  const size_t dfdOffset = 80 + levelIndexBytes;
+  const size_t alignment = bcBlockBytes(tex.format);
+
+  std::vector<uint8_t> bytes(KTX2_IDENTIFIER, KTX2_IDENTIFIER + 12);
+  appendValue<uint32_t>(bytes, bcToVk(tex.format, tex.srgb));
+  appendValue<uint32_t>(bytes, 1);  // typeSize
+  appendValue<uint32_t>(bytes, tex.width);
+  appendValue<uint32_t>(bytes, tex.height);
+  appendValue<uint32_t>(bytes, 0);  // depth
+  appendValue<uint32_t>(bytes, 0);  // layerCount
+  appendValue<uint32_t>(bytes, tex.faceCount);
+  appendValue<uint32_t>(bytes, tex.levelCount);
+  appendValue<uint32_t>(bytes, 0);  // supercompression
+  appendValue<uint32_t>(bytes, static_cast<uint32_t>(dfdOffset));
+  appendValue<uint32_t>(bytes, static_cast<uint32_t>(dfd.size()));
+  appendValue<uint32_t>(bytes, 0);  // kvd
+  appendValue<uint32_t>(bytes, 0);
+  appendValue<uint64_t>(bytes, 0);  // sgd
+  appendValue<uint64_t>(bytes, 0);
+  bytes.resize(dfdOffset);  // level index 之後回填
+  bytes.insert(bytes.end(), dfd.begin(), dfd.end());
+
+  // 規範建議由最小的 mip 開始放，串流時可以先拿到低解析度
+  for (int mip = tex.levelCount - 1; mip >= 0; mip--) {
+    bytes.resize((bytes.size() + alignment - 1) / alignment * alignment);
+    const uint64_t offset = bytes.size();
+    for (int face = 0; face < tex.faceCount; face++) {
+      const auto &l = tex.level(face, mip);
+      bytes.insert(bytes.end(), tex.data.begin() + l.offset, tex.data.begin() + l.offset + l.size);
+    }
+    const uint64_t length = bytes.size() - offset;
+    const size_t entry = 80 + static_cast<size_t>(mip) * 24;
+    std::memcpy(bytes.data() + entry, &offset, 8);
+    std::memcpy(bytes.data() + entry + 8, &length, 8);
+    std::memcpy(bytes.data() + entry + 16, &length, 8);  // uncompressedByteLength
+  }
+
+  std::ofstream file(path, std::ios::binary);
+  return file && file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+}  // namespace
+
+size_t CompressedTexture::addLevel(const std::vector<uint8_t> &blocks, int w, int h) {
+  levels.push_back({data.size(), blocks.size(), w, h});
+  data.insert(data.end(), blocks.begin(), blocks.end());
+  return levels.size() - 1;
+}
+
+size_t CompressedTexture::payloadBytes() const {
+  size_t bytes = 0;
+  for (const auto &l : levels) bytes += l.size;
+  return bytes;
+}
+
+bool isCompressedTexturePath(const std::string &path) {
+  return hasExtension(path, ".ktx2") || hasExtension(path, ".dds");
+}
+
+bool readCompressedTexture(const std::string &path, CompressedTexture &out) {
+  std::vector<uint8_t> bytes;
+  if (!readFile(path, bytes)) {
+    std::cerr << "Failed to open compressed texture: " << path << std::endl;
+    return false;
+  }
+  const bool ok = hasExtension(path, ".ktx2") ? readKtx2(bytes, out) : readDds(bytes, out);
+  if (!ok) std::cerr << "Unsupported compressed texture: " << path << std::endl;
+  return ok;
+}
+
+bool writeCompressedTexture(const std::string &path, const CompressedTexture &tex) {
+  if (tex.levels.size() != static_cast<size_t>(tex.faceCount) * tex.levelCount) return false;
+  return hasExtension(path, ".ktx2") ? writeKtx2(path, tex) : writeDds(path, tex);
+}
+
+CompressedTexture compressTexture(const std::vector<const uint8_t *> &faces, int width, int height, BcFormat format,
+                                  bool mips, bool srgb, unsigned numThreads) {
+  CompressedTexture out;
+  out.format = format;
+  out.srgb = srgb && format != BcFormat::BC5;  // BC5 沒有 sRGB 版本
+  out.width = width;
+  out.height = height;
+  out.faceCount = static_cast<int>(faces.size());
+  out.levelCount = 1;
+  if (mips) {
+    for (int w = width, h = height; w > 1 || h > 1; out.levelCount++) {
+      w = std::max(1, w / 2);
+      h = std::max(1, h / 2);
+    }
+  }
+
+  std::vector<uint8_t> level, next;
+  for (const uint8_t *face : faces) {
+    int w = width, h = height;
+    const uint8_t *pixels = face;
+    for (int mip = 0; mip < out.levelCount; mip++) {
+      if (mip > 0) {
+        next.resize(static_cast<size_t>(std::max(1, w / 2)) * std::max(1, h / 2) * 4);
+        downsampleBox(pixels, w, h, 4, next.data(), srgb);
+        level.swap(next);
+        pixels = level.data();
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+      }
+      out.addLevel(compressImage(pixels, w, h, format, numThreads), w, h);
+    }
+  }
+  return out;
+}
+
+}  // namespace gfx::resource
@@ -0,0 +1,337 @@
+#include "resource/texture_streamer.hpp"
+
+#include <OPPCH.h>
+
+#include <cstring>
+
+#include "resource/image_ops.hpp"
+#include "stb_image.h"
+
+namespace gfx::resource {
+
+namespace {
+
+GLenum formatFor(int channels) {
+  switch (channels) {
+    case 4:
+      return GL_RGBA;
+    case 3:
+      return GL_RGB;
+    case 1:
+      return GL_RED;
+    default:
+      return 0;
+  }
+}
+
+bool decode(const std::string &path, DecodedImage &out) {
+  int width, height, channels;
+  unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+  if (!data) return false;
+  if (!formatFor(channels)) {
+    stbi_image_free(data);
+    return false;
+  }
+  out.width = width;
+  out.height = height;
+  const size_t pixelCount = static_cast<size_t>(width) * height;
+  if (channels == 3) {
+    // 在 worker 上補成 RGBA，GL thread 上傳時不用處理對齊，翻轉也走 4 通道的 SIMD 路徑
+    out.channels = 4;
+    out.pixels.resize(pixelCount * 4);
+    expandRgbToRgba(data, out.pixels.data(), pixelCount);
+  } else {
+    out.channels = channels;
+    out.pixels.assign(data, data + pixelCount * channels);
+  }
+  stbi_image_free(data);
+  return true;
+}
+
+}  // namespace
+
+size_t TextureStreamer::Decoded::byteSize() const {
+  if (isCompressed) return compressed.data.size();
+  size_t size = 0;
+  for (const auto &f : faces) size += f.pixels.size();
+  return size;
+}
+
+TextureStreamer::TextureStreamer(unsigned numThreads) {
+  if (numThreads == 0) {
+    const unsigned hw = std::thread::hardware_concurrency();
+    numThreads = hw > 1 ? hw - 1 : 1;
+  }
+  for (unsigned i = 0; i < numThreads; i++) workers_.emplace_back(&TextureStreamer::workerLoop, this);
+}
+
+TextureStreamer::~TextureStreamer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    jobs_.clear();
+  }
+  cv_.notify_all();
+  for (auto &t : workers_) t.join();
+}
+
+TextureStreamer &TextureStreamer::instance() {
+  static TextureStreamer streamer;
+  return streamer;
+}
+
+std::shared_ptr<Texture> TextureStreamer::load(const std::string &path, const char *texType, GLuint slot) {
+  auto texture = std::make_shared<Texture>();
+  texture->type = texType;
+  texture->unit = slot;
+  texture->target = GL_TEXTURE_2D;
+  texture->ID = createPlaceholder(GL_TEXTURE_2D, texType);
+  texture->ready = false;
+
+  submit(Job{texture, GL_TEXTURE_2D, {path}, nullptr, Clock::now()});
+  return texture;
+}
+
+std::shared_ptr<Texture> TextureStreamer::loadCubeMap(const std::vector<std::string> &faces, GLuint slot,
+                                                      FaceTransform transform) {
+  auto texture = std::make_shared<Texture>();
+  texture->type = "cubemap";
+  texture->unit = slot;
+  texture->target = GL_TEXTURE_CUBE_MAP;
+  texture->ID = createPlaceholder(GL_TEXTURE_CUBE_MAP, "cubemap");
+  texture->ready = false;
+
+  submit(Job{texture, GL_TEXTURE_CUBE_MAP, faces, std::move(transform), Clock::now()});
+  return texture;
+}
+
+void TextureStreamer::submit(Job job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+  }
+  cv_.notify_one();
+}
+
+void TextureStreamer::workerLoop() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+      if (stopping_) return;
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+      decoding_++;
+    }
+
+    Decoded result;
+    result.owner = job.owner;
+    result.target = job.target;
+    result.start = job.start;
+    result.ok = true;
+    // 排隊期間場景已經切走就不用解碼了
+    if (!job.owner.expired() && job.paths.size() == 1 && isCompressedTexturePath(job.paths[0])) {
+      result.isCompressed = true;
+      result.ok = readCompressedTexture(job.paths[0], result.compressed) &&
+                  result.compressed.faceCount == (job.target == GL_TEXTURE_CUBE_MAP ? 6 : 1);
+    } else if (!job.owner.expired()) {
+      result.faces.resize(job.paths.size());
+      for (size_t i = 0; i < job.paths.size() && result.ok; i++) {
+        if (!decode(job.paths[i], result.faces[i])) {
+          std::cerr << "Failed to load texture: " << job.paths[i] << std::endl;
+          result.ok = false;
+        } else if (job.transform) {
+          job.transform(result.faces[i], static_cast<int>(i));
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    decoding_--;
+    decoded_.push_back(std::move(result));
+  }
+}
+
+void TextureStreamer::update() {
+  // 先收掉已經完成的上傳，fence 沒到就下一幀再看
+  for (size_t i = 0; i < inFlight_.size();) {
+    if (finishUpload(inFlight_[i], false)) {
+      inFlight_[i] = inFlight_.back();
+      inFlight_.pop_back();
+    } else {
+      i++;
+    }
+  }
+
+  std::vector<Decoded> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (decoded_.empty()) return;
+    // 依 budget 從前面取，剩下的留給下一幀
+    size_t bytes = 0, take = 0;
+    while (take < decoded_.size() && (take == 0 || bytes + decoded_[take].byteSize() <= uploadBudgetBytes)) {
+      bytes += decoded_[take].byteSize();
+      take++;
+    }
+    ready.assign(std::make_move_iterator(decoded_.begin()), std::make_move_iterator(decoded_.begin() + take));
+    decoded_.erase(decoded_.begin(), decoded_.begin() + take);
+  }
+
+  for (auto &d : ready) {
+    if (d.owner.expired()) continue;
+    if (!d.ok || (d.isCompressed && !compressedFormatSupported(d.compressed.format, d.compressed.srgb))) {
+      failed_++;
+      continue;
+    }
+    beginUpload(d);
+  }
+}
+
+void TextureStreamer::beginUpload(Decoded &decoded) {
+  const size_t totalBytes = decoded.byteSize();
+
+  GLuint pbo;
+  glGenBuffers(1, &pbo);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+  glBufferData(GL_PIXEL_UNPACK_BUFFER, totalBytes, nullptr, GL_STREAM_DRAW);
+  auto *dst = static_cast<unsigned char *>(
+      glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, totalBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+  if (!dst) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &pbo);
+    failed_++;
+    return;
+  }
+  if (decoded.isCompressed) {
+    std::memcpy(dst, decoded.compressed.data.data(), totalBytes);
+  } else {
+    for (const auto &f : decoded.faces) {
+      std::memcpy(dst, f.pixels.data(), f.pixels.size());
+      dst += f.pixels.size();
+    }
+  }
+  glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+  GLuint textureID;
+  glGenTextures(1, &textureID);
+  glBindTexture(decoded.target, textureID);
+
+  const bool cube = decoded.target == GL_TEXTURE_CUBE_MAP;
+  bool mipmapped = true;
+  size_t memoryBytes = totalBytes;
+  if (decoded.isCompressed) {
+    // 壓縮檔已經帶完整 mip chain，不用 glGenerateMipmap
+    uploadCompressedTexture(decoded.target, decoded.compressed, nullptr);
+    mipmapped = decoded.compressed.levelCount > 1;
+    memoryBytes = decoded.compressed.payloadBytes();
+  } else {
+    // 單通道的 row 不一定 4-byte 對齊（RGB 已經在 worker 補成 RGBA）
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // 資料來源是 PBO，最後一個參數是 buffer 內的 offset，driver 可以非同步 DMA
+    size_t offset = 0;
+    for (size_t i = 0; i < decoded.faces.size(); i++) {
+      const DecodedImage &f = decoded.faces[i];
+      const GLenum format = formatFor(f.channels);
+      const GLenum face = cube ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + i : GL_TEXTURE_2D;
+      glTexImage2D(face, 0, format, f.width, f.height, 0, format, GL_UNSIGNED_BYTE,
+                   reinterpret_cast<const void *>(offset));
+      offset += f.pixels.size();
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // skybox 不需要 mipmap
+    mipmapped = !cube;
+    if (mipmapped) {
+      glGenerateMipmap(decoded.target);
+      memoryBytes = totalBytes * 4 / 3;
+    }
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  glTexParameteri(decoded.target, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glTexParameteri(decoded.target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(decoded.target, GL_TEXTURE_WRAP_S, cube ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+  glTexParameteri(decoded.target, GL_TEXTURE_WRAP_T, cube ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+  if (cube) glTexParameteri(decoded.target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+  glBindTexture(decoded.target, 0);
+
+  GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  inFlight_.push_back(InFlight{decoded.owner, textureID, pbo, fence, decoded.start, memoryBytes});
+}
+
+bool TextureStreamer::finishUpload(InFlight &upload, bool wait) {
+  const GLuint64 timeout = wait ? GLuint64(1000000000) : 0;
+  const GLenum status = glClientWaitSync(upload.fence, 0, timeout);
+  if (!wait && status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+
+  glDeleteSync(upload.fence);
+  glDeleteBuffers(1, &upload.pbo);
+
+  if (auto texture = upload.owner.lock()) {
+    glDeleteTextures(1, &texture->ID);  // placeholder
+    texture->ID = upload.textureID;
+    texture->ready = true;
+    texture->memoryBytes = upload.memoryBytes;
+    completed_++;
+    recordLatency(upload.start);
+  } else {
+    glDeleteTextures(1, &upload.textureID);
+  }
+  return true;
+}
+
+void TextureStreamer::recordLatency(Clock::time_point start) {
+  lastLatencyMs_ = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+  totalLatencyMs_ += lastLatencyMs_;
+  maxLatencyMs_ = std::max(maxLatencyMs_, lastLatencyMs_);
+}
+
+void TextureStreamer::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.clear();
+    decoded_.clear();
+  }
+  for (auto &upload : inFlight_) finishUpload(upload, true);
+  inFlight_.clear();
+}
+
+TextureStreamStats TextureStreamer::stats() const {
+  TextureStreamStats s;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    s.queued = static_cast<int>(jobs_.size() + decoded_.size()) + decoding_;
+  }
+  s.uploading = static_cast<int>(inFlight_.size());
+  s.completed = completed_;
+  s.failed = failed_;
+  s.lastLatencyMs = lastLatencyMs_;
+  s.avgLatencyMs = completed_ ? static_cast<float>(totalLatencyMs_ / completed_) : 0.0f;
+  s.maxLatencyMs = maxLatencyMs_;
+  return s;
+}
+
+GLuint TextureStreamer::createPlaceholder(GLenum target, const char *texType) {
+  // normal map 用平的法線，其他用中灰，避免載入前畫面閃黑
+  const bool isNormal = std::strcmp(texType, "normal") == 0;
+  const unsigned char pixel[4] = {128, 128, static_cast<unsigned char>(isNormal ? 255 : 128), 255};
+
+  GLuint id;
+  glGenTextures(1, &id);
+  glBindTexture(target, id);
+  if (target == GL_TEXTURE_CUBE_MAP) {
+    for (int i = 0; i < 6; i++) {
+      glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    }
+  } else {
+    glTexImage2D(target, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+  }
+  glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindTexture(target, 0);
+  return id;
+}
+
+}  // namespace gfx::resource
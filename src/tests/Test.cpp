@@ -17,4 +17,11 @@ void Test::OnRender() {}
 void Test::OnImGuiRender() {}
 void Test::OnExit() {}
 
+bool Test::waitForShaders(std::initializer_list<Shader*> shaders) {
+  if (Shader::allReady(shaders)) return true;
+  glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  return false;
+}
+
 }  // namespace test
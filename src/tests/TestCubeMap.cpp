@@ -11,7 +11,7 @@ TestCubeMap::TestCubeMap(const float screenWidth, const float screenHeight)
 
   skyShader = std::make_unique<Shader>("./shaders/skybox_vert.glsl", "./shaders/skybox_frag.glsl");
   modelShader = std::make_unique<Shader>("./shaders/model_vert.glsl", "./shaders/model_frag.glsl");
-  skybox = std::make_unique<gfx::geom::CubeMap>(faces, false);
+  skybox = std::make_unique<gfx::geom::CubeMap>(faces, gfx::resource::TextureStreamer::instance(), false);
   model = std::make_unique<Model>("./assets/gltf_duck/Duck.gltf");
 
   glm::vec3 position = glm::vec3(0.0f, 1.0f, 3.0f);
@@ -10,6 +10,13 @@ TestModel::TestModel(const float screenWidth, const float screenHeight, const ch
   shaderProgram = std::make_unique<Shader>("./shaders/model_vert.glsl", "./shaders/model_frag.glsl");
   model = std::make_unique<Model>(path);
 
+  // 把每個 mesh 切成 meshlet，index buffer 換成 meshlet 順序（三角形集合不變，一般繪製不受影響）
+  for (auto &mesh : model->meshes) {
+    meshlets.push_back(gfx::geom::buildMeshlets(mesh.vertices, mesh.indices));
+    mesh.setIndices(meshlets.back().indices);
+  }
+  drawLists.resize(meshlets.size());
+
   glm::vec3 position = glm::vec3(0.0f, 1.0f, 5.0f);
   glm::vec3 orientation = glm::vec3(0.0f, 0.0f, -1.0f);
   camera = std::make_unique<Camera>(screenWidth, screenHeight, position, orientation);
@@ -40,7 +47,19 @@ void TestModel::OnRender() {
   modelMatrix = glm::rotate(modelMatrix, glm::radians(rot.y), glm::vec3(0.0f, 1.0f, 0.0f));
   modelMatrix = glm::rotate(modelMatrix, glm::radians(rot.z), glm::vec3(0.0f, 0.0f, 1.0f));
   model->setModelMatrix(modelMatrix);
-  renderer.draw(*model, *shaderProgram);
+
+  if (!useClusterCulling) {
+    renderer.draw(*model, *shaderProgram);
+    return;
+  }
+
+  glUniformMatrix4fv(glGetUniformLocation(shaderProgram->PROGRAM_ID, "modelMatrix"), 1, GL_FALSE,
+                     glm::value_ptr(modelMatrix));
+  const glm::mat4 viewProj = camera->projMatrix * camera->viewMatrix;
+  for (size_t i = 0; i < model->meshes.size(); i++) {
+    culler.cull(meshlets[i], modelMatrix, viewProj, camera->position, drawLists[i]);
+    mesh_renderer.drawClusters(model->meshes[i], *shaderProgram, drawLists[i]);
+  }
 }
 
 void TestModel::OnImGuiRender() {
@@ -49,6 +68,28 @@ void TestModel::OnImGuiRender() {
   ImGui::SliderFloat3("Trans", &trans[0], -10.0f, 10.0f);
   ImGui::SliderFloat3("Scale", &scale[0], 0.1f, 3.0f);
   ImGui::SliderFloat3("Rot", &rot[0], -180.0f, 180.0f);
+
+  ImGui::Text("Meshlets");
+  ImGui::Checkbox("Cluster Culling", &useClusterCulling);
+  ImGui::Checkbox("Frustum", &culler.frustumCulling);
+  ImGui::SameLine();
+  ImGui::Checkbox("Backface Cone", &culler.backfaceCulling);
+  size_t total = 0, visible = 0, visibleTris = 0, totalTris = 0;
+  for (size_t i = 0; i < meshlets.size(); i++) {
+    total += meshlets[i].meshlets.size();
+    totalTris += meshlets[i].indices.size() / 3;
+    visible += drawLists[i].visibleMeshlets;
+    visibleTris += drawLists[i].visibleTriangles;
+  }
+  ImGui::Text("visible: %zu / %zu meshlets", visible, total);
+  ImGui::Text("tris: %zu / %zu", useClusterCulling ? visibleTris : totalTris, totalTris);
+
+  ImGui::Text("Mesh optimizer (before -> after)");
+  for (size_t i = 0; i < model->optimizeStats.size(); i++) {
+    const gfx::geom::MeshOptimizeStats &s = model->optimizeStats[i];
+    ImGui::Text("mesh %zu: vertices %zu -> %zu", i, s.verticesBefore, s.verticesAfter);
+    ImGui::Text("  ACMR %.3f -> %.3f, ATVR %.3f -> %.3f", s.before.acmr, s.after.acmr, s.before.atvr, s.after.atvr);
+  }
 }
 
 void TestModel::OnExit() {
@@ -4,7 +4,8 @@
 
 namespace test {
 
-TestMultipleObj::TestMultipleObj(const float screenWidth, const float screenHeight) : renderer(mesh_renderer) {
+TestMultipleObj::TestMultipleObj(const float screenWidth, const float screenHeight)
+    : screenHeight(screenHeight), renderer(mesh_renderer) {
   glViewport(0, 0, screenWidth, screenHeight);
 
   shaderProgram = std::make_unique<Shader>("./shaders/multiple_obj_vert.glsl", "./shaders/multiple_obj_frag.glsl");
@@ -13,8 +14,17 @@ TestMultipleObj::TestMultipleObj(const float screenWidth, const float screenHeig
 
   updateInstanceMatrices();
 
-  for (unsigned int i = 0; i < model->meshes.size(); i++) {
-    model->meshes[i].setupInstanceMatrices(instanceMatrices);
+  for (auto &mesh : model->meshes) {
+    mesh.setLods(gfx::geom::buildLodChain(mesh.vertices, mesh.indices));
+    mesh.setupInstanceMatrices(instanceMatrices);
+  }
+
+  if (gfx::render::GpuInstanceCuller::supported()) {
+    gpuCuller = std::make_unique<gfx::render::GpuInstanceCuller>();
+    gpuCuller->setInstances(instanceMatrices);
+    std::vector<GLuint> indexCounts;
+    for (const auto &mesh : model->meshes) indexCounts.push_back(static_cast<GLuint>(mesh.indices.size()));
+    gpuCuller->setDrawCommands(indexCounts);
   }
 
   glm::vec3 position = glm::vec3(-2.0f, 7.0f, -4.0f);
@@ -39,18 +49,117 @@ void TestMultipleObj::OnRender() {
 
   shaderProgram->use();
   camera->update(shaderProgram.get());
-  renderer.draw(*model, *shaderProgram);
+
+  if (cullMode == CULL_GPU && gpuCuller) {
+    drawGpuCulled();
+  } else {
+    drawLods();
+  }
+}
+
+void TestMultipleObj::drawGpuCulled() {
+  const glm::mat4 viewProj = camera->projMatrix * camera->viewMatrix;
+  gpuCuller->cull(viewProj, model->bounds.center, model->bounds.radius);
+  for (size_t i = 0; i < model->meshes.size(); i++) {
+    mesh_renderer.drawIndirect(model->meshes[i], *shaderProgram, gpuCuller->drawCommands(), i,
+                               &gpuCuller->visibleInstances());
+  }
+
+  // 讀回會等 GPU 做完，只是為了顯示在 UI 上
+  visibleCount = gpuCuller->readVisibleCount();
+  trianglesDrawn = 0;
+  for (auto &mesh : model->meshes) trianglesDrawn += mesh.numTriangles() * visibleCount;
+  lodCounts.clear();
+}
+
+void TestMultipleObj::drawLods() {
+  const int instanceCount = row * col;
+
+  // 先 frustum culling，LOD 只對可見的 instance 挑
+  auto start = std::chrono::high_resolution_clock::now();
+  if (cullMode == CULL_CPU) {
+    const glm::mat4 viewProj = camera->projMatrix * camera->viewMatrix;
+    culler.cull(instanceMatrices, model->bounds.center, model->bounds.radius, viewProj, visibleInstances);
+  } else {
+    visibleInstances.resize(instanceCount);
+    for (int i = 0; i < instanceCount; i++) visibleInstances[i] = i;
+  }
+  cullTimeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+  visibleCount = visibleInstances.size();
+
+  // 螢幕上的半徑（pixel）= r * cot(fov / 2) / d * (h / 2)
+  const float pxScale = camera->projMatrix[1][1] * screenHeight * 0.5f;
+  std::vector<uint32_t> instanceLod(visibleCount);
+
+  trianglesDrawn = 0;
+  for (auto &mesh : model->meshes) {
+    const uint32_t numLods = useLod ? std::max<uint32_t>(1, mesh.lods.size()) : 1;
+    lodCounts.assign(numLods, 0);
+
+    for (size_t v = 0; v < visibleCount; v++) {
+      uint32_t lod = 0;
+      if (useLod) {
+        const glm::mat4 &m = instanceMatrices[visibleInstances[v]];
+        const glm::vec3 center = glm::vec3(m * glm::vec4(mesh.bounds.center, 1.0f));
+        const float scale = std::max({glm::length(glm::vec3(m[0])), glm::length(glm::vec3(m[1])),
+                                      glm::length(glm::vec3(m[2]))});
+        const float dist = std::max(glm::length(center - camera->position), 1e-3f);
+        const float radiusPx = mesh.bounds.radius * scale / dist * pxScale;
+        lod = gfx::geom::selectLod(mesh.lods, radiusPx, lodErrorPx);
+      }
+      instanceLod[v] = lod;
+      lodCounts[lod]++;
+    }
+
+    // counting sort：同一個 LOD 的 instance 放在一起，每個 LOD 一次 instanced draw
+    std::vector<uint32_t> offsets(numLods, 0);
+    for (uint32_t l = 1; l < numLods; l++) offsets[l] = offsets[l - 1] + lodCounts[l - 1];
+    sortedMatrices.resize(visibleCount);
+    std::vector<uint32_t> cursor(offsets);
+    for (size_t v = 0; v < visibleCount; v++) {
+      sortedMatrices[cursor[instanceLod[v]]++] = instanceMatrices[visibleInstances[v]];
+    }
+    if (visibleCount > 0) mesh.updateInstanceMatrices(sortedMatrices);
+
+    for (uint32_t l = 0; l < numLods; l++) {
+      mesh_renderer.drawLod(mesh, *shaderProgram, l, lodCounts[l], offsets[l]);
+      const size_t lodTriangles = mesh.lods.empty() ? mesh.numTriangles() : mesh.lods[l].indexCount / 3;
+      trianglesDrawn += lodTriangles * lodCounts[l];
+    }
+  }
 }
 
 void TestMultipleObj::OnImGuiRender() {
   // set modelMatrix
   ImGui::Text("instances: %d", row * col);
+  const char *cullModes[] = {"Off", "CPU (SIMD)", "GPU compute"};
+  ImGui::Combo("Frustum culling", &cullMode, cullModes, gpuCuller ? 3 : 2);
+  if (cullMode == CULL_CPU) {
+    ImGui::Checkbox("SIMD", &culler.useSimd);
+    ImGui::Text("cull time: %.3f ms", cullTimeMs);
+  }
+  ImGui::Text("visible: %zu", visibleCount);
+  if (cullMode != CULL_GPU) ImGui::Checkbox("LOD", &useLod);
+  if (useLod && cullMode != CULL_GPU) {
+    ImGui::SliderFloat("LOD error (px)", &lodErrorPx, 0.25f, 16.0f);
+    for (size_t l = 0; l < lodCounts.size(); l++) {
+      const auto &lods = model->meshes.back().lods;  // lodCounts 對應最後一個 mesh
+      if (l < lods.size()) {
+        ImGui::Text("LOD %zu: %u tris, error %.4f, %u instances", l, lods[l].indexCount / 3, lods[l].error,
+                    lodCounts[l]);
+      } else {
+        ImGui::Text("LOD %zu: %u instances", l, lodCounts[l]);
+      }
+    }
+  }
+  ImGui::Text("triangles: %zu", trianglesDrawn);
   if (ImGui::SliderInt("Row", &row, 1, 100)) {
     updateInstanceMatrices();
     for (unsigned int i = 0; i < model->meshes.size(); i++) {
       model->meshes[i].updateInstanceMatrices(instanceMatrices);
       // model->meshes[i].setupInstanceMatrices(instanceMatrices);
     }
+    if (gpuCuller) gpuCuller->setInstances(instanceMatrices);
   }
   if (ImGui::SliderInt("Col", &col, 1, 100)) {
     updateInstanceMatrices();
@@ -58,6 +167,7 @@ void TestMultipleObj::OnImGuiRender() {
       model->meshes[i].updateInstanceMatrices(instanceMatrices);
       // model->meshes[i].setupInstanceMatrices(instanceMatrices);
     }
+    if (gpuCuller) gpuCuller->setInstances(instanceMatrices);
   }
 }
 
@@ -3,6 +3,7 @@
 #include <OPPCH.h>
 
 #include "BasicMesh.hpp"
+#include "resource/texture_cache.hpp"
 
 namespace test {
 
@@ -13,7 +14,7 @@ TestParallaxMapping::TestParallaxMapping(const float screenWidth, const float sc
   const float wallHeight = 3.0f;
   wall = createPlaneMesh(wallHeight, glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.8f), glm::vec3(0.0, wallHeight, 0.0f));
   std::vector<std::shared_ptr<gfx::resource::Texture>> textures;
-  textures.emplace_back(std::make_shared<gfx::resource::Texture>("./assets/textures/room_3.png", "albedo", 0));
+  textures.emplace_back(gfx::resource::TextureCache::instance().load("./assets/textures/room_3.png", "albedo", 0));
   wall->setTexture(textures);
   floor = createPlaneMesh(10.0f, glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.2f));
 
@@ -4,6 +4,7 @@
 #include <PxPhysicsAPI.h>  // PhysX 一次到位的 header
 
 #include "BasicMesh.hpp"
+#include "resource/texture_cache.hpp"
 using namespace physx;
 
 namespace {
@@ -216,7 +217,7 @@ void TestPhysXMaterial::spawnCube(short cid, float scale, const glm::vec3& pos,
 
   if (texturePath != nullptr) {
     std::vector<std::shared_ptr<gfx::resource::Texture>> textures;
-    textures.emplace_back(std::make_shared<gfx::resource::Texture>(texturePath, "normal", 0));
+    textures.emplace_back(gfx::resource::TextureCache::instance().load(texturePath, "normal", 0));
     mesh->setTexture(textures);
   }
   mCubes.push_back(Cube{cid, actor, std::move(mesh), scale});
@@ -3,16 +3,19 @@
 #include <OPPCH.h>
 
 #include "BasicMesh.hpp"
+#include "resource/texture_cache.hpp"
 
 namespace test {
 
-TestRoom::TestRoom(const float screenWidth, const float screenHeight) {
+TestRoom::TestRoom(const float screenWidth, const float screenHeight)
+    : screenWidth(screenWidth), screenHeight(screenHeight) {
   glViewport(0, 0, screenWidth, screenHeight);
 
   shaderRoom = std::make_unique<Shader>("./shaders/room_vert.glsl", "./shaders/room_frag.glsl");
 
-  auto texMarble1 = std::make_shared<gfx::resource::Texture>("./assets/textures/marble1.png", "albedo", 0);
-  auto texMarble2 = std::make_shared<gfx::resource::Texture>("./assets/textures/marble2.png", "albedo", 0);
+  auto &textureCache = gfx::resource::TextureCache::instance();
+  auto texMarble1 = textureCache.load("./assets/textures/marble1.png", "albedo", 0);
+  auto texMarble2 = textureCache.load("./assets/textures/marble2.png", "albedo", 0);
 
   auto V1 = std::vector<std::shared_ptr<gfx::resource::Texture>>{texMarble1};
   auto V2 = std::vector<std::shared_ptr<gfx::resource::Texture>>{texMarble2};
@@ -37,6 +40,31 @@ TestRoom::TestRoom(const float screenWidth, const float screenHeight) {
 
   groundMesh = createPlaneMesh(100.0f, glm::vec3(0.0f, 1.0f, 0.0f));
 
+  // 24x24 顆球，只有中間 24 顆在房間裡
+  propMesh = createSphereMesh(1.0f, glm::vec3(0.0f), glm::vec3(1.0f), 32, 64);
+  std::vector<gfx::geom::Bounds> propBounds;
+  std::vector<GLuint> propIndexCounts;
+  for (int x = 0; x < 24; x++) {
+    for (int z = 0; z < 24; z++) {
+      glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(-57.5f + x * 5.0f, 1.2f, -57.5f + z * 5.0f));
+      propTransforms.push_back(m);
+      propBounds.push_back(propMesh->bounds.transformed(m));
+      propIndexCounts.push_back(static_cast<GLuint>(propMesh->indices.size()));
+    }
+  }
+
+  if (gfx::render::OcclusionCuller::supported()) {
+    gfx::core::FBOSpec sceneSpec;
+    sceneSpec.width = static_cast<int>(screenWidth);
+    sceneSpec.height = static_cast<int>(screenHeight);
+    sceneSpec.colorFormats = {GL_RGB8};
+    sceneSpec.depthFormat = GL_DEPTH_COMPONENT32F;  // 可取樣，給 Hi-Z pyramid
+    sceneFBO = std::make_unique<gfx::core::FBO>(sceneSpec);
+    depthPyramid = std::make_unique<gfx::render::DepthPyramid>(screenWidth, screenHeight);
+    occlusionCuller = std::make_unique<gfx::render::OcclusionCuller>();
+    occlusionCuller->setObjects(propBounds, propIndexCounts);
+  }
+
   glm::vec3 position = glm::vec3(7.0f, 6.0f, 3.0f);
   camera = std::make_unique<Camera>(screenWidth, screenHeight, position);
   listener = std::make_unique<GhostCameraListener>(camera.get());
@@ -73,6 +101,42 @@ void TestRoom::OnRender() {
 
   shaderRoom->use();
   camera->update(shaderRoom.get());
+
+  if (!useOcclusion || !occlusionCuller) {
+    drawRoom();
+    drawProps(nullptr);
+    return;
+  }
+
+  // 畫進自己的 FBO 才能取樣 depth
+  const glm::mat4 viewProj = camera->projMatrix * camera->viewMatrix;
+  sceneFBO->bind();
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  // phase 1：牆（occluder）+ 上一幀可見的物件
+  occlusionCuller->cullEarly(viewProj);
+  drawRoom();
+  drawProps(&occlusionCuller->earlyCommands());
+
+  // phase 2：用目前的 depth 建 Hi-Z，補畫這一幀才露出來的物件
+  depthPyramid->build(sceneFBO->depthTextureID);
+  occlusionCuller->cullLate(viewProj, *depthPyramid);
+  drawProps(&occlusionCuller->lateCommands());
+  sceneFBO->unbind();
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneFBO->ID);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glBlitFramebuffer(0, 0, screenWidth, screenHeight, 0, 0, screenWidth, screenHeight, GL_COLOR_BUFFER_BIT,
+                    GL_NEAREST);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  cullStats = occlusionCuller->readStats();
+}
+
+void TestRoom::drawRoom() {
+  shaderRoom->use();
+  glUniformMatrix4fv(glGetUniformLocation(shaderRoom->PROGRAM_ID, "modelMatrix"), 1, GL_FALSE,
+                     glm::value_ptr(glm::mat4(1.0f)));
   glUniform1i(glGetUniformLocation(shaderRoom->PROGRAM_ID, "classId"), 0);
   renderer.draw(*groundMesh, *shaderRoom);
 
@@ -87,7 +151,33 @@ void TestRoom::OnRender() {
   renderer.draw(*ceiling, *shaderRoom);
 }
 
-void TestRoom::OnImGuiRender() {}
+void TestRoom::drawProps(const gfx::core::SSBO *commands) {
+  shaderRoom->use();
+  glUniform1i(glGetUniformLocation(shaderRoom->PROGRAM_ID, "classId"), 4);
+  const GLint modelLoc = glGetUniformLocation(shaderRoom->PROGRAM_ID, "modelMatrix");
+  for (size_t i = 0; i < propTransforms.size(); i++) {
+    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(propTransforms[i]));
+    if (commands) {
+      renderer.drawIndirect(*propMesh, *shaderRoom, *commands, i);
+    } else {
+      renderer.draw(*propMesh, *shaderRoom);
+    }
+  }
+}
+
+void TestRoom::OnImGuiRender() {
+  ImGui::Text("props: %zu", propTransforms.size());
+  if (!occlusionCuller) {
+    ImGui::Text("Hi-Z occlusion culling needs GL 4.3");
+    return;
+  }
+  ImGui::Checkbox("Culling", &useOcclusion);
+  if (!useOcclusion) return;
+  ImGui::Checkbox("Hi-Z occlusion", &occlusionCuller->occlusionEnabled);
+  ImGui::Text("drawn early: %u", cullStats.drawnEarly);
+  ImGui::Text("drawn late: %u", cullStats.drawnLate);
+  ImGui::Text("occluded: %u", cullStats.occluded);
+}
 
 void TestRoom::OnExit() {}
 }  // namespace test
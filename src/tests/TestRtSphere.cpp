@@ -5,42 +5,65 @@
 #include <memory>
 
 #include "BasicMesh.hpp"
+#include "Model.hpp"
 
 namespace test {
 
+// 依 RtFeature 的 bit 順序
+static const std::vector<std::string> kRtFeatures = {"SPECULAR_BOUNCE", "SPECULAR_WHITE", "SHOW_SPHERE_LIGHT",
+                                                     "SHOW_CORNELL_PLANES", "SHOW_CORNELL_LIGHT"};
+
 TestRtSphere::TestRtSphere(const float screenWidth, const float screenHeight) {
   glViewport(0, 0, screenWidth, screenHeight);
 
-  shaderProgram = std::make_unique<Shader>("./shaders/rt_sphere_vert.glsl", "./shaders/rt_sphere_frag.glsl");
+  // SSBO + BVH 需要 GL 4.3，沒有時用 UBO 版本（只有 cornell box 與球，逐一測交）
+  useBVH = GLEW_VERSION_4_3;
+
+  // 每組 toggle 一個特化的 shader 版本（見 featureMask），UBO 陣列大小與 C++ 端一致
+  // setup 在每個版本第一次可用時設定不會變的 uniform 與 block binding
+  rtShaders = std::make_unique<ShaderPermutations>(
+      "./shaders/rt_sphere_vert.glsl",
+      useBVH ? "./shaders/rt_sphere_frag.glsl" : "./shaders/rt_sphere_ubo_frag.glsl", kRtFeatures,
+      ShaderDefines{{"MAX_SPHERES", std::to_string(MAX_SPHERES)},
+                    {"MAX_TRIANGLES", std::to_string(MAX_TRIANGLES)},
+                    {"MAX_LIGHTS", std::to_string(MAX_LIGHTS)}},
+      [this, screenWidth, screenHeight](Shader& shader) {
+        shader.use();
+        glUniform1f(glGetUniformLocation(shader.PROGRAM_ID, "fov"), camera->fov);
+        glUniform2f(glGetUniformLocation(shader.PROGRAM_ID, "resolution"), screenWidth, screenHeight);
+        if (useBVH) return;  // SSBO 的 binding 寫在 shader 的 layout 裡
+        glUniformBlockBinding(shader.PROGRAM_ID, glGetUniformBlockIndex(shader.PROGRAM_ID, "sphereData"), 0);
+        glUniformBlockBinding(shader.PROGRAM_ID, glGetUniformBlockIndex(shader.PROGRAM_ID, "triangleData"), 1);
+      });
   frameShader = std::make_unique<Shader>("./shaders/acc_framebuffer_vert.glsl", "./shaders/acc_framebuffer_frag.glsl");
+  motionShader = std::make_unique<Shader>("./shaders/acc_framebuffer_vert.glsl", "./shaders/temporal_motion_frag.glsl");
+  temporalShader =
+      std::make_unique<Shader>("./shaders/acc_framebuffer_vert.glsl", "./shaders/temporal_accumulate_frag.glsl");
+  blueNoise =
+      std::make_unique<gfx::resource::Texture>("./assets/textures/blue_noise_64.png", "blueNoise", BLUE_NOISE_UNIT);
 
   glm::vec3 position = glm::vec3(0.0f, 10.0f, 25.0f);
   glm::vec3 orientation = glm::vec3(0.0f, 0.0f, -1.0f);
   camera = std::make_shared<Camera>(screenWidth, screenHeight, position, orientation);
   listener = std::make_unique<GhostCameraListener>(camera.get());
   camera->setEventListener(listener.get());
+  prevViewMatrix = glm::lookAt(camera->position, camera->position + camera->orientation, camera->up);
+  prevCamPosition = camera->position;
 
   rtMesh = createPlaneMesh();
 
   // setup FBO
 
-  sceneFBO = std::make_unique<gfx::core::FBO>(screenWidth, screenHeight);
-  sceneFBO->setupTexture();
-
-  accumFBO[0] = std::make_unique<gfx::core::FBO>(screenWidth, screenHeight);
-  accumFBO[0]->setupTexture();
-  accumFBO[1] = std::make_unique<gfx::core::FBO>(screenWidth, screenHeight);
-  accumFBO[1]->setupTexture();
-
-  sceneFBO->bind();
-  auto fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-  if (fboStatus != GL_FRAMEBUFFER_COMPLETE) {
-    std::cerr << "Scene FBO is not complete! Error code: " << fboStatus << std::endl;
-  }
-  sceneFBO->unbind();
+  // float 才不會在累積很多幀之後出現 banding，也保留 > 1 的亮度；每幀 trace 的結果是 render graph 的 transient
+  gfx::core::FBOSpec accumSpec;
+  accumSpec.width = static_cast<int>(screenWidth);
+  accumSpec.height = static_cast<int>(screenHeight);
+  accumSpec.colorFormats = {GL_RGBA32F, GL_R32F};
+  accumFBO[0] = std::make_unique<gfx::core::FBO>(accumSpec);
+  accumFBO[1] = std::make_unique<gfx::core::FBO>(accumSpec);
 
   accumFBO[0]->bind();
-  fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  auto fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
   if (fboStatus != GL_FRAMEBUFFER_COMPLETE) {
     std::cerr << "Accum FBO-0 is not complete! Error code: " << fboStatus << std::endl;
   }
@@ -63,27 +86,28 @@ TestRtSphere::TestRtSphere(const float screenWidth, const float screenHeight) {
   // the rest of the spheres are random
   randomizeSpheres(spheres, numSpheres);
 
-  rtMesh->setupUBO(spheres, MAX_SPHERES, GL_DYNAMIC_DRAW, 0);
-
   // cornell box
   makeCornellBox(triangles);
 
-  rtMesh->setupUBO(triangles, MAX_TRIANGLES, GL_DYNAMIC_DRAW, 1);
-
-  shaderProgram->use();
-  glUniform1f(glGetUniformLocation(shaderProgram->PROGRAM_ID, "fov"), camera->fov);
-  glUniform2f(glGetUniformLocation(shaderProgram->PROGRAM_ID, "resolution"), screenWidth, screenHeight);
-  glUniformBlockBinding(shaderProgram->PROGRAM_ID, glGetUniformBlockIndex(shaderProgram->PROGRAM_ID, "sphereData"), 0);
-  glBindBufferBase(GL_UNIFORM_BUFFER, 0, rtMesh->ubo[0].ID);
-  glUniformBlockBinding(shaderProgram->PROGRAM_ID, glGetUniformBlockIndex(shaderProgram->PROGRAM_ID, "triangleData"),
-                        1);
-  glBindBufferBase(GL_UNIFORM_BUFFER, 1, rtMesh->ubo[1].ID);
-
-  frameShader->use();
-  accumFBO[0]->bindTexture(GL_TEXTURE0);
-  glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "oldFrame"), 0);  // texture unit 0
-  sceneFBO->bindTexture(GL_TEXTURE1);
-  glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "newFrame"), 1);  // texture unit 1
+  if (useBVH) {
+    sphereBuffer = std::make_unique<gfx::core::SSBO>();
+    triangleBuffer = std::make_unique<gfx::core::SSBO>();
+    nodeBuffer = std::make_unique<gfx::core::SSBO>();
+    indexBuffer = std::make_unique<gfx::core::SSBO>();
+    sphereBuffer->bind();
+    sphereBuffer->bufferData(spheres, MAX_SPHERES, GL_DYNAMIC_DRAW);
+    sphereBuffer->unbind();
+    rebuildTriangleBVH();
+  } else {
+    rtMesh->setupUBO(spheres, MAX_SPHERES, GL_DYNAMIC_DRAW, 0);
+    rtMesh->setupUBO(triangles, MAX_TRIANGLES, GL_DYNAMIC_DRAW, 1);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, rtMesh->ubo[0].ID);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 1, rtMesh->ubo[1].ID);
+  }
+  rtShaders->select(featureMask(), {{"NUM_BOUNCES", std::to_string(shaderBounces)},
+                                    {"NUM_RAYS", std::to_string(shaderRays)}});  // 第一個版本同步 compile
+
+  denoiser = std::make_unique<gfx::render::Denoiser>(accumSpec.width, accumSpec.height);
 }
 
 TestRtSphere::~TestRtSphere() {}
@@ -91,14 +115,13 @@ TestRtSphere::~TestRtSphere() {}
 void TestRtSphere::OnEvent(SDL_Event& event) { camera->handle(event); }
 
 void TestRtSphere::OnRender() {
-  // 1. bind anything to the framebuffer, including the backgroud
-  sceneFBO->bind();
-
-  // 2. render the main scene
-  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  using gfx::render::RenderGraph;
+  const int width = static_cast<int>(accumFBO[0]->width);
+  const int height = static_cast<int>(accumFBO[0]->height);
 
   camera->moveCamera();
+  const glm::mat4 viewMatrix = glm::lookAt(camera->position, camera->position + camera->orientation, camera->up);
+  const bool cameraMoved = viewMatrix != prevViewMatrix;
 
   // some time based animation
   if (isRotate) {
@@ -107,93 +130,256 @@ void TestRtSphere::OnRender() {
     spheres[0].center[1] = CBS + 9.0f * cos(timeValue);
     spheres[0].center[2] = 9.0f * cos(timeValue);
   }
-  rtMesh->updateUBO(spheres, MAX_SPHERES, 0);
-  rtMesh->updateUBO(triangles, MAX_TRIANGLES, 1);
-
-  shaderProgram->use();
-  camera->update(shaderProgram.get());
-
-  glUniform1ui(glGetUniformLocation(shaderProgram->PROGRAM_ID, "frameIdx"), frameIdx);
-  glUniform1i(glGetUniformLocation(shaderProgram->PROGRAM_ID, "numSpheres"), numSpheres);
-  glUniform1i(glGetUniformLocation(shaderProgram->PROGRAM_ID, "numBounces"), numBounces);
-  glUniform1i(glGetUniformLocation(shaderProgram->PROGRAM_ID, "numRays"), numRays);
-  glUniform1i(glGetUniformLocation(shaderProgram->PROGRAM_ID, "isSpecularBounce"), enableSpecularBounce);
-  glUniform1i(glGetUniformLocation(shaderProgram->PROGRAM_ID, "isSpecularWhite"), isSpecularWhite);
-  glUniform1f(glGetUniformLocation(shaderProgram->PROGRAM_ID, "ambientLight"), ambientLight);
-  glUniform1i(glGetUniformLocation(shaderProgram->PROGRAM_ID, "showSphereLight"), showSphereLight);
-  glUniform1i(glGetUniformLocation(shaderProgram->PROGRAM_ID, "showCornellLight"), isShowCornellLight);
-  glUniform1i(glGetUniformLocation(shaderProgram->PROGRAM_ID, "showCornellPlanes"), isShowCornellPlanes);
-
-  renderer.draw(*rtMesh, *shaderProgram);
-
-  // 3. after rendering the main scene, unbind the framebuffer
-  sceneFBO->unbind();
-
-  // 4. if not real time, store the new frame texture to the old frame texture
-  if (!isRealTime) {
-    const int A = ping;      // 讀取的舊累積
-    const int B = ping ^ 1;  // 寫入的新累積
-
-    accumFBO[B]->bind();
-    frameShader->use();
-
-    // 綁 old = accum[A]
-    glActiveTexture(GL_TEXTURE0);
-    accumFBO[A]->bindTexture(GL_TEXTURE0);
-    glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "oldFrame"), 0);
-
-    // 綁 new = sceneFBO
-    glActiveTexture(GL_TEXTURE1);
-    sceneFBO->bindTexture(GL_TEXTURE1);
-    glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "newFrame"), 1);
-
-    // 用 frameIdx 做 1/(N+1) 權重
-    glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "numFrames"), frameIdx);
-
-    // render on the new frame
-    renderer.draw(*frameMesh, *shaderProgram);
-    accumFBO[B]->unbind();
-    ping ^= 1;
-  } else {  // Real time mode
-    const int B = ping ^ 1;
-    accumFBO[B]->bind();
-    // 最簡 copy：沿用 frameShader 但讓 weight=1（numFrames=0 ⇒ weight=1）
-    frameShader->use();
-    glActiveTexture(GL_TEXTURE0);
-    // old 隨便綁一張（不會被用到，因為 weight=1）
-    accumFBO[ping]->bindTexture(GL_TEXTURE0);
-    glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "oldFrame"), 0);
-    glActiveTexture(GL_TEXTURE1);
-    sceneFBO->bindTexture(GL_TEXTURE1);
-    glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "newFrame"), 1);
-    glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "numFrames"), 0);
-    renderer.draw(*frameMesh, *shaderProgram);
-    accumFBO[B]->unbind();
-    ping ^= 1;
-  }
-
-  // 5. render the frame buffer to the screen
-  frameShader->use();
-  glActiveTexture(GL_TEXTURE0);
-  accumFBO[ping]->bindTexture(GL_TEXTURE0);
-  glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "oldFrame"), 0);
-  glActiveTexture(GL_TEXTURE1);
-  accumFBO[ping]->bindTexture(GL_TEXTURE1);
-  glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "newFrame"), 1);
-
-  glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "numFrames"), -1);  // weight ≈ 0
-
-  glDisable(GL_DEPTH_TEST);
-  renderer.draw(*frameMesh, *shaderProgram);
-  glEnable(GL_DEPTH_TEST);
+  if (useBVH) {
+    uploadSphereBVH();
+    // cornell box 的材質可以在 GUI 調整，每幀更新前 MAX_TRIANGLES 個；BVH 只跟位置有關不用重建
+    triangleBuffer->bind();
+    triangleBuffer->bufferSubData(triangles, MAX_TRIANGLES);
+    triangleBuffer->unbind();
+    sphereBuffer->bindBase(0);
+    triangleBuffer->bindBase(1);
+    nodeBuffer->bindBase(2);
+    indexBuffer->bindBase(3);
+  } else {
+    rtMesh->updateUBO(spheres, MAX_SPHERES, 0);
+    rtMesh->updateUBO(triangles, MAX_TRIANGLES, 1);
+  }
 
+  const int A = ping;      // 讀取的舊累積
+  const int B = ping ^ 1;  // 寫入的新累積
+  const RenderGraph::Resource oldAccum = graph.importTarget("accum_old", *accumFBO[A]);
+  const RenderGraph::Resource newAccum = graph.importTarget("accum_new", *accumFBO[B]);
+  // 相機與場景都沒動時 reprojection 是恆等的，逐 pixel 的 variance 才有意義，收斂的 pixel 不再 trace
+  const bool sceneMoving = isRealTime || cameraMoved || isRotate;
+  const bool adaptive = useAdaptive && useTemporal && !sceneMoving && !useWavefront;
+
+  // 1. trace：新的一幀與第一個交點的 G-buffer
+  gfx::render::Denoiser::Input color, albedo, normalDepth;
+  if (useWavefront) {
+    // compute pass 直接寫進 wavefront 的 float texture
+    color = {graph.importTexture("wavefront_color", wavefront->textureID, width, height)};
+    albedo = {graph.importTexture("wavefront_albedo", wavefront->albedoTextureID, width, height)};
+    normalDepth = {graph.importTexture("wavefront_normal_depth", wavefront->normalDepthTextureID, width, height)};
+    graph.addPass(
+        "wavefront_trace",
+        [&](RenderGraph::Builder& builder) {
+          builder.writeImage(color.resource);
+          builder.writeImage(albedo.resource);
+          builder.writeImage(normalDepth.resource);
+        },
+        [this](const RenderGraph::Context&) {
+          blueNoise->bind();
+          wavefront->setDefines(featureDefines());
+          wavefront->setLights(collectLights());
+          gfx::render::WavefrontPathTracer::Frame frame;
+          frame.camPosition = camera->position;
+          frame.viewMatrix = glm::lookAt(camera->position, camera->position + camera->orientation, camera->up);
+          frame.fov = camera->fov;
+          frame.frameIdx = frameIdx;
+          frame.ambientLight = ambientLight;
+          frame.sphereRoot = sphereRoot;
+          frame.triangleRoot = triangleNodes > 0 ? SPHERE_NODE_CAPACITY : -1;
+          frame.numRays = numRays;
+          frame.numBounces = numBounces;
+          frame.samplerType = samplerType;
+          frame.blueNoiseUnit = static_cast<int>(BLUE_NOISE_UNIT);
+          wavefront->render(frame);
+        });
+  } else {
+    // float 才不會在累積很多幀之後出現 banding，也保留 > 1 的亮度；attachment 1 / 2 是給 denoiser 的 G-buffer
+    gfx::core::FBOSpec sceneSpec;
+    sceneSpec.width = width;
+    sceneSpec.height = height;
+    sceneSpec.colorFormats = {GL_RGBA32F, GL_RGBA8, GL_RGBA32F};
+    // variable rate：先畫 1/rateScale 解析度，全解析度那次只在邊緣 trace，其他 pixel 內插
+    // 只有 SAMPLER_BLUE_NOISE 會讀；跟其他輸入一起由 bindInputs 分配 unit，不會被蓋掉
+    const RenderGraph::Resource blueNoiseTex =
+        graph.importTexture("blue_noise", blueNoise->id(), BLUE_NOISE_SIZE, BLUE_NOISE_SIZE);
+    RenderGraph::Resource lowRes = RenderGraph::kInvalid;
+    if (useVariableRate) {
+      gfx::core::FBOSpec lowSpec = gfx::render::variableRateSpec(width, height, rateScale, GL_RGBA32F);
+      lowSpec.colorFormats = sceneSpec.colorFormats;
+      graph.addPass(
+          "fragment_trace_low",
+          [&](RenderGraph::Builder& builder) {
+            builder.read(blueNoiseTex, "blueNoiseTex");
+            lowRes = builder.create("scene_low", lowSpec);
+            builder.write(lowRes);
+          },
+          [this, width, height](const RenderGraph::Context& context) {
+            traceFragment(context, gfx::render::VariableRatePass::Low, width, height, false);
+          });
+    }
+    graph.addPass(
+        "fragment_trace",
+        [&](RenderGraph::Builder& builder) {
+          builder.read(blueNoiseTex, "blueNoiseTex");
+          if (lowRes != RenderGraph::kInvalid) {
+            builder.read(lowRes, "lowResColor", 0);
+            builder.read(lowRes, "lowResGuide", 2);
+          }
+          if (adaptive) {
+            builder.read(oldAccum, "adaptiveColor", 0);
+            builder.read(oldAccum, "adaptiveLength", 1);
+          }
+          const RenderGraph::Resource scene = builder.create("scene", sceneSpec);
+          builder.write(scene);
+          color = {scene, 0};
+          albedo = {scene, 1};
+          normalDepth = {scene, 2};
+        },
+        [this, width, height, adaptive](const RenderGraph::Context& context) {
+          using gfx::render::VariableRatePass;
+          traceFragment(context, useVariableRate ? VariableRatePass::Upsample : VariableRatePass::Off, width, height,
+                        adaptive);
+        });
+  }
+
+  // 2. accumulate：progressive 時 new 以 1/(N+1) 權重混進 accum[A]，real time 時 numFrames = 0 ⇒ 只留 new
+  if (useTemporal) {
+    // 2a. motion vectors：第一個交點的位置投影到上一幀的相機
+    RenderGraph::Resource motion = RenderGraph::kInvalid;
+    gfx::core::FBOSpec motionSpec;
+    motionSpec.width = width;
+    motionSpec.height = height;
+    motionSpec.colorFormats = {GL_RGBA16F};
+    graph.addPass(
+        "motion_vectors",
+        [&](RenderGraph::Builder& builder) {
+          builder.read(normalDepth.resource, "normalDepthTex", normalDepth.attachment);
+          motion = builder.create("motion", motionSpec);
+          builder.write(motion);
+        },
+        [this, width, height](const RenderGraph::Context& context) {
+          motionShader->use();
+          const GLuint program = motionShader->PROGRAM_ID;
+          context.bindInputs(program);
+          camera->update(motionShader.get());
+          glUniform1f(glGetUniformLocation(program, "fov"), camera->fov);
+          glUniform2f(glGetUniformLocation(program, "resolution"), width, height);
+          glUniform3fv(glGetUniformLocation(program, "prevCamPosition"), 1, glm::value_ptr(prevCamPosition));
+          glUniformMatrix4fv(glGetUniformLocation(program, "prevViewMatrix"), 1, GL_FALSE,
+                             glm::value_ptr(prevViewMatrix));
+          renderer.draw(*frameMesh, *motionShader);
+        });
+
+    // 2b. reproject accum[A] 再混入新的一幀；相機與場景都沒動的 progressive 模式不 clip、不限幀數，結果與原本相同
+    const float maxHistory = sceneMoving ? static_cast<float>(temporalHistory) : 1e7f;
+    graph.addPass(
+        "temporal_accumulate",
+        [&](RenderGraph::Builder& builder) {
+          builder.read(color.resource, "newFrame", color.attachment);
+          builder.read(oldAccum, "historyColor", 0);
+          builder.read(oldAccum, "historyLength", 1);
+          builder.read(motion, "motionTex");
+          builder.write(newAccum);
+        },
+        [this, sceneMoving, maxHistory](const RenderGraph::Context& context) {
+          temporalShader->use();
+          const GLuint program = temporalShader->PROGRAM_ID;
+          context.bindInputs(program);
+          glUniform1f(glGetUniformLocation(program, "maxHistory"), maxHistory);
+          glUniform1i(glGetUniformLocation(program, "clipHistory"), sceneMoving);
+          renderer.draw(*frameMesh, *temporalShader);
+        });
+  } else {
+    graph.addPass(
+        "accumulate",
+        [&](RenderGraph::Builder& builder) {
+          builder.read(oldAccum, "oldFrame");
+          builder.read(color.resource, "newFrame", color.attachment);
+          builder.write(newAccum);
+        },
+        [this](const RenderGraph::Context& context) {
+          frameShader->use();
+          context.bindInputs(frameShader->PROGRAM_ID);
+          glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "numFrames"), isRealTime ? 0 : frameIdx);
+          renderer.draw(*frameMesh, *frameShader);
+        });
+  }
+  ping ^= 1;
+
+  // 3. denoise the accumulation (progressive: frameIdx + 1 frames so far, real time: this frame only,
+  //    temporal: the per-pixel history length)
+  // 一律加進 graph，沒開啟時 present 不讀結果，整串 pass 會被 cull 掉
+  const int sampleCount = isRealTime ? 1 : static_cast<int>(frameIdx) + 1;
+  const RenderGraph::Resource denoised =
+      denoiser->addPasses(graph, {newAccum}, albedo, normalDepth, sampleCount, denoiseSettings,
+                          useTemporal ? gfx::render::Denoiser::Input{newAccum, 1}
+                                      : gfx::render::Denoiser::Input{RenderGraph::kInvalid});
+
+  // 4. render the frame buffer to the screen
+  const RenderGraph::Resource display = useDenoiser ? denoised : newAccum;
+  graph.addPass(
+      "present",
+      [&](RenderGraph::Builder& builder) {
+        builder.read(display, "oldFrame");
+        builder.read(display, "newFrame");
+        builder.write(graph.importBackbuffer(width, height));
+      },
+      [this](const RenderGraph::Context& context) {
+        frameShader->use();
+        context.bindInputs(frameShader->PROGRAM_ID);
+        glUniform1i(glGetUniformLocation(frameShader->PROGRAM_ID, "numFrames"), -1);  // weight ≈ 0
+        glDisable(GL_DEPTH_TEST);
+        renderer.draw(*frameMesh, *frameShader);
+        glEnable(GL_DEPTH_TEST);
+      });
+
+  graph.execute();
+  prevViewMatrix = viewMatrix;
+  prevCamPosition = camera->position;
   frameIdx++;
+  targetPool.endFrame();
+}
+
+void TestRtSphere::traceFragment(const gfx::render::RenderGraph::Context& context,
+                                 gfx::render::VariableRatePass pass, int width, int height, bool adaptive) {
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  // 新的組合在背景 compile，好之前沿用上一個版本
+  Shader& shaderProgram = rtShaders->select(
+      featureMask(), {{"NUM_BOUNCES", std::to_string(shaderBounces)}, {"NUM_RAYS", std::to_string(shaderRays)}});
+  shaderProgram.use();
+  camera->update(&shaderProgram);
+  context.bindInputs(shaderProgram.PROGRAM_ID);
+  // 低解析度那次的 resolution 不是整數，pixel 中心才會對齊全解析度的 pixel
+  const float scale = pass == gfx::render::VariableRatePass::Low ? static_cast<float>(rateScale) : 1.0f;
+  glUniform2f(glGetUniformLocation(shaderProgram.PROGRAM_ID, "resolution"), width / scale, height / scale);
+  glUniform1i(glGetUniformLocation(shaderProgram.PROGRAM_ID, "variableRatePass"), static_cast<GLint>(pass));
+  glUniform1f(glGetUniformLocation(shaderProgram.PROGRAM_ID, "variableRateScale"), static_cast<float>(rateScale));
+  glUniform1i(glGetUniformLocation(shaderProgram.PROGRAM_ID, "adaptiveSampling"), adaptive);
+  glUniform1f(glGetUniformLocation(shaderProgram.PROGRAM_ID, "adaptiveThreshold"), adaptiveThreshold);
+
+  glUniform1ui(glGetUniformLocation(shaderProgram.PROGRAM_ID, "frameIdx"), frameIdx);
+  glUniform1i(glGetUniformLocation(shaderProgram.PROGRAM_ID, "numSpheres"), numSpheres);
+  glUniform1f(glGetUniformLocation(shaderProgram.PROGRAM_ID, "ambientLight"), ambientLight);
+  glUniform1i(glGetUniformLocation(shaderProgram.PROGRAM_ID, "samplerType"), samplerType);
+  const std::vector<int32_t> lights = collectLights();
+  glUniform1i(glGetUniformLocation(shaderProgram.PROGRAM_ID, "lightCount"), static_cast<GLint>(lights.size()));
+  if (!lights.empty()) {
+    glUniform1iv(glGetUniformLocation(shaderProgram.PROGRAM_ID, "lightList"), static_cast<GLsizei>(lights.size()),
+                 lights.data());
+  }
+  if (useBVH) {
+    glUniform1i(glGetUniformLocation(shaderProgram.PROGRAM_ID, "sphereRoot"), sphereRoot);
+    glUniform1i(glGetUniformLocation(shaderProgram.PROGRAM_ID, "triangleRoot"),
+                triangleNodes > 0 ? SPHERE_NODE_CAPACITY : -1);
+  }
+
+  renderer.draw(*rtMesh, shaderProgram);
 }
 
 void TestRtSphere::OnImGuiRender() {
   ImGui::BulletText("Ray Casting:");
   ImGui::SliderInt("Bounces", &numBounces, 1, 10);
+  if (ImGui::IsItemDeactivatedAfterEdit()) shaderBounces = numBounces;
   ImGui::SliderInt("Ray Num", &numRays, 1, 20);
+  if (ImGui::IsItemDeactivatedAfterEdit()) shaderRays = numRays;
+  // Random 是原本的白噪；Sobol / Blue Noise 在同樣 sample 數下噪點較少，累積時收斂也較快
+  static const char* samplerTypes[] = {"Random", "Sobol (Owen)", "Blue Noise"};
+  ImGui::Combo("Sampler", &samplerType, samplerTypes, 3);
   ImGui::Checkbox("Enable Specular Bounce", &enableSpecularBounce);
   ImGui::Checkbox("White Light Reflect", &isSpecularWhite);
 
@@ -247,8 +433,59 @@ void TestRtSphere::OnImGuiRender() {
     randomizeSpheres(spheres, numSpheres);
   }
 
+  ImGui::BulletText("Scene:");
+  if (useBVH) {
+    if (ImGui::Checkbox("Duck Mesh", &showMesh)) rebuildTriangleBVH();
+    ImGui::SliderInt("Copies", &meshCopies, 1, 32);
+    if (ImGui::IsItemDeactivatedAfterEdit() && showMesh) rebuildTriangleBVH();
+    ImGui::Text("%zu triangles, %d BVH nodes, depth %d", sceneTriangles, triangleNodes, bvhDepth);
+  } else {
+    ImGui::Text("Scene BVH / meshes need OpenGL 4.3");
+  }
+
   ImGui::BulletText("Render:");
-  if (ImGui::Checkbox("Real Time Toggle", &isRealTime)) {
+  if (useBVH && gfx::render::WavefrontPathTracer::supported()) {
+    if (ImGui::Checkbox("Wavefront (compute)", &useWavefront) && useWavefront && !wavefront) {
+      wavefront = std::make_unique<gfx::render::WavefrontPathTracer>(
+          static_cast<int>(accumFBO[0]->width), static_cast<int>(accumFBO[0]->height), featureDefines());
+    }
+  }
+  ImGui::Checkbox("Denoise", &useDenoiser);
+  if (useDenoiser) {
+    ImGui::SliderInt("Iterations", &denoiseSettings.iterations, 1, 6);
+    ImGui::SliderFloat("Sigma Lum", &denoiseSettings.sigmaLuminance, 0.5f, 16.0f);
+    ImGui::SliderFloat("Sigma Normal", &denoiseSettings.sigmaNormal, 1.0f, 256.0f);
+    ImGui::SliderFloat("Sigma Depth", &denoiseSettings.sigmaDepth, 0.1f, 4.0f);
+  }
+  // 上一幀的 graph：culled 是沒人用而略過的 pass，transient 數比 target 多的部分是共用同一個 FBO 的
+  const gfx::render::RenderGraph::Stats& stats = graph.stats();
+  ImGui::Text("Graph: %zu passes, %zu culled", stats.passes, stats.culled);
+  ImGui::Text("Transients: %zu in %zu targets", stats.transients, stats.targets);
+  ImGui::Text("Pooled targets: %zu (%.1f MB)", targetPool.size(), targetPool.memoryBytes() / (1024.0 * 1024.0));
+  if (useWavefront) {
+    ImGui::Checkbox("Queue Stats", &showQueueStats);
+    if (showQueueStats) {
+      // 每個 bounce 開始時還活著的 path 數（第一個 sample），會等 GPU
+      const std::vector<GLuint> active = wavefront->readActivePaths();
+      for (size_t i = 0; i < active.size(); i++) ImGui::Text(" - bounce %zu: %u paths", i, active[i]);
+    }
+  } else {
+    const int compiling = rtShaders->compiling();
+    ImGui::Text("Shader variants: %zu cached%s", rtShaders->size(), compiling ? ", compiling..." : "");
+  }
+  if (!useWavefront) {
+    ImGui::Checkbox("Variable Rate", &useVariableRate);
+    if (useVariableRate) ImGui::SliderInt("Rate", &rateScale, 2, 4);
+    // 需要逐 pixel 的幀數，只有 temporal 累積有
+    if (useTemporal && !isRealTime) {
+      ImGui::Checkbox("Adaptive Sampling", &useAdaptive);
+      if (useAdaptive) ImGui::SliderFloat("Rel. Error", &adaptiveThreshold, 0.002f, 0.1f, "%.3f");
+    }
+  }
+  // 關閉時第二個 attachment 不會寫，重新開啟前先清掉
+  const bool temporalToggled = ImGui::Checkbox("Temporal Reprojection", &useTemporal);
+  if (useTemporal) ImGui::SliderInt("History", &temporalHistory, 2, 128);
+  if (ImGui::Checkbox("Real Time Toggle", &isRealTime) || temporalToggled) {
     frameIdx = 0;  // reset frame index
     for (int i = 0; i < 2; i++) {
       accumFBO[i]->bind();
@@ -261,6 +498,136 @@ void TestRtSphere::OnImGuiRender() {
 
 void TestRtSphere::OnExit() {}
 
+uint32_t TestRtSphere::featureMask() const {
+  uint32_t mask = 0;
+  if (enableSpecularBounce) mask |= RT_SPECULAR_BOUNCE;
+  // 白光反射只在鏡面反射開啟時有作用，關閉時不多編一個相同的版本
+  if (enableSpecularBounce && isSpecularWhite) mask |= RT_SPECULAR_WHITE;
+  if (showSphereLight) mask |= RT_SPHERE_LIGHT;
+  if (isShowCornellPlanes) mask |= RT_CORNELL_PLANES;
+  if (isShowCornellLight) mask |= RT_CORNELL_LIGHT;
+  return mask;
+}
+
+ShaderDefines TestRtSphere::featureDefines() const {
+  ShaderDefines defines{{"MAX_LIGHTS", std::to_string(MAX_LIGHTS)}};
+  const uint32_t mask = featureMask();
+  for (size_t i = 0; i < kRtFeatures.size(); i++) {
+    if (mask & (1u << i)) defines.emplace_back(kRtFeatures[i], "");
+  }
+  return defines;
+}
+
+std::vector<int32_t> TestRtSphere::collectLights() const {
+  std::vector<int32_t> lights;
+  for (int i = showSphereLight ? 0 : 1; i < numSpheres; i++) {
+    if (spheres[i].material.shininess > 0.0f) lights.push_back(-(i + 1));
+  }
+  // 沒顯示的平面 / 燈在 shader 裡測不到交點，也不能當光源
+  const int first = isShowCornellPlanes ? 0 : 12;
+  const int end = isShowCornellLight ? MAX_TRIANGLES : 12;
+  for (int i = first; i < end; i++) {
+    if (triangles[i].material.shininess > 0.0f) lights.push_back(i);
+  }
+  return lights;
+}
+
+void TestRtSphere::loadMeshTemplate() {
+  if (!meshTemplate.empty()) return;
+  Model model("./assets/gltf_duck/Duck.gltf");
+  glm::vec3 lo(std::numeric_limits<float>::max()), hi(-std::numeric_limits<float>::max());
+  for (const auto& mesh : model.meshes) {
+    for (const auto& v : mesh.vertices) {
+      lo = glm::min(lo, v.position);
+      hi = glm::max(hi, v.position);
+    }
+  }
+  // 最長邊縮放成 1，底部中心移到原點
+  const glm::vec3 size = hi - lo;
+  const float scale = 1.0f / std::max(size.x, std::max(size.y, size.z));
+  const glm::vec3 base((lo.x + hi.x) * 0.5f, lo.y, (lo.z + hi.z) * 0.5f);
+
+  Material material{};
+  material.color = glm::vec4(1.0f, 0.8f, 0.1f, 1.0f);
+  material.emissionColor = material.color;
+  material.smoothness = 0.6f;
+  material.specularProbability = 0.2f;
+  for (const auto& mesh : model.meshes) {
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+      Triangle t{};
+      t.posA = (mesh.vertices[mesh.indices[i]].position - base) * scale;
+      t.posB = (mesh.vertices[mesh.indices[i + 1]].position - base) * scale;
+      t.posC = (mesh.vertices[mesh.indices[i + 2]].position - base) * scale;
+      const glm::vec3 n = glm::cross(t.posB - t.posA, t.posC - t.posA);
+      if (glm::length(n) == 0.0f) continue;  // degenerate
+      t.normal = glm::normalize(n);
+      t.material = material;
+      meshTemplate.push_back(t);
+    }
+  }
+}
+
+void TestRtSphere::rebuildTriangleBVH() {
+  std::vector<Triangle> scene(triangles, triangles + MAX_TRIANGLES);
+  if (showMesh) {
+    loadMeshTemplate();
+    // 多份 mesh 排成格狀放在地板上，用來測大量三角形（32 份鴨子約 13 萬個三角形）
+    const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(meshCopies))));
+    const float cell = CBS2 * 0.8f / side;
+    const float scale = cell * 0.9f;
+    scene.reserve(scene.size() + meshTemplate.size() * meshCopies);
+    for (int c = 0; c < meshCopies; c++) {
+      const glm::vec3 offset(-CBS * 0.8f + cell * (c % side + 0.5f), 0.0f, -CBS * 0.8f + cell * (c / side + 0.5f));
+      for (Triangle t : meshTemplate) {
+        t.posA = t.posA * scale + offset;
+        t.posB = t.posB * scale + offset;
+        t.posC = t.posC * scale + offset;
+        scene.push_back(t);
+      }
+    }
+  }
+
+  std::vector<gfx::geom::BVHPrimitive> primitives(scene.size());
+  for (size_t i = 0; i < scene.size(); i++) {
+    primitives[i].min = glm::min(scene[i].posA, glm::min(scene[i].posB, scene[i].posC));
+    primitives[i].max = glm::max(scene[i].posA, glm::max(scene[i].posB, scene[i].posC));
+  }
+  gfx::geom::BVHData bvh = gfx::geom::buildBVH(primitives);
+  gfx::geom::offsetBVH(bvh, SPHERE_NODE_CAPACITY, MAX_SPHERES);
+
+  triangleBuffer->bind();
+  triangleBuffer->bufferData(scene.data(), scene.size(), GL_DYNAMIC_DRAW);
+  nodeBuffer->bind();
+  nodeBuffer->bufferData<gfx::geom::BVHNode>(nullptr, SPHERE_NODE_CAPACITY + bvh.nodes.size(), GL_DYNAMIC_DRAW);
+  nodeBuffer->bufferSubData(bvh.nodes.data(), bvh.nodes.size(), SPHERE_NODE_CAPACITY);
+  indexBuffer->bind();
+  indexBuffer->bufferData<uint32_t>(nullptr, MAX_SPHERES + bvh.indices.size(), GL_DYNAMIC_DRAW);
+  indexBuffer->bufferSubData(bvh.indices.data(), bvh.indices.size(), MAX_SPHERES);
+  indexBuffer->unbind();
+
+  sceneTriangles = scene.size();
+  triangleNodes = static_cast<int>(bvh.nodes.size());
+  bvhDepth = bvh.depth;
+}
+
+void TestRtSphere::uploadSphereBVH() {
+  std::vector<gfx::geom::BVHPrimitive> primitives(numSpheres);
+  for (int i = 0; i < numSpheres; i++) {
+    primitives[i].min = spheres[i].center - glm::vec3(spheres[i].radius);
+    primitives[i].max = spheres[i].center + glm::vec3(spheres[i].radius);
+  }
+  const gfx::geom::BVHData bvh = gfx::geom::buildBVH(primitives, 2);
+
+  sphereBuffer->bind();
+  sphereBuffer->bufferSubData(spheres, MAX_SPHERES);
+  nodeBuffer->bind();
+  nodeBuffer->bufferSubData(bvh.nodes.data(), bvh.nodes.size());
+  indexBuffer->bind();
+  indexBuffer->bufferSubData(bvh.indices.data(), bvh.indices.size());
+  indexBuffer->unbind();
+  sphereRoot = bvh.nodes.empty() ? -1 : 0;
+}
+
 void TestRtSphere::randomizeSpheres(Sphere* spheres, const int numSpheres) {
   // generate random spheres
   std::random_device rd;
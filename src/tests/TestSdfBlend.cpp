@@ -6,11 +6,14 @@
 
 namespace test {
 
-TestSdfBlend::TestSdfBlend(const float screenWidth, const float screenHeight) {
+TestSdfBlend::TestSdfBlend(const float screenWidth, const float screenHeight)
+    : screenWidth(screenWidth), screenHeight(screenHeight) {
   glViewport(0, 0, screenWidth, screenHeight);
 
-  shaderModel = std::make_unique<Shader>("./shaders/light_vert.glsl", "./shaders/light_frag.glsl");
-  shaderSDF = std::make_unique<Shader>("./shaders/sdf_blend_vert.glsl", "./shaders/sdf_blend_frag.glsl");
+  // 兩個 program 一起送出 compile，OnRender 等它們都好了才開始畫
+  shaderModel = std::make_unique<Shader>(Shader::async, "./shaders/light_vert.glsl", "./shaders/light_frag.glsl");
+  shaderSDF = std::make_unique<Shader>(Shader::async, "./shaders/sdf_blend_vert.glsl", "./shaders/sdf_blend_frag.glsl",
+                                       ShaderDefines{{"STEPS", std::to_string(steps)}});
 
   // mesh for rendering the sdf
   sdfMesh = createPlaneMesh();
@@ -28,7 +31,13 @@ TestSdfBlend::TestSdfBlend(const float screenWidth, const float screenHeight) {
   glDepthFunc(GL_LESS);
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+TestSdfBlend::~TestSdfBlend() {}
 
+void TestSdfBlend::OnEvent(SDL_Event &event) { camera->handle(event); }
+
+void TestSdfBlend::setupShaders() {
   // sdf shader
   shaderSDF->use();
   glUniform2f(glGetUniformLocation(shaderSDF->PROGRAM_ID, "resolution"), screenWidth, screenHeight);
@@ -43,11 +52,13 @@ TestSdfBlend::TestSdfBlend(const float screenWidth, const float screenHeight) {
   glUseProgram(0);
 }
 
-TestSdfBlend::~TestSdfBlend() {}
-
-void TestSdfBlend::OnEvent(SDL_Event &event) { camera->handle(event); }
-
 void TestSdfBlend::OnRender() {
+  if (!shadersReady) {
+    if (!waitForShaders({shaderModel.get(), shaderSDF.get()})) return;
+    setupShaders();
+    shadersReady = true;
+  }
+
   glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -76,16 +87,35 @@ void TestSdfBlend::OnRender() {
     glUniform3fv(glGetUniformLocation(shaderSDF->PROGRAM_ID, "lightPosition"), 1, lightPos);
     glUniform1i(glGetUniformLocation(shaderSDF->PROGRAM_ID, "isSphere"), isSphere);
     camera->update(shaderSDF.get());
-    renderer.draw(*sdfMesh, *shaderSDF);
+    if (useVariableRate) {
+      glUniform1f(glGetUniformLocation(shaderSDF->PROGRAM_ID, "colorEdgeThreshold"), colorEdge);
+      variableRate.render(*shaderSDF, static_cast<int>(screenWidth), static_cast<int>(screenHeight), rateScale, 0,
+                          [this] { renderer.draw(*sdfMesh, *shaderSDF); });
+    } else {
+      gfx::render::VariableRateRenderer::disable(*shaderSDF);
+      renderer.draw(*sdfMesh, *shaderSDF);
+    }
   }
 }
 
 void TestSdfBlend::OnImGuiRender() {
+  if (!shadersReady) ImGui::Text("Compiling shaders...");
   ImGui::Checkbox("Move Light", &isLightMove);
   ImGui::SliderFloat("Size", &size, 0.5f, 3.0f);
   ImGui::Checkbox("Show SDF", &isShowSdf);
   ImGui::Checkbox("SDF Sphere", &isSphere);
+  // STEPS 是 compile-time 常數，改了要重建 program（之後會命中 program binary cache）
+  ImGui::SliderInt("March Steps", &steps, 32, 512);
+  if (ImGui::IsItemDeactivatedAfterEdit() && shadersReady) {
+    shaderSDF->setDefines({{"STEPS", std::to_string(steps)}});
+    setupShaders();
+  }
   ImGui::ColorEdit3("SDF", sdfColor);
+  ImGui::Checkbox("Variable Rate", &useVariableRate);
+  if (useVariableRate) {
+    ImGui::SliderInt("Rate", &rateScale, 2, 4);
+    ImGui::SliderFloat("Color Edge", &colorEdge, 0.0f, 0.5f);
+  }
   ImGui::Checkbox("Show Model", &isShowModel);
   ImGui::ColorEdit3("Model", modelColor);
 }
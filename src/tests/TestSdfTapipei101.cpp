@@ -1,20 +1,25 @@
 #include <OPPCH.h>
 
 #include "BasicMesh.hpp"
+#include "resource/texture_cache.hpp"
 #include "tests/TestSdfTaipei101.hpp"
 
 namespace test {
 
-TestSdfTaipei101::TestSdfTaipei101(const float screenWidth, const float screenHeight) {
+TestSdfTaipei101::TestSdfTaipei101(const float screenWidth, const float screenHeight)
+    : screenWidth(screenWidth), screenHeight(screenHeight) {
   glViewport(0, 0, screenWidth, screenHeight);
 
-  shaderSDF = std::make_unique<Shader>("./shaders/sdf_taipei101_vert.glsl", "./shaders/sdf_taipei101_frag.glsl");
+  // hg_sdf 很大，compile 交給 driver 背景做，OnRender 先畫 loading frame
+  shaderSDF = std::make_unique<Shader>(Shader::async, "./shaders/sdf_taipei101_vert.glsl",
+                                       "./shaders/sdf_taipei101_frag.glsl");
 
   sdfMesh = createPlaneMesh();
 
   // texture
-  texture = std::make_unique<gfx::resource::Texture>("./assets/textures/windows2.png", "normal", 0);
-  texture_bump = std::make_unique<gfx::resource::Texture>("./assets/textures/windows_bump.png", "normal", 1);
+  auto &textureCache = gfx::resource::TextureCache::instance();
+  texture = textureCache.load("./assets/textures/windows2.png", "normal", 0);
+  texture_bump = textureCache.load("./assets/textures/windows_bump.png", "normal", 1);
 
   // camera
   glm::vec3 position = glm::vec3(1.0f, 6.0f, 6.0f);
@@ -27,7 +32,13 @@ TestSdfTaipei101::TestSdfTaipei101(const float screenWidth, const float screenHe
   glDepthFunc(GL_LESS);
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+TestSdfTaipei101::~TestSdfTaipei101() {}
 
+void TestSdfTaipei101::OnEvent(SDL_Event &event) { camera->handle(event); }
+
+void TestSdfTaipei101::setupShaders() {
   // sdf shader
   shaderSDF->use();
   glUniform2f(glGetUniformLocation(shaderSDF->PROGRAM_ID, "resolution"), screenWidth, screenHeight);
@@ -36,11 +47,13 @@ TestSdfTaipei101::TestSdfTaipei101(const float screenWidth, const float screenHe
   glUniform3fv(glGetUniformLocation(shaderSDF->PROGRAM_ID, "lightColor"), 1, glm::value_ptr(glm::vec3(1.0f)));
 }
 
-TestSdfTaipei101::~TestSdfTaipei101() {}
-
-void TestSdfTaipei101::OnEvent(SDL_Event &event) { camera->handle(event); }
-
 void TestSdfTaipei101::OnRender() {
+  if (!shadersReady) {
+    if (!waitForShaders({shaderSDF.get()})) return;
+    setupShaders();
+    shadersReady = true;
+  }
+
   glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -61,13 +74,27 @@ void TestSdfTaipei101::OnRender() {
   texture->bind();
   glUniform1i(glGetUniformLocation(shaderSDF->PROGRAM_ID, "taipei101_bump"), 1);
   texture_bump->bind();
-  renderer.draw(*sdfMesh, *shaderSDF);
+  if (useVariableRate) {
+    // unit 0 / 1 是大樓的貼圖
+    glUniform1f(glGetUniformLocation(shaderSDF->PROGRAM_ID, "colorEdgeThreshold"), colorEdge);
+    variableRate.render(*shaderSDF, static_cast<int>(screenWidth), static_cast<int>(screenHeight), rateScale, 2,
+                        [this] { renderer.draw(*sdfMesh, *shaderSDF); });
+  } else {
+    gfx::render::VariableRateRenderer::disable(*shaderSDF);
+    renderer.draw(*sdfMesh, *shaderSDF);
+  }
 }
 
 void TestSdfTaipei101::OnImGuiRender() {
+  if (!shadersReady) ImGui::Text("Compiling shaders...");
   ImGui::Checkbox("Move Light", &isLightMove);
   ImGui::SliderFloat("Size", &size, 0.01f, 3.0f);
   ImGui::ColorEdit3("SDF", sdfColor);
+  ImGui::Checkbox("Variable Rate", &useVariableRate);
+  if (useVariableRate) {
+    ImGui::SliderInt("Rate", &rateScale, 2, 4);
+    ImGui::SliderFloat("Color Edge", &colorEdge, 0.0f, 0.5f);
+  }
 }
 
 void TestSdfTaipei101::OnExit() {}
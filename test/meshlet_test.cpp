@@ -0,0 +1,93 @@
+// buildMeshlets 的 normal cone 檢查（不需要 GL context）
+// build: cmake -DBUILD_TESTS=ON .. && make meshlet_test && ctest
+#include <cstdio>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "geom/meshlet.hpp"
+
+using gfx::geom::Meshlet;
+using gfx::geom::MeshletData;
+using gfx::geom::Vertex;
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char *patch, const char *what, size_t meshlet, size_t triangle) {
+  if (ok) return;
+  std::printf("FAIL %s: meshlet %zu triangle %zu: %s\n", patch, meshlet, triangle, what);
+  failures++;
+}
+
+// z = curvature * (x^2 + y^2) 的格狀 patch，正面朝 +z
+// curvature < 0 是凸面（圓頂），> 0 是凹面（碗）
+void buildPatch(float curvature, std::vector<Vertex> &vertices, std::vector<GLuint> &indices) {
+  const int n = 8;
+  for (int j = 0; j <= n; j++) {
+    for (int i = 0; i <= n; i++) {
+      float x = -1.0f + 2.0f * i / n;
+      float y = -1.0f + 2.0f * j / n;
+      Vertex v{};
+      v.position = glm::vec3(x, y, curvature * (x * x + y * y));
+      vertices.push_back(v);
+    }
+  }
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < n; i++) {
+      GLuint a = j * (n + 1) + i, b = a + 1, c = a + n + 1, d = c + 1;
+      indices.insert(indices.end(), {a, b, d, a, d, c});
+    }
+  }
+}
+
+// 和 ClusterCuller 相同的判斷
+bool backfaceCulled(const Meshlet &m, const glm::vec3 &eye) {
+  if (m.coneCutoff >= 1.0f) return false;
+  glm::vec3 dir = m.coneApex - eye;
+  float len = glm::length(dir);
+  return len > 0.0f && glm::dot(dir / len, m.coneAxis) >= m.coneCutoff;
+}
+
+void testPatch(const char *name, float curvature) {
+  std::vector<Vertex> vertices;
+  std::vector<GLuint> indices;
+  buildPatch(curvature, vertices, indices);
+  const MeshletData data = gfx::geom::buildMeshlets(vertices, indices);
+
+  for (size_t mi = 0; mi < data.meshlets.size(); mi++) {
+    const Meshlet &m = data.meshlets[mi];
+    check(m.coneCutoff < 1.0f, name, "normal cone should be usable", mi, 0);
+    for (uint32_t t = 0; t < m.triangleCount; t++) {
+      const GLuint *tri = &data.indices[m.indexOffset + t * 3];
+      const glm::vec3 &p0 = vertices[tri[0]].position;
+      const glm::vec3 &p1 = vertices[tri[1]].position;
+      const glm::vec3 &p2 = vertices[tri[2]].position;
+      const glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+      const glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+
+      // apex 必須在每個三角形平面的後方
+      check(glm::dot(centroid - m.coneApex, normal) >= -1e-5f, name, "apex in front of triangle plane", mi, t);
+
+      // 看得到這個三角形正面的相機不能把整個 cluster 剔掉
+      for (float dist : {0.05f, 1.0f, 10.0f, 100.0f}) {
+        check(!backfaceCulled(m, centroid + normal * dist), name, "front-facing camera culled", mi, t);
+      }
+    }
+    // 從 patch 正上方看
+    check(!backfaceCulled(m, glm::vec3(0.0f, 0.0f, 5.0f)), name, "camera above patch culled", mi, 0);
+  }
+}
+
+}  // namespace
+
+int main() {
+  testPatch("convex", -0.3f);
+  testPatch("concave", 0.3f);
+  if (failures > 0) {
+    std::printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("meshlet_test passed\n");
+  return 0;
+}
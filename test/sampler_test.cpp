@@ -0,0 +1,128 @@
+// gfx::geom::Sampler 與 shaders/rt_sampler.glsl 的比對（不需要 GL context）
+// build: cmake -DBUILD_TESTS=ON .. && make sampler_test && ctest
+// 參考值是把 rt_sampler.glsl 逐行搬到 32-bit 無號整數運算算出來的，以 24-bit 整數比較（toUnitFloat 的分子）
+#include <cstdint>
+#include <cstdio>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "geom/sampler.hpp"
+
+using gfx::geom::Sampler;
+using gfx::geom::SamplerType;
+
+namespace {
+
+int failures = 0;
+
+void expectBits(float u, uint32_t expected, const char *what) {
+  const auto bits = static_cast<uint32_t>(u * 16777216.0f);
+  if (bits == expected) return;
+  std::printf("FAIL %s: got %u, shader gives %u\n", what, bits, expected);
+  failures++;
+}
+
+void expectU32(uint32_t got, uint32_t expected, const char *what) {
+  if (got == expected) return;
+  std::printf("FAIL %s: got 0x%08x, shader gives 0x%08x\n", what, got, expected);
+  failures++;
+}
+
+void testHelpers() {
+  expectU32(gfx::geom::hashU32(0u), 0x00000000u, "hashU32(0)");
+  expectU32(gfx::geom::hashU32(1u), 0x688990c0u, "hashU32(1)");
+  expectU32(gfx::geom::hashU32(0xdeadbeefu), 0xe628c683u, "hashU32(0xdeadbeef)");
+  expectU32(gfx::geom::sobol2(1u), 0x80000000u, "sobol2(1)");
+  expectU32(gfx::geom::sobol2(2u), 0xc0000000u, "sobol2(2)");
+  expectU32(gfx::geom::sobol2(3u), 0x40000000u, "sobol2(3)");
+  expectU32(gfx::geom::sobol2(12345u), 0x70440000u, "sobol2(12345)");
+}
+
+// 每個 bounce 取三次 next2D（dimension 0、1、2）
+void testSobol() {
+  struct Case {
+    glm::uvec2 pixel;
+    uint32_t index;
+    uint32_t expected[3][2];
+  };
+  const Case cases[] = {
+      {{3, 5}, 0, {{8573498, 14384572}, {6652835, 7702154}, {923984, 9488437}}},
+      {{3, 5}, 1, {{8364010, 6861187}, {10172959, 13022737}, {14055720, 3417893}}},
+      {{17, 2}, 6, {{2471868, 7452880}, {1852985, 13015500}, {14787348, 4238058}}},
+  };
+  Sampler sampler(SamplerType::Sobol);
+  for (const Case &c : cases) {
+    sampler.begin(c.pixel, c.index);
+    for (const auto &expected : c.expected) {
+      const glm::vec2 u = sampler.next2D();
+      expectBits(u.x, expected[0], "sobol next2D.x");
+      expectBits(u.y, expected[1], "sobol next2D.y");
+    }
+  }
+
+  // (0,2)-sequence：前 16 個 sample 在每一種 16 格的基本區間（1x16、2x8、4x4、8x2、16x1）都各佔一格
+  for (int log2x = 0; log2x <= 4; log2x++) {
+    const int nx = 1 << log2x, ny = 16 / nx;
+    std::vector<int> hits(16, 0);
+    for (uint32_t i = 0; i < 16; i++) {
+      sampler.begin({7, 9}, i);
+      const glm::vec2 u = sampler.next2D();
+      hits[static_cast<int>(u.y * ny) * nx + static_cast<int>(u.x * nx)]++;
+    }
+    for (int h : hits) {
+      if (h == 1) continue;
+      std::printf("FAIL sobol: 16 samples are not stratified in %dx%d cells\n", nx, ny);
+      failures++;
+      break;
+    }
+  }
+}
+
+// 4x4 的假 blue noise：texel (x, y) = ((37x + 11y), (5x + 91y), (13x + 7y), (29x + 3y)) & 255
+void testBlueNoise() {
+  const int size = 4;
+  std::vector<uint8_t> texels(size * size * 4);
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      uint8_t *t = &texels[(y * size + x) * 4];
+      t[0] = static_cast<uint8_t>(x * 37 + y * 11);
+      t[1] = static_cast<uint8_t>(x * 5 + y * 91);
+      t[2] = static_cast<uint8_t>(x * 13 + y * 7);
+      t[3] = static_cast<uint8_t>(x * 29 + y * 3);
+    }
+  }
+
+  // next2D、next1D、next1D（dimension 0、1、2）
+  struct Case {
+    uint32_t index;
+    uint32_t expected[4];
+  };
+  const Case cases[] = {
+      {0, {2457600, 360448, 2326528, 1736704}},
+      {5, {15449680, 14607684, 3839328, 3249504}},
+  };
+  Sampler sampler(SamplerType::BlueNoise);
+  sampler.setBlueNoise(texels.data(), size);
+  for (const Case &c : cases) {
+    sampler.begin({1, 2}, c.index);
+    const glm::vec2 u = sampler.next2D();
+    expectBits(u.x, c.expected[0], "blue noise next2D.x");
+    expectBits(u.y, c.expected[1], "blue noise next2D.y");
+    expectBits(sampler.next1D(), c.expected[2], "blue noise next1D (A, odd dimension)");
+    expectBits(sampler.next1D(), c.expected[3], "blue noise next1D (B, even dimension)");
+  }
+}
+
+}  // namespace
+
+int main() {
+  testHelpers();
+  testSobol();
+  testBlueNoise();
+  if (failures > 0) {
+    std::printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("sampler_test passed\n");
+  return 0;
+}
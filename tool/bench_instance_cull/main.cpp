@@ -0,0 +1,62 @@
+// 單獨 benchmark InstanceCuller（不需要 GL context）
+// build: cmake -DBUILD_BENCHMARKS=ON .. && make bench_instance_cull
+// usage: ./bench_instance_cull [instanceCount] [iterations]
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+#include "render/instance_culler.hpp"
+
+int main(int argc, char **argv) {
+  const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+  const int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+  // 和 TestMultipleObj 一樣的方陣排列，隨機旋轉
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> rotDis(0.0f, 360.0f);
+  const size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+  std::vector<glm::mat4> instances(count);
+  for (size_t i = 0; i < count; i++) {
+    glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3((i / side) * 3.0f, 0.0f, (i % side) * 3.0f));
+    instances[i] = glm::rotate(m, glm::radians(rotDis(gen)), glm::vec3(0.0f, 1.0f, 0.0f));
+  }
+
+  const glm::vec3 eye(-2.0f, 7.0f, -4.0f);
+  const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.66f, -0.15f, 0.73f), glm::vec3(0.0f, 1.0f, 0.0f));
+  const glm::mat4 proj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+  const glm::mat4 viewProj = proj * view;
+  const glm::vec3 center(0.0f, 0.8f, 0.0f);
+  const float radius = 1.2f;
+
+  gfx::render::InstanceCuller culler;
+  std::vector<uint32_t> visible, reference;
+
+  auto run = [&](bool simd, std::vector<uint32_t> &out) {
+    culler.useSimd = simd;
+    culler.cull(instances, center, radius, viewProj, out);  // warm up
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; it++) culler.cull(instances, center, radius, viewProj, out);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+    std::printf("%-7s %8.3f ms/frame  %6.2f ns/instance  visible %zu / %zu\n", simd ? "simd" : "scalar", ms,
+                ms * 1e6 / count, out.size(), count);
+  };
+
+  run(false, reference);
+  if (!gfx::render::InstanceCuller::simdAvailable()) {
+    std::printf("simd    not available in this build\n");
+    return 0;
+  }
+  run(true, visible);
+
+  if (visible != reference) {
+    std::printf("MISMATCH between scalar and simd results\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+// 產生 path tracer 用的 blue noise 貼圖（rt_sampler.glsl 的 SAMPLER_BLUE_NOISE）：RGBA 四個 channel 各自是一張
+// 獨立 seed 的 void-and-cluster blue noise，rank 均勻量化成 8-bit，可上下左右無縫平鋪
+// build: cmake -DBUILD_TOOLS=ON .. && make blue_noise
+// usage:
+//   ./blue_noise [-n size] [-s seed] [-g sigma] [-o output.png]
+//       size 預設 64（建議 2 的冪次），sigma 為 void-and-cluster 的 Gaussian 寬度（預設 1.9）
+//       輸出預設 blue_noise_<size>.png；TestRtSphere 讀的是 assets/textures/blue_noise_64.png
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "geom/sampler.hpp"
+#include "resource/png_writer.hpp"
+
+namespace {
+
+void printUsage(const char *program) {
+  std::fprintf(stderr, "usage: %s [-n size] [-s seed] [-g sigma] [-o output.png]\n", program);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int size = 64;
+  uint32_t seed = 1;
+  float sigma = 1.9f;
+  std::string output;
+  for (int i = 1; i < argc; i++) {
+    const bool hasValue = i + 1 < argc;
+    if (!std::strcmp(argv[i], "-n") && hasValue) {
+      size = std::atoi(argv[++i]);
+    } else if (!std::strcmp(argv[i], "-s") && hasValue) {
+      seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (!std::strcmp(argv[i], "-g") && hasValue) {
+      sigma = static_cast<float>(std::atof(argv[++i]));
+    } else if (!std::strcmp(argv[i], "-o") && hasValue) {
+      output = argv[++i];
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (size < 2 || size > 256 || sigma <= 0.0f) {
+    std::fprintf(stderr, "size must be in [2, 256] and sigma > 0\n");
+    return 1;
+  }
+  if (output.empty()) output = "blue_noise_" + std::to_string(size) + ".png";
+
+  const auto start = std::chrono::steady_clock::now();
+  const size_t n = static_cast<size_t>(size) * size;
+  std::vector<uint8_t> pixels(n * 4);
+  for (uint32_t channel = 0; channel < 4; channel++) {
+    // 每個 channel 用不同 seed，四張互不相關，shader 端分給 2D（RG）與 1D（B / A）
+    const std::vector<uint32_t> rank = gfx::geom::generateBlueNoise(size, gfx::geom::hashU32(seed + channel), sigma);
+    for (size_t i = 0; i < n; i++) pixels[i * 4 + channel] = static_cast<uint8_t>(rank[i] * 256 / n);
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (!gfx::resource::writePng(output, pixels.data(), size, size, 4)) {
+    std::fprintf(stderr, "failed to write %s\n", output.c_str());
+    return 1;
+  }
+  std::printf("%s: %dx%d RGBA, seed %u, sigma %.2f (%.2fs)\n", output.c_str(), size, size, seed, sigma, seconds);
+  return 0;
+}
@@ -0,0 +1,235 @@
+// 把貼圖轉成可無縫平鋪（原本的 convert.py）：四象限對調讓原本的邊界移到中央十字，
+// 十字帶狀區域做 Gaussian blur 後再對調回去
+// build: cmake -DBUILD_TOOLS=ON .. && make convert_seamless_texture
+// usage:
+//   ./convert_seamless_texture [-w band] [-s sigma] [-j threads] [-o dir] input...
+//       input 可以是圖檔或目錄（目錄下的 png/jpg/jpeg/tga/bmp，不遞迴，略過已經是 *_seamless 的檔案）
+//       輸出 <name>_seamless.png；band 為十字半寬（預設 10，kernel 大小 2 * band + 1），sigma <= 0 時同 OpenCV
+//   ./convert_seamless_texture -f bc1|bc3|bc5|bc7 [-e ktx2|dds] [--no-mips] [--srgb] ... input...
+//       改輸出壓縮貼圖 <name>_seamless.ktx2 / .dds（同 texture_compress），可直接給 Texture 載入
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "resource/bc_encoder.hpp"
+#include "resource/image_ops.hpp"
+#include "resource/png_writer.hpp"
+#include "resource/texture_container.hpp"
+#include "stb_image.h"
+
+namespace fs = std::filesystem;
+using gfx::resource::BcFormat;
+
+namespace {
+
+struct Options {
+  int band = 10;
+  float sigma = 0.0f;
+  unsigned threads = 0;
+  std::string outputDir;
+  bool compress = false;
+  BcFormat format = BcFormat::BC7;
+  std::string extension = "ktx2";
+  bool mips = true;
+  bool srgb = false;
+};
+
+struct Image {
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  std::vector<uint8_t> pixels;
+};
+
+bool loadImage(const std::string &path, int desiredChannels, Image &img) {
+  unsigned char *data = stbi_load(path.c_str(), &img.width, &img.height, &img.channels, desiredChannels);
+  if (!data) return false;
+  if (desiredChannels) img.channels = desiredChannels;
+  img.pixels.assign(data, data + static_cast<size_t>(img.width) * img.height * img.channels);
+  stbi_image_free(data);
+  return true;
+}
+
+// ---- seamless ----
+// 對調後原本的左右 / 上下邊界落在 (seamX, seamY)，只 blur 寬 2 * band + 1 的十字帶，其餘 pixel 原封不動
+void makeSeamless(Image &img, int band, float sigma) {
+  const int w = img.width, h = img.height, ch = img.channels;
+  const int seamX = w - w / 2, seamY = h - h / 2;
+  std::vector<uint8_t> swapped(img.pixels.size());
+  gfx::resource::rollImage(img.pixels.data(), swapped.data(), w, h, ch, seamX, seamY);
+
+  std::vector<uint8_t> blurred = swapped;
+  gfx::resource::gaussianBlurRegion(swapped.data(), w, h, ch, blurred.data(), band, sigma, seamX - band, 0,
+                                    2 * band + 1, h);
+  gfx::resource::gaussianBlurRegion(swapped.data(), w, h, ch, blurred.data(), band, sigma, 0, seamY - band, w,
+                                    2 * band + 1);
+
+  gfx::resource::rollImage(blurred.data(), img.pixels.data(), w, h, ch, w / 2, h / 2);
+}
+
+bool isImagePath(const fs::path &path) {
+  std::string ext = path.extension().string();
+  for (char &c : ext) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+}
+
+bool isSeamlessOutput(const fs::path &path) {
+  const std::string stem = path.stem().string();
+  const std::string suffix = "_seamless";
+  return stem.size() >= suffix.size() && stem.compare(stem.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// 目錄展開成底下的圖檔（排序，輸出順序固定）
+std::vector<std::string> collectInputs(const std::vector<std::string> &args) {
+  std::vector<std::string> files;
+  for (const auto &arg : args) {
+    std::error_code ec;
+    if (!fs::is_directory(arg, ec)) {
+      files.push_back(arg);
+      continue;
+    }
+    std::vector<std::string> entries;
+    for (const auto &entry : fs::directory_iterator(arg, ec)) {
+      if (entry.is_regular_file() && isImagePath(entry.path()) && !isSeamlessOutput(entry.path())) {
+        entries.push_back(entry.path().string());
+      }
+    }
+    std::sort(entries.begin(), entries.end());
+    files.insert(files.end(), entries.begin(), entries.end());
+  }
+  return files;
+}
+
+std::string outputPath(const std::string &input, const Options &opt) {
+  const fs::path in(input);
+  const fs::path dir = opt.outputDir.empty() ? in.parent_path() : fs::path(opt.outputDir);
+  return (dir / (in.stem().string() + "_seamless." + (opt.compress ? opt.extension : "png"))).string();
+}
+
+// compressThreads 為 BC 壓縮用的 thread 數；batch 已經每個檔案一個 thread 時給 1
+bool processFile(const std::string &input, const Options &opt, unsigned compressThreads) {
+  const auto t0 = std::chrono::steady_clock::now();
+  Image img;
+  if (!loadImage(input, opt.compress ? 4 : 0, img)) {
+    std::fprintf(stderr, "failed to load %s\n", input.c_str());
+    return false;
+  }
+  if (img.width <= 2 * opt.band + 1 || img.height <= 2 * opt.band + 1) {
+    std::fprintf(stderr, "%s: %dx%d is too small for band %d\n", input.c_str(), img.width, img.height, opt.band);
+    return false;
+  }
+  makeSeamless(img, opt.band, opt.sigma);
+
+  const std::string out = outputPath(input, opt);
+  bool ok;
+  if (opt.compress) {
+    const auto tex = gfx::resource::compressTexture({img.pixels.data()}, img.width, img.height, opt.format, opt.mips,
+                                                    opt.srgb, compressThreads);
+    ok = gfx::resource::writeCompressedTexture(out, tex);
+  } else {
+    ok = gfx::resource::writePng(out, img.pixels.data(), img.width, img.height, img.channels);
+  }
+  if (!ok) {
+    std::fprintf(stderr, "failed to write %s\n", out.c_str());
+    return false;
+  }
+
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  std::printf("%s: %dx%d x%d, %.1f ms\n", out.c_str(), img.width, img.height, img.channels, ms);
+  return true;
+}
+
+bool parseFormat(const char *name, BcFormat &format) {
+  const std::pair<const char *, BcFormat> table[] = {
+      {"bc1", BcFormat::BC1}, {"bc3", BcFormat::BC3}, {"bc5", BcFormat::BC5}, {"bc7", BcFormat::BC7}};
+  for (const auto &[n, f] : table) {
+    if (std::strcmp(name, n) == 0) {
+      format = f;
+      return true;
+    }
+  }
+  return false;
+}
+
+void usage() {
+  std::fprintf(stderr,
+               "usage: convert_seamless_texture [-w band] [-s sigma] [-j threads] [-o dir]\n"
+               "                                [-f bc1|bc3|bc5|bc7 [-e ktx2|dds] [--no-mips] [--srgb]]\n"
+               "                                input|dir...\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  std::vector<std::string> args;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "-w" && i + 1 < argc) {
+      opt.band = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-s" && i + 1 < argc) {
+      opt.sigma = static_cast<float>(std::atof(argv[++i]));
+    } else if (arg == "-j" && i + 1 < argc) {
+      opt.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else if (arg == "-o" && i + 1 < argc) {
+      opt.outputDir = argv[++i];
+    } else if (arg == "-f" && i + 1 < argc) {
+      opt.compress = true;
+      if (!parseFormat(argv[++i], opt.format)) {
+        usage();
+        return 1;
+      }
+    } else if (arg == "-e" && i + 1 < argc) {
+      opt.extension = argv[++i];
+      // writeCompressedTexture 只認 .ktx2，其他一律寫 DDS
+      if (opt.extension != "ktx2" && opt.extension != "dds") {
+        usage();
+        return 1;
+      }
+    } else if (arg == "--no-mips") {
+      opt.mips = false;
+    } else if (arg == "--srgb") {
+      opt.srgb = true;
+    } else {
+      args.push_back(arg);
+    }
+  }
+
+  const std::vector<std::string> files = collectInputs(args);
+  if (files.empty()) {
+    usage();
+    return 1;
+  }
+  if (!opt.outputDir.empty()) fs::create_directories(opt.outputDir);
+
+  // 每個 thread 輪流取下一個檔案；只有一個檔案時 thread 留給 BC 壓縮
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  const unsigned numThreads = std::min<unsigned>(opt.threads ? opt.threads : hw, static_cast<unsigned>(files.size()));
+  const unsigned compressThreads = numThreads > 1 ? 1 : opt.threads;
+  std::atomic<size_t> next{0};
+  std::atomic<int> failures{0};
+  auto worker = [&] {
+    for (size_t i = next++; i < files.size(); i = next++) {
+      if (!processFile(files[i], opt, compressThreads)) failures++;
+    }
+  };
+
+  const auto t0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < numThreads; t++) threads.emplace_back(worker);
+  worker();
+  for (auto &t : threads) t.join();
+
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  std::printf("%zu file(s), %u thread(s), %.1f ms\n", files.size(), numThreads, ms);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,157 @@
+// 離線把 PNG/JPEG 轉成 BC 壓縮的 KTX2 / DDS（含完整 mip chain），執行期直接 glCompressedTexImage2D
+// build: cmake -DBUILD_TOOLS=ON .. && make texture_compress
+// usage:
+//   ./texture_compress [-f bc1|bc3|bc5|bc7] [-e ktx2|dds] [-j threads] [--no-mips] [--srgb] input...
+//       每個 input 輸出到同目錄、同檔名換副檔名；--srgb 表示顏色貼圖，mip 在 linear space 縮小，
+//       並輸出 *_SRGB 格式（BC5 除外）
+//   ./texture_compress --cube -o sky.ktx2 [-f ...] px.jpg nx.jpg py.jpg ny.jpg pz.jpg nz.jpg
+//       六個 face 依 GL 順序 +X, -X, +Y, -Y, +Z, -Z 給，翻轉請先在原圖處理好
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "resource/bc_encoder.hpp"
+#include "resource/texture_container.hpp"
+#include "stb_image.h"
+
+using gfx::resource::BcFormat;
+using gfx::resource::CompressedTexture;
+
+namespace {
+
+struct Image {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> rgba;
+};
+
+bool loadImage(const std::string &path, Image &img) {
+  int channels;
+  unsigned char *data = stbi_load(path.c_str(), &img.width, &img.height, &channels, 4);
+  if (!data) return false;
+  img.rgba.assign(data, data + static_cast<size_t>(img.width) * img.height * 4);
+  stbi_image_free(data);
+  return true;
+}
+
+bool parseFormat(const char *name, BcFormat &format) {
+  const std::pair<const char *, BcFormat> table[] = {
+      {"bc1", BcFormat::BC1}, {"bc3", BcFormat::BC3}, {"bc5", BcFormat::BC5}, {"bc7", BcFormat::BC7}};
+  for (const auto &[n, f] : table) {
+    if (std::strcmp(name, n) == 0) {
+      format = f;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string replaceExtension(const std::string &path, const std::string &ext) {
+  const size_t dot = path.find_last_of('.');
+  const size_t slash = path.find_last_of("/\\");
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + "." + ext;
+  return path.substr(0, dot + 1) + ext;
+}
+
+void usage() {
+  std::fprintf(stderr,
+               "usage: texture_compress [-f bc1|bc3|bc5|bc7] [-e ktx2|dds] [-j threads] [--no-mips] [--srgb]\n"
+               "                        input...\n"
+               "       texture_compress --cube -o out.ktx2 [-f ...] px nx py ny pz nz\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  BcFormat format = BcFormat::BC7;
+  std::string extension = "ktx2";
+  std::string output;
+  unsigned threads = 0;
+  bool mips = true;
+  bool cube = false;
+  bool srgb = false;
+  std::vector<std::string> inputs;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "-f" && i + 1 < argc) {
+      if (!parseFormat(argv[++i], format)) {
+        usage();
+        return 1;
+      }
+    } else if (arg == "-e" && i + 1 < argc) {
+      extension = argv[++i];
+      // writeCompressedTexture 只認 .ktx2，其他一律寫 DDS，副檔名不對會產生內容與副檔名不符的檔案
+      if (extension != "ktx2" && extension != "dds") {
+        usage();
+        return 1;
+      }
+    } else if (arg == "-o" && i + 1 < argc) {
+      output = argv[++i];
+    } else if (arg == "-j" && i + 1 < argc) {
+      threads = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else if (arg == "--no-mips") {
+      mips = false;
+    } else if (arg == "--srgb") {
+      srgb = true;
+    } else if (arg == "--cube") {
+      cube = true;
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+  if (inputs.empty() || (cube && (inputs.size() != 6 || !gfx::resource::isCompressedTexturePath(output)))) {
+    usage();
+    return 1;
+  }
+
+  // cube map 視為一個 job，否則每個 input 一個 job
+  std::vector<std::vector<std::string>> jobs;
+  if (cube) {
+    jobs.push_back(inputs);
+  } else {
+    for (const auto &in : inputs) jobs.push_back({in});
+  }
+
+  int failures = 0;
+  for (const auto &job : jobs) {
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<Image> faces(job.size());
+    bool ok = true;
+    for (size_t i = 0; i < job.size() && ok; i++) {
+      ok = loadImage(job[i], faces[i]);
+      if (!ok) std::fprintf(stderr, "failed to load %s\n", job[i].c_str());
+    }
+
+    CompressedTexture tex;
+    const std::string outPath = cube ? output : replaceExtension(job[0], extension);
+    std::vector<const uint8_t *> pixels;
+    for (const Image &face : faces) {
+      if (ok && (face.width != faces[0].width || face.height != faces[0].height)) {
+        std::fprintf(stderr, "cube faces must share the same size\n");
+        ok = false;
+      }
+      pixels.push_back(face.rgba.data());
+    }
+    if (ok) {
+      tex = gfx::resource::compressTexture(pixels, faces[0].width, faces[0].height, format, mips, srgb, threads);
+    }
+    if (ok && !gfx::resource::writeCompressedTexture(outPath, tex)) {
+      std::fprintf(stderr, "failed to write %s\n", outPath.c_str());
+      ok = false;
+    }
+    if (!ok) {
+      failures++;
+      continue;
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    const size_t rawBytes = faces.size() * faces[0].rgba.size();
+    std::printf("%s: %dx%d x%d face(s), %d mips, %s, %.1f KB (RGBA8 base %.1f KB), %.1f ms\n", outPath.c_str(),
+                tex.width, tex.height, tex.faceCount, tex.levelCount, gfx::resource::bcFormatName(format),
+                tex.data.size() / 1024.0, rawBytes / 1024.0, ms);
+  }
+  return failures ? 1 : 0;
+}